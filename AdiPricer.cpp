@@ -0,0 +1,560 @@
+/**
+ * @file AdiPricer.cpp
+ * @brief Implementation of the AdiPricer class using the Hundsdorfer-Verwer ADI scheme.
+ *
+ * The two-factor PDE (time to maturity tau, spot s, second factor y)
+ *
+ *    u_tau = F0 u + F1 u + F2 u
+ *
+ * is split into the mixed-derivative term F0, the terms acting along the spot axis F1 and the
+ * terms acting along the second axis F2 (the discounting term -r u is shared equally by F1 and F2).
+ * For the Heston model y is the variance v:
+ *
+ *    F0 = rho xi s v d2/dsdv,
+ *    F1 = 1/2 v s^2 d2/ds2 + (r - q) s d/ds - r/2,
+ *    F2 = 1/2 xi^2 v d2/dv2 + kappa (theta - v) d/dv - r/2,
+ *
+ * and for the stochastic rate model y is the short rate r with
+ *
+ *    F0 = rho sigma sigma_r s d2/dsdr,
+ *    F1 = 1/2 sigma^2 s^2 d2/ds2 + (r - q) s d/ds - r/2,
+ *    F2 = 1/2 sigma_r^2 d2/dr2 + kappa_r (rbar - r) d/dr - r/2.
+ *
+ * Each Hundsdorfer-Verwer step consists of an explicit predictor followed by two implicit
+ * corrections per direction. Every implicit correction is a set of independent tridiagonal
+ * systems (one per grid line), solved with the same Thomas routine as the Crank-Nicolson pricer
+ * and distributed across worker threads. The threads share the grid and synchronize with a
+ * barrier between the phases of a time step.
+ *
+ * The spot grid is clustered around the strike and, for the Heston model, the variance grid around
+ * v = 0, where the payoff kink and the degenerate diffusion concentrate the error. The points follow a
+ * sinh map of a uniform grid (In 't Hout and Foulon) and the derivatives use the second-order three-point
+ * formulas of non-uniform grids; config.adiUniformGrid selects uniform grids instead, on which these
+ * formulas are the usual central differences. The short-rate grid is always uniform.
+ *
+ * Spot boundaries are Dirichlet (asymptotic option values). On the edges of the second axis the
+ * diffusion term is dropped and the drift is discretized one-sided towards the interior.
+ */
+
+#include "pch.h"
+#include "AdiPricer.hpp"
+#include "Option.hpp"
+#include "DateConverter.hpp"
+#include "TridiagonalSolver.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace {
+
+    /**
+     * @brief Reusable barrier synchronizing the worker threads of one pricing.
+     */
+    class StepBarrier {
+    public:
+        explicit StepBarrier(int count) : count_(count), waiting_(0), generation_(0) {}
+
+        /**
+         * @brief Blocks until all the threads of the pricing have reached the barrier.
+         */
+        void wait() {
+            if (count_ == 1) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            int generation = generation_;
+            if (++waiting_ == count_) {
+                waiting_ = 0;
+                ++generation_;
+                cv_.notify_all();
+            }
+            else {
+                cv_.wait(lock, [&] { return generation != generation_; });
+            }
+        }
+
+    private:
+        int count_;
+        int waiting_;
+        int generation_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+    /**
+     * @brief Per-thread storage for the tridiagonal line solves of one direction.
+     */
+    struct LineWorkspace {
+        std::vector<double> a, b, c, d, x, c_prime, d_prime;
+
+        explicit LineWorkspace(int n)
+            : a(n, 0.0), b(n, 0.0), c(n, 0.0), d(n, 0.0), x(n, 0.0), c_prime(n, 0.0), d_prime(n, 0.0) {}
+    };
+
+    /**
+     * @brief Weights of a three-point finite difference: f'(x_i) or f''(x_i) is approximated by
+     *        lower f(x_{i-1}) + centre f(x_i) + upper f(x_{i+1}).
+     */
+    struct Stencil {
+        double lower, centre, upper;
+    };
+
+    /// Second-order first derivative on the interior node i of a grid (central differences if uniform).
+    Stencil firstDerivative(const std::vector<double>& x, int i) {
+        double hl = x[i] - x[i - 1];
+        double hu = x[i + 1] - x[i];
+        return Stencil{ -hu / (hl * (hl + hu)), (hu - hl) / (hl * hu), hl / (hu * (hl + hu)) };
+    }
+
+    /// Second derivative on the interior node i of a grid (second order if the spacing varies smoothly).
+    Stencil secondDerivative(const std::vector<double>& x, int i) {
+        double hl = x[i] - x[i - 1];
+        double hu = x[i + 1] - x[i];
+        return Stencil{ 2.0 / (hl * (hl + hu)), -2.0 / (hl * hu), 2.0 / (hu * (hl + hu)) };
+    }
+
+    /// Uniform grid of n steps on [lower, upper].
+    std::vector<double> uniformGrid(double lower, double upper, int n) {
+        double h = (upper - lower) / n;
+        std::vector<double> x(n + 1);
+        for (int i = 0; i <= n; ++i) {
+            x[i] = lower + i * h;
+        }
+        return x;
+    }
+
+    /**
+     * @brief Grid of n steps on [lower, upper] clustered around centre: x = centre + width sinh(xi), xi uniform.
+     *
+     * The spacing is about width times the step in xi near centre and grows exponentially away from it;
+     * a smaller width clusters the points more tightly.
+     */
+    std::vector<double> sinhGrid(double lower, double upper, double centre, double width, int n) {
+        double xiLower = std::asinh((lower - centre) / width);
+        double xiUpper = std::asinh((upper - centre) / width);
+        std::vector<double> x(n + 1);
+        for (int i = 0; i <= n; ++i) {
+            x[i] = centre + width * std::sinh(xiLower + (xiUpper - xiLower) * i / n);
+        }
+        x[0] = lower;
+        x[n] = upper;
+        return x;
+    }
+
+    /// Index of the grid interval [x[i], x[i + 1]] that contains the point (the nearest one if outside).
+    int intervalOf(const std::vector<double>& x, double point) {
+        int last = static_cast<int>(x.size()) - 2;
+        int i = static_cast<int>(std::upper_bound(x.begin(), x.end(), point) - x.begin()) - 1;
+        return std::min(std::max(i, 0), last);
+    }
+
+} // namespace
+
+/// Default constructor, using default configuration values.
+AdiPricer::AdiPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
+    // No additional initialization required.
+}
+
+/// Constructor with pricing configuration.
+AdiPricer::AdiPricer(const PricingConfiguration& config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
+{
+    // The configuration parameters are now stored in config_.
+}
+
+/// Constructor sharing a configuration, with a bump overlay.
+AdiPricer::AdiPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
+/// Destructor.
+AdiPricer::~AdiPricer() {
+    // No dynamic cleanup is required.
+}
+
+/**
+ * @brief Computes the option price with the Hundsdorfer-Verwer ADI scheme.
+ *
+ * The effective time to maturity is adjusted by the calculation date as in the other pricers.
+ * For the Heston model the initial variance is the square of the option volatility and the
+ * risk-free rate at each step is interpolated from the yield curve (or taken from riskFreeRate
+ * when no curve is loaded). For the stochastic rate model the short rate starts at, and reverts
+ * to, riskFreeRate and the option volatility is used as the (constant) spot volatility.
+ *
+ * @param opt The option to be priced.
+ * @return The computed option price.
+ * @throw std::runtime_error if the grid is too small or the parameters are inconsistent.
+ */
+double AdiPricer::price(const Option& opt) const {
+    if (opt.getBarrierType() != Option::BarrierType::None || opt.getOptionStyle() == Option::OptionStyle::Bermudan) {
+        throw std::runtime_error("AdiPricer supports only vanilla European and American options.");
+    }
+
+    double S0 = opt.getUnderlying();
+    double K = opt.getStrike();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+    bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+    bool isAmerican = (opt.getOptionStyle() == Option::OptionStyle::American);
+    bool isHeston = (config_->adiModel == TwoFactorModel::Heston);
+
+    double T = config_->maturityOf(opt);
+    double r_default = config_->riskFreeRate + bump_.rateShift;
+
+    // Adjust effective time to maturity using calculationDate if provided.
+    double T_effective = T;
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
+        auto today = std::chrono::system_clock::now();
+        double offset = DateConverter::yearsBetween(calcDate, today);
+        T_effective = T - offset;
+    }
+
+    const int Ns = config_->adiSpotSteps;
+    const int Ny = config_->adiFactorSteps;
+    const int N = config_->adiTimeSteps;
+    if (Ns < 3 || Ny < 2 || N < 1) {
+        throw std::runtime_error("The ADI grid requires at least 3 spot steps, 2 factor steps and 1 time step.");
+    }
+    if (isHeston && (config_->hestonKappa <= 0.0 || config_->hestonXi <= 0.0)) {
+        throw std::runtime_error("The Heston model requires positive kappa and xi.");
+    }
+    if (!isHeston && (config_->rateKappa <= 0.0 || config_->rateVolatility <= 0.0)) {
+        throw std::runtime_error("The stochastic rate model requires a positive mean reversion and volatility.");
+    }
+
+    const double dt = T_effective / N;
+    const double theta = 0.5 + std::sqrt(3.0) / 6.0; // Hundsdorfer-Verwer parameter
+
+    // Spot grid, clustered around the strike (width K/5, as In 't Hout and Foulon).
+    double Smax = (config_->S_max > 0.0) ? config_->S_max : std::max(3.0 * K, 3.0 * S0);
+    std::vector<double> S = config_->adiUniformGrid ? uniformGrid(0.0, Smax, Ns)
+        : sinhGrid(0.0, Smax, std::min(K, Smax), K / 5.0, Ns);
+
+    // Second-factor grid and the coefficients that depend on it only.
+    double y0 = 0.0;
+    double yMin = 0.0;
+    double yMax = 0.0;
+    if (isHeston) {
+        y0 = sigma * sigma;
+        double vRef = std::max(config_->hestonTheta, y0);
+        double vStd = config_->hestonXi * std::sqrt(vRef / (2.0 * config_->hestonKappa));
+        yMax = std::max(3.0 * vRef, vRef + 8.0 * vStd);
+    }
+    else {
+        y0 = r_default;
+        double rStd = config_->rateVolatility * std::sqrt((1.0 - std::exp(-2.0 * config_->rateKappa * T_effective))
+            / (2.0 * config_->rateKappa));
+        yMin = y0 - 6.0 * rStd;
+        yMax = y0 + 6.0 * rStd;
+    }
+    // Variance grid clustered around v = 0 (width vMax/500, as In 't Hout and Foulon); short-rate grid uniform.
+    std::vector<double> Y = (isHeston && !config_->adiUniformGrid) ? sinhGrid(0.0, yMax, 0.0, yMax / 500.0, Ny)
+        : uniformGrid(yMin, yMax, Ny);
+    std::vector<double> variance(Ny + 1);  // Spot variance on each row
+    std::vector<double> diffusionY(Ny + 1); // 1/2 (volatility of the factor)^2
+    std::vector<double> driftY(Ny + 1);     // Drift of the factor
+    std::vector<double> crossY(Ny + 1);     // Mixed-derivative coefficient divided by s
+    for (int j = 0; j <= Ny; ++j) {
+        if (isHeston) {
+            variance[j] = Y[j];
+            diffusionY[j] = 0.5 * config_->hestonXi * config_->hestonXi * Y[j];
+            driftY[j] = config_->hestonKappa * (config_->hestonTheta - Y[j]);
+            crossY[j] = config_->hestonRho * config_->hestonXi * Y[j];
+        }
+        else {
+            variance[j] = sigma * sigma;
+            diffusionY[j] = 0.5 * config_->rateVolatility * config_->rateVolatility;
+            driftY[j] = config_->rateKappa * (y0 - Y[j]);
+            crossY[j] = config_->rateCorrelation * sigma * config_->rateVolatility;
+        }
+    }
+
+    // Finite difference weights on the interior nodes. On the edges of the second axis only the one-sided
+    // drift is used: factorFirst[0] and factorFirst[Ny] hold its weights.
+    std::vector<Stencil> spotFirst(Ns + 1), spotSecond(Ns + 1);
+    for (int i = 1; i < Ns; ++i) {
+        spotFirst[i] = firstDerivative(S, i);
+        spotSecond[i] = secondDerivative(S, i);
+    }
+    std::vector<Stencil> factorFirst(Ny + 1), factorSecond(Ny + 1);
+    for (int j = 1; j < Ny; ++j) {
+        factorFirst[j] = firstDerivative(Y, j);
+        factorSecond[j] = secondDerivative(Y, j);
+    }
+    double dyLow = Y[1] - Y[0];
+    double dyHigh = Y[Ny] - Y[Ny - 1];
+    factorFirst[0] = Stencil{ 0.0, -1.0 / dyLow, 1.0 / dyLow };
+    factorFirst[Ny] = Stencil{ -1.0 / dyHigh, 1.0 / dyHigh, 0.0 };
+
+    // Payoff and grid storage (row-major: index = j * (Ns + 1) + i).
+    const int stride = Ns + 1;
+    const size_t size = static_cast<size_t>(stride) * (Ny + 1);
+    std::vector<double> payoff(stride);
+    for (int i = 0; i <= Ns; ++i) {
+        payoff[i] = isCall ? std::max(S[i] - K, 0.0) : std::max(K - S[i], 0.0);
+    }
+    std::vector<double> U(size);
+    for (int j = 0; j <= Ny; ++j) {
+        std::copy(payoff.begin(), payoff.end(), U.begin() + static_cast<size_t>(j) * stride);
+    }
+    std::vector<double> Y0(size, 0.0), Y1(size, 0.0), Y2(size, 0.0);
+    std::vector<double> F0(size, 0.0), F1(size, 0.0), F2(size, 0.0);
+
+    // Short rate on row j at a given local (deterministic) rate.
+    auto rateAt = [&](int j, double r_local) {
+        return isHeston ? r_local : Y[j];
+    };
+
+    // Dirichlet values on the spot boundaries.
+    auto lowerBoundary = [&](int j, double tau, double r_local) {
+        double value = isCall ? 0.0 : K * std::exp(-rateAt(j, r_local) * tau);
+        return isAmerican ? std::max(value, payoff[0]) : value;
+    };
+    auto upperBoundary = [&](int j, double tau, double r_local) {
+        double value = isCall ? Smax * std::exp(-q * tau) - K * std::exp(-rateAt(j, r_local) * tau) : 0.0;
+        return isAmerican ? std::max(value, payoff[Ns]) : value;
+    };
+
+    // Evaluates F0, F1 and F2 of the grid u on the interior nodes of row j.
+    auto applyOperators = [&](const std::vector<double>& u, int j, double r_local) {
+        const double r = rateAt(j, r_local);
+        const size_t row = static_cast<size_t>(j) * stride;
+        const Stencil& dy1 = factorFirst[j];
+        const Stencil& dy2 = factorSecond[j];
+        for (int i = 1; i < Ns; ++i) {
+            const size_t k = row + i;
+            const Stencil& ds1 = spotFirst[i];
+            const Stencil& ds2 = spotSecond[i];
+            double a1 = 0.5 * variance[j] * S[i] * S[i];
+            double b1 = (r - q) * S[i];
+            F1[k] = a1 * (ds2.lower * u[k - 1] + ds2.centre * u[k] + ds2.upper * u[k + 1])
+                + b1 * (ds1.lower * u[k - 1] + ds1.centre * u[k] + ds1.upper * u[k + 1]) - 0.5 * r * u[k];
+
+            if (j == 0) {
+                F0[k] = 0.0;
+                F2[k] = driftY[j] * (dy1.centre * u[k] + dy1.upper * u[k + stride]) - 0.5 * r * u[k];
+            }
+            else if (j == Ny) {
+                F0[k] = 0.0;
+                F2[k] = driftY[j] * (dy1.lower * u[k - stride] + dy1.centre * u[k]) - 0.5 * r * u[k];
+            }
+            else {
+                // Spot derivative on rows j - 1, j and j + 1, then derivative of these along the second axis.
+                auto spotDerivative = [&](size_t m) {
+                    return ds1.lower * u[m - 1] + ds1.centre * u[m] + ds1.upper * u[m + 1];
+                };
+                F0[k] = crossY[j] * S[i] * (dy1.lower * spotDerivative(k - stride) + dy1.centre * spotDerivative(k)
+                    + dy1.upper * spotDerivative(k + stride));
+                F2[k] = diffusionY[j] * (dy2.lower * u[k - stride] + dy2.centre * u[k] + dy2.upper * u[k + stride])
+                    + driftY[j] * (dy1.lower * u[k - stride] + dy1.centre * u[k] + dy1.upper * u[k + stride])
+                    - 0.5 * r * u[k];
+            }
+        }
+    };
+
+    // Solves (I - theta dt A1) out = rhs - theta dt F1 along row j, with Dirichlet values at tau.
+    auto solveSpotLine = [&](LineWorkspace& ws, const std::vector<double>& rhs, std::vector<double>& out,
+        int j, double tau, double r_local) {
+        const double r = rateAt(j, r_local);
+        const size_t row = static_cast<size_t>(j) * stride;
+        double low = lowerBoundary(j, tau, r_local);
+        double high = upperBoundary(j, tau, r_local);
+        for (int i = 1; i < Ns; ++i) {
+            const Stencil& ds1 = spotFirst[i];
+            const Stencil& ds2 = spotSecond[i];
+            double a1 = 0.5 * variance[j] * S[i] * S[i];
+            double b1 = (r - q) * S[i];
+            ws.a[i - 1] = -theta * dt * (a1 * ds2.lower + b1 * ds1.lower);
+            ws.b[i - 1] = 1.0 - theta * dt * (a1 * ds2.centre + b1 * ds1.centre - 0.5 * r);
+            ws.c[i - 1] = -theta * dt * (a1 * ds2.upper + b1 * ds1.upper);
+            ws.d[i - 1] = rhs[row + i] - theta * dt * F1[row + i];
+        }
+        ws.d[0] -= ws.a[0] * low;
+        ws.d[Ns - 2] -= ws.c[Ns - 2] * high;
+        solveTridiagonal(ws.a, ws.b, ws.c, ws.d, ws.x, ws.c_prime, ws.d_prime);
+        out[row] = low;
+        for (int i = 1; i < Ns; ++i) {
+            out[row + i] = ws.x[i - 1];
+        }
+        out[row + Ns] = high;
+    };
+
+    // Solves (I - theta dt A2) out = rhs - theta dt F2 along column i.
+    auto solveFactorLine = [&](LineWorkspace& ws, const std::vector<double>& rhs, std::vector<double>& out,
+        int i, double r_local) {
+        for (int j = 0; j <= Ny; ++j) {
+            const double r = rateAt(j, r_local);
+            const size_t k = static_cast<size_t>(j) * stride + i;
+            const Stencil& dy1 = factorFirst[j];
+            const Stencil& dy2 = factorSecond[j];
+            // On the edges the diffusion term is dropped and dy1 is one-sided.
+            double diffusion = (j == 0 || j == Ny) ? 0.0 : diffusionY[j];
+            ws.a[j] = -theta * dt * (diffusion * dy2.lower + driftY[j] * dy1.lower);
+            ws.b[j] = 1.0 - theta * dt * (diffusion * dy2.centre + driftY[j] * dy1.centre - 0.5 * r);
+            ws.c[j] = -theta * dt * (diffusion * dy2.upper + driftY[j] * dy1.upper);
+            ws.d[j] = rhs[k] - theta * dt * F2[k];
+        }
+        solveTridiagonal(ws.a, ws.b, ws.c, ws.d, ws.x, ws.c_prime, ws.d_prime);
+        for (int j = 0; j <= Ny; ++j) {
+            out[static_cast<size_t>(j) * stride + i] = ws.x[j];
+        }
+    };
+
+    // Thread count, capped so that every thread owns at least one line in each direction.
+    int threads = config_->adiThreads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::max(1, std::min(threads, std::min(Ny + 1, Ns - 1)));
+    StepBarrier barrier(threads);
+
+    auto worker = [&](int tid) {
+        LineWorkspace spotLine(Ns - 1);
+        LineWorkspace factorLine(Ny + 1);
+        // Rows [jBegin, jEnd) and interior columns [iBegin, iEnd) owned by this thread.
+        const int jBegin = (Ny + 1) * tid / threads;
+        const int jEnd = (Ny + 1) * (tid + 1) / threads;
+        const int iBegin = 1 + (Ns - 1) * tid / threads;
+        const int iEnd = 1 + (Ns - 1) * (tid + 1) / threads;
+
+        for (int n = 0; n < N; ++n) {
+            double tau = (n + 1) * dt;
+            double normTime = tau / T_effective;
+            double r_local = (!config_->yieldCurve.getData().empty()) ? config_->yieldCurve.getRate(normTime) + bump_.rateShift : r_default;
+
+            // Explicit predictor Y0 = U + dt F(U), then first implicit correction along the spot axis.
+            for (int j = jBegin; j < jEnd; ++j) {
+                const size_t row = static_cast<size_t>(j) * stride;
+                applyOperators(U, j, r_local);
+                for (int i = 1; i < Ns; ++i) {
+                    const size_t k = row + i;
+                    Y0[k] = U[k] + dt * (F0[k] + F1[k] + F2[k]);
+                }
+                solveSpotLine(spotLine, Y0, Y1, j, tau, r_local);
+                Y2[row] = Y1[row];
+                Y2[row + Ns] = Y1[row + Ns];
+            }
+            barrier.wait();
+
+            // First implicit correction along the second axis.
+            for (int i = iBegin; i < iEnd; ++i) {
+                solveFactorLine(factorLine, Y1, Y2, i, r_local);
+            }
+            barrier.wait();
+
+            // Corrector Y0~ = Y0 + dt/2 (F(Y2) - F(U)), then second implicit correction along the spot axis.
+            for (int j = jBegin; j < jEnd; ++j) {
+                const size_t row = static_cast<size_t>(j) * stride;
+                for (int i = 1; i < Ns; ++i) {
+                    const size_t k = row + i;
+                    Y0[k] -= 0.5 * dt * (F0[k] + F1[k] + F2[k]);
+                }
+                applyOperators(Y2, j, r_local);
+                for (int i = 1; i < Ns; ++i) {
+                    const size_t k = row + i;
+                    Y0[k] += 0.5 * dt * (F0[k] + F1[k] + F2[k]);
+                }
+                solveSpotLine(spotLine, Y0, Y1, j, tau, r_local);
+                U[row] = Y1[row];
+                U[row + Ns] = Y1[row + Ns];
+            }
+            barrier.wait();
+
+            // Second implicit correction along the second axis, then the American projection.
+            for (int i = iBegin; i < iEnd; ++i) {
+                solveFactorLine(factorLine, Y1, U, i, r_local);
+                if (isAmerican) {
+                    for (int j = 0; j <= Ny; ++j) {
+                        double& value = U[static_cast<size_t>(j) * stride + i];
+                        value = std::max(value, payoff[i]);
+                    }
+                }
+            }
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int tid = 1; tid < threads; ++tid) {
+        pool.emplace_back(worker, tid);
+    }
+    worker(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    // Bilinear interpolation at (S0, y0).
+    int i0 = intervalOf(S, S0);
+    int j0 = intervalOf(Y, y0);
+    double ws = std::min(std::max((S0 - S[i0]) / (S[i0 + 1] - S[i0]), 0.0), 1.0);
+    double wy = std::min(std::max((y0 - Y[j0]) / (Y[j0 + 1] - Y[j0]), 0.0), 1.0);
+    auto at = [&](int i, int j) { return U[static_cast<size_t>(j) * stride + i]; };
+    return (1.0 - wy) * ((1.0 - ws) * at(i0, j0) + ws * at(i0 + 1, j0))
+        + wy * ((1.0 - ws) * at(i0, j0 + 1) + ws * at(i0 + 1, j0 + 1));
+}
+
+/**
+ * @brief Computes the Greeks of the option using finite differences applied to the ADI pricer.
+ *
+ * The Greeks (Delta, Gamma, Vega, Theta, and Rho) are estimated by perturbing the input parameters
+ * and recalculating the option price. For the Heston model, Vega is the sensitivity to the
+ * initial volatility sqrt(v0).
+ *
+ * @param opt The option to evaluate.
+ * @return A Greeks structure containing the calculated values.
+ */
+Greeks AdiPricer::computeGreeks(const Option& opt) const {
+    double h = 0.01 * opt.getUnderlying();
+    double volStep = 0.01;
+    double rStep = 0.001;
+    double timeStep = 1.0 / 365.0; // One day
+
+    double basePrice = price(opt);
+
+    // --- Delta ---
+    Option opt_up = opt;
+    Option opt_down = opt;
+    opt_up.setUnderlying(opt.getUnderlying() + h);
+    opt_down.setUnderlying(opt.getUnderlying() - h);
+    double price_up = price(opt_up);
+    double price_down = price(opt_down);
+    double delta = (price_up - price_down) / (2 * h);
+
+    // --- Gamma ---
+    double gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+
+    // --- Vega ---
+    Option opt_vol_up = opt;
+    Option opt_vol_down = opt;
+    opt_vol_up.setVolatility(opt.getVolatility() + volStep);
+    opt_vol_down.setVolatility(opt.getVolatility() - volStep);
+    double vega = (price(opt_vol_up) - price(opt_vol_down)) / (2 * volStep);
+
+    // --- Theta ---
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - timeStep);
+    double price_T_down = price(opt_T_down);
+    double theta = (price_T_down - basePrice) / (-timeStep);
+
+    // --- Rho ---
+    // The bumped pricers share the configuration and only shift the rates.
+    AdiPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    AdiPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
+    double rho = (pricer_r_up.price(opt) - pricer_r_down.price(opt)) / (2 * rStep);
+
+    Greeks greeks;
+    greeks.delta = delta;
+    greeks.gamma = gamma;
+    greeks.vega = vega;
+    greeks.theta = theta;
+    greeks.rho = rho;
+    return greeks;
+}
@@ -0,0 +1,72 @@
+#ifndef ADIPRICER_HPP
+#define ADIPRICER_HPP
+
+/**
+ * @file AdiPricer.hpp
+ * @brief Declaration of the AdiPricer class.
+ *
+ * This class implements option pricing on two-factor PDEs with the Hundsdorfer-Verwer
+ * alternating direction implicit (ADI) scheme. The second factor is either the variance
+ * (Heston model) or the short rate (mean-reverting stochastic interest rate), as selected
+ * by PricingConfiguration::adiModel. American options are handled by projection onto the
+ * payoff after each time step, as in the Crank-Nicolson pricer.
+ */
+
+#include "pch.h"
+#include "InterfaceOptionPricer.hpp"
+#include "PricingConfiguration.hpp"
+#include <memory>
+
+/**
+ * @brief Class that implements the two-factor ADI pricing model.
+ */
+class AdiPricer : public IOptionPricer {
+public:
+    /**
+     * @brief Default constructor.
+     */
+    AdiPricer();
+
+    /**
+     * @brief Constructor with pricing configuration.
+     * @param config A PricingConfiguration structure containing additional parameters,
+     *               such as the calculation date, maturity, grid sizes, thread count and
+     *               the parameters of the second factor.
+     */
+    AdiPricer(const PricingConfiguration& config);
+
+    /**
+     * @brief Constructor sharing a configuration, with an optional bump overlay.
+     *
+     * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+     *
+     * @param config The shared configuration (not null).
+     * @param bump The overlay applied on top of the configuration.
+     */
+    AdiPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~AdiPricer();
+
+    /**
+     * @brief Computes the price of the option with the ADI scheme.
+     * @param opt The option to be priced.
+     * @return The computed option price.
+     */
+    virtual double price(const Option& opt) const override;
+
+    /**
+     * @brief Computes the Greeks of the option using finite differences applied to the ADI pricer.
+     * @param opt The option to evaluate.
+     * @return A Greeks structure containing the calculated values.
+     */
+    virtual Greeks computeGreeks(const Option& opt) const override;
+
+private:
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the ADI model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
+};
+
+#endif // ADIPRICER_HPP
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "AsyncPricingDLL.hpp"
+#include "AsyncPricingService.hpp"
+#include "DateConverter.hpp"
+#include "YieldCurveCache.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+
+    long long __stdcall SubmitPricingBatch(
+        int pricerType, int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        int computeGreeks,
+        PricingCompletionCallback callback, void* context)
+    {
+        try {
+            if (pricerType < static_cast<int>(PricerType::BlackScholes) || pricerType > static_cast<int>(PricerType::CarrMadan))
+                throw std::invalid_argument("Unknown pricer type.");
+            if (count < 0 || (count > 0 && !(S && K && T && r && sigma && q && optionType && optionStyle)))
+                throw std::invalid_argument("Invalid batch arrays.");
+
+            // Configuration shared by the batch, built once on the calling thread.
+            PricingConfiguration config;
+            if (calculationDate == nullptr || strlen(calculationDate) == 0)
+                config.calculationDate = DateConverter::getTodayDate();
+            else
+                config.calculationDate = calculationDate;
+            // The Black-Scholes functions use the constant rate r, not the curve.
+            if (static_cast<PricerType>(pricerType) != PricerType::BlackScholes)
+                config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.binomialSteps = binomialSteps;
+            config.crankTimeSteps = crankTimeSteps;
+            config.crankSpotSteps = crankSpotSteps;
+            config.S_max = S_max;
+            config.mcNumPaths = mcNumPaths;
+            config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+
+            std::vector<PricingRequest> batch;
+            batch.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                // The maturity is set on the option, so that the options with the same rate share an engine.
+                config.riskFreeRate = r[i];
+                Option opt(S[i], K[i], sigma[i], q[i],
+                    (optionType[i] == 0 ? Option::OptionType::Call : Option::OptionType::Put),
+                    (optionStyle[i] == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+                opt.setMaturity(T[i]);
+                batch.push_back(PricingRequest{ static_cast<PricerType>(pricerType), config, opt, computeGreeks != 0 });
+            }
+
+            AsyncPricingService::CompletionCallback completion;
+            if (callback) {
+                completion = [callback, context](AsyncPricingService::Ticket ticket, const std::vector<PricingResult>&) {
+                    callback(static_cast<long long>(ticket), context);
+                };
+            }
+            return static_cast<long long>(AsyncPricingService::instance().submit(std::move(batch), completion));
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+    int __stdcall GetPricingStatus(long long ticket, int* completedCount)
+    {
+        if (ticket <= 0) {
+            if (completedCount) *completedCount = 0;
+            return -1;
+        }
+        AsyncPricingService& service = AsyncPricingService::instance();
+        AsyncPricingService::Ticket id = static_cast<AsyncPricingService::Ticket>(ticket);
+        if (completedCount) *completedCount = static_cast<int>(service.completedCount(id));
+        switch (service.status(id)) {
+        case TicketStatus::Pending:   return 0;
+        case TicketStatus::Running:   return 1;
+        case TicketStatus::Completed: return 2;
+        case TicketStatus::Cancelled: return 3;
+        default:                      return -1;
+        }
+    }
+
+    int __stdcall TakePricingResults(long long ticket, int count,
+        double* prices, double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        try {
+            if (ticket <= 0 || count < 0)
+                return -1;
+            AsyncPricingService& service = AsyncPricingService::instance();
+            AsyncPricingService::Ticket id = static_cast<AsyncPricingService::Ticket>(ticket);
+            std::shared_future<std::vector<PricingResult>> future = service.results(id);
+            if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return -1;
+
+            const std::vector<PricingResult>& results = future.get();
+            if (results.size() != static_cast<size_t>(count))
+                return -1;
+            int succeeded = 0;
+            for (size_t i = 0; i < results.size(); ++i) {
+                const PricingResult& result = results[i];
+                if (result.ok)
+                    ++succeeded;
+                if (prices) prices[i] = result.ok ? result.price : -1.0;
+                if (delta)  delta[i] = result.ok ? result.greeks.delta : NAN;
+                if (gamma)  gamma[i] = result.ok ? result.greeks.gamma : NAN;
+                if (vega)   vega[i] = result.ok ? result.greeks.vega : NAN;
+                if (theta)  theta[i] = result.ok ? result.greeks.theta : NAN;
+                if (rho)    rho[i] = result.ok ? result.greeks.rho : NAN;
+            }
+            service.release(id);
+            return succeeded;
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+    int __stdcall CancelPricingBatch(long long ticket)
+    {
+        if (ticket <= 0)
+            return -1;
+        return AsyncPricingService::instance().cancel(static_cast<AsyncPricingService::Ticket>(ticket)) ? 0 : -1;
+    }
+
+} // extern "C"
@@ -0,0 +1,61 @@
+#ifndef ASYNC_PRICING_DLL_HPP
+#define ASYNC_PRICING_DLL_HPP
+
+#ifdef ASYNC_PRICING_DLL_EXPORTS
+#define ASYNC_PRICING_API __declspec(dllexport)
+#else
+#define ASYNC_PRICING_API __declspec(dllimport)
+#endif
+
+#include "pch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Callback called on a worker thread when a batch is completed or cancelled. It must not call
+    // into Excel; VBA callers should poll GetPricingStatus instead.
+    typedef void(__stdcall* PricingCompletionCallback)(long long ticket, void* context);
+
+    // Function to submit a batch of options, priced in the background by the process-wide thread pool.
+    // Parameters:
+    //  pricerType: 0 = Black-Scholes, 1 = Binomial, 2 = Crank-Nicolson, 3 = Monte Carlo,
+    //              4 = ADI, 5 = Jump-diffusion, 6 = COS, 7 = Carr-Madan
+    //  count: Number of options; S to optionStyle are arrays of count values (one per option)
+    //  calculationDate: A null-terminated string in "YYYY-MM-DD"; if empty, today's date is used.
+    //  binomialSteps, crankTimeSteps, crankSpotSteps, S_max, mcNumPaths, mcTimeStepsPerPath: Model
+    //              parameters shared by the batch, as in the stateless functions
+    //  computeGreeks: 0 = prices only, 1 = prices and Greeks
+    //  callback, context: Optional completion callback (may be null) and its argument
+    // Returns the ticket of the batch (> 0) at once, or -1 on error.
+    ASYNC_PRICING_API long long __stdcall SubmitPricingBatch(
+        int pricerType, int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        int computeGreeks,
+        PricingCompletionCallback callback, void* context);
+
+    // Function to get the state of a batch: 0 = pending, 1 = running, 2 = completed, 3 = cancelled,
+    // -1 = unknown ticket. If completedCount is not null, it receives the number of options done.
+    ASYNC_PRICING_API int __stdcall GetPricingStatus(long long ticket, int* completedCount);
+
+    // Function to copy the results of a completed or cancelled batch and release its ticket.
+    // count must be the number of options of the batch; each array (which may be null) receives count
+    // values. A failed or cancelled option gets -1 as price and NAN as Greeks. Returns the number of
+    // options priced without error, or -1 if the ticket is unknown, the batch is not finished or count
+    // does not match the batch (the ticket is then kept and nothing is written).
+    ASYNC_PRICING_API int __stdcall TakePricingResults(long long ticket, int count,
+        double* prices, double* delta, double* gamma, double* vega, double* theta, double* rho);
+
+    // Function to cancel the options of a batch that have not started. The batch then completes
+    // once the running options are done, as cancelled if at least one option was dropped, and as
+    // completed otherwise. Returns 0, or -1 if the ticket is unknown or the batch is already finished.
+    ASYNC_PRICING_API int __stdcall CancelPricingBatch(long long ticket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASYNC_PRICING_DLL_HPP
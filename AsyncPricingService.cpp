@@ -0,0 +1,278 @@
+/**
+ * @file AsyncPricingService.cpp
+ * @brief Implementation of the AsyncPricingService class.
+ */
+
+#include "pch.h"
+#include "AsyncPricingService.hpp"
+#include "BatchPricing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+AsyncPricingService& AsyncPricingService::instance() {
+    // Never destroyed: the workers cannot be joined while the DLL is being unloaded, so the
+    // module is pinned for the lifetime of the process, as for the curve watcher.
+    static AsyncPricingService* service = [] {
+        HMODULE module = nullptr;
+        GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+            reinterpret_cast<LPCSTR>(&AsyncPricingService::instance), &module);
+        return new AsyncPricingService(0);
+    }();
+    return *service;
+}
+
+AsyncPricingService::AsyncPricingService(int threads)
+    : nextTicket_(1),
+    stopping_(false)
+{
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back(&AsyncPricingService::work, this);
+    }
+}
+
+AsyncPricingService::~AsyncPricingService() {
+    std::vector<std::shared_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (const auto& item : jobs_) {
+            jobs.push_back(item.second);
+        }
+    }
+    available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    // The workers are gone: complete the options they left in the queue.
+    for (const auto& job : jobs) {
+        cancel(job->ticket);
+    }
+}
+
+AsyncPricingService::Ticket AsyncPricingService::submit(std::vector<PricingRequest> batch, CompletionCallback callback) {
+    auto job = std::make_shared<Job>();
+    job->requests = std::move(batch);
+    job->results.resize(job->requests.size());
+    job->callback = std::move(callback);
+    return enqueue(job, job->requests.size());
+}
+
+AsyncPricingService::Ticket AsyncPricingService::submit(PricingBatchRequest batch, CompletionCallback callback) {
+    auto job = std::make_shared<Job>();
+    job->results.resize(batch.options.size());
+    job->batch.reset(new PricingBatchRequest(std::move(batch)));
+    job->callback = std::move(callback);
+    return enqueue(job, job->results.empty() ? 0 : 1);
+}
+
+AsyncPricingService::Ticket AsyncPricingService::enqueue(const std::shared_ptr<Job>& job, size_t items) {
+    job->future = job->promise.get_future().share();
+    job->started = 0;
+    job->done = 0;
+    job->cancelled = false;
+    job->finished = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->ticket = nextTicket_++;
+        jobs_[job->ticket] = job;
+        for (size_t i = 0; i < items; ++i) {
+            queue_.emplace_back(job, i);
+        }
+    }
+    if (job->results.empty()) {
+        // Nothing to price: the batch is completed at once.
+        job->finished = true;
+        job->promise.set_value(job->results);
+        if (job->callback) {
+            try {
+                job->callback(job->ticket, job->results);
+            }
+            catch (...) {
+            }
+        }
+    }
+    available_.notify_all();
+    return job->ticket;
+}
+
+TicketStatus AsyncPricingService::status(Ticket ticket) const {
+    std::shared_ptr<Job> job = find(ticket);
+    if (!job) {
+        return TicketStatus::Unknown;
+    }
+    if (job->finished) {
+        return job->cancelled ? TicketStatus::Cancelled : TicketStatus::Completed;
+    }
+    return (job->started > 0) ? TicketStatus::Running : TicketStatus::Pending;
+}
+
+size_t AsyncPricingService::completedCount(Ticket ticket) const {
+    std::shared_ptr<Job> job = find(ticket);
+    return job ? job->done.load() : 0;
+}
+
+std::shared_future<std::vector<PricingResult>> AsyncPricingService::results(Ticket ticket) const {
+    std::shared_ptr<Job> job = find(ticket);
+    if (!job) {
+        throw std::invalid_argument("Unknown pricing ticket.");
+    }
+    return job->future;
+}
+
+bool AsyncPricingService::cancel(Ticket ticket) {
+    std::shared_ptr<Job> job;
+    std::vector<size_t> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(ticket);
+        if (it == jobs_.end() || it->second->finished) {
+            return false;
+        }
+        job = it->second;
+        auto keep = std::remove_if(queue_.begin(), queue_.end(),
+            [&](const std::pair<std::shared_ptr<Job>, size_t>& item) {
+                if (item.first != job) {
+                    return false;
+                }
+                removed.push_back(item.second);
+                return true;
+            });
+        queue_.erase(keep, queue_.end());
+        if (!removed.empty()) {
+            job->cancelled = true;
+        }
+    }
+    if (job->batch && !removed.empty()) {
+        // The single item of a batch job stands for all its options.
+        removed.resize(job->results.size());
+        for (size_t i = 0; i < removed.size(); ++i) {
+            removed[i] = i;
+        }
+    }
+    for (size_t index : removed) {
+        job->results[index].ok = false;
+        job->results[index].error = "Cancelled.";
+        finishOne(job);
+    }
+    return true;
+}
+
+bool AsyncPricingService::release(Ticket ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.erase(ticket) > 0;
+}
+
+std::shared_ptr<AsyncPricingService::Job> AsyncPricingService::find(Ticket ticket) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(ticket);
+    return (it != jobs_.end()) ? it->second : std::shared_ptr<Job>();
+}
+
+void AsyncPricingService::work() {
+    for (;;) {
+        std::pair<std::shared_ptr<Job>, size_t> item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            item = std::move(queue_.front());
+            queue_.pop_front();
+            ++item.first->started;
+        }
+        if (item.first->batch) {
+            runBatch(item.first);
+        }
+        else {
+            run(item.first, item.second);
+        }
+    }
+}
+
+void AsyncPricingService::run(const std::shared_ptr<Job>& job, size_t index) {
+    const PricingRequest& request = job->requests[index];
+    PricingResult& result = job->results[index];
+    try {
+        PooledPricer pricer = PricerFactory::acquirePricer(request.type, request.config);
+        result.price = pricer->price(request.option);
+        result.greeks = request.computeGreeks ? pricer->computeGreeks(request.option)
+            : Greeks{ NAN, NAN, NAN, NAN, NAN };
+        result.ok = true;
+    }
+    catch (const std::exception& ex) {
+        result.ok = false;
+        result.error = ex.what();
+    }
+    finishOne(job);
+}
+
+void AsyncPricingService::runBatch(const std::shared_ptr<Job>& job) {
+    const PricingBatchRequest& batch = *job->batch;
+    const OptionBatchView options = batch.options.view();
+    const size_t count = options.size();
+    const Greeks noGreeks = { NAN, NAN, NAN, NAN, NAN };
+    try {
+        PooledPricer pricer = PricerFactory::acquirePricer(batch.type, batch.config);
+        Option option;
+        priceRunWithFallback(0, count,
+            [&]() {
+                std::vector<double> prices(count);
+                std::vector<Greeks> greeks(batch.computeGreeks ? count : 0);
+                pricer->priceBatch(options, prices.data());
+                if (batch.computeGreeks) {
+                    pricer->computeGreeksBatch(options, greeks.data());
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    PricingResult& result = job->results[i];
+                    result.price = prices[i];
+                    result.greeks = batch.computeGreeks ? greeks[i] : noGreeks;
+                    result.ok = true;
+                }
+            },
+            [&](size_t i) {
+                PricingResult& result = job->results[i];
+                options.load(i, option);
+                result.price = pricer->price(option);
+                result.greeks = batch.computeGreeks ? pricer->computeGreeks(option) : noGreeks;
+                result.ok = true;
+            },
+            [&](size_t i, const std::exception& ex) {
+                PricingResult& result = job->results[i];
+                result.ok = false;
+                result.error = ex.what();
+            });
+    }
+    catch (const std::exception& ex) {
+        for (PricingResult& result : job->results) {
+            result.ok = false;
+            result.error = ex.what();
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        finishOne(job);
+    }
+}
+
+void AsyncPricingService::finishOne(const std::shared_ptr<Job>& job) {
+    if (++job->done != job->results.size()) {
+        return;
+    }
+    // Finished first, so that a thread woken by the future sees the final status.
+    job->finished = true;
+    job->promise.set_value(job->results);
+    if (job->callback) {
+        try {
+            job->callback(job->ticket, job->results);
+        }
+        catch (...) {
+            // A failing callback must not stop the worker.
+        }
+    }
+}
@@ -0,0 +1,221 @@
+#ifndef ASYNCPRICINGSERVICE_HPP
+#define ASYNCPRICINGSERVICE_HPP
+
+/**
+ * @file AsyncPricingService.hpp
+ * @brief Declaration of the AsyncPricingService class, which prices batches of options in the background.
+ *
+ * A batch is submitted in one call, which returns a ticket at once. The options of the batch are
+ * priced by a pool of worker threads with the synchronous IOptionPricer::price and computeGreeks of
+ * the engines lent by PricerFactory::acquirePricer(), so that the requests with the same configuration
+ * reuse prepared engines, and the results are obtained through a future, by polling the status of the ticket, or from a
+ * callback run when the last option of the batch is done. Options sharing one engine and one
+ * configuration can also be submitted together (PricingBatchRequest), to be priced by a single
+ * priceBatch() call.
+ */
+
+#include "pch.h"
+#include "InterfaceOptionPricer.hpp"
+#include "PricerFactory.hpp"
+#include "PricingConfiguration.hpp"
+#include "Option.hpp"
+#include "OptionBatch.hpp"
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @brief One option of a batch, with the engine and the configuration used to price it.
+ */
+struct PricingRequest {
+    PricerType type;              ///< Engine.
+    PricingConfiguration config;  ///< Configuration of the engine (maturity, rate, curve, model parameters).
+    Option option;                ///< The option (its own maturity, if set, lets requests of different maturities share an engine).
+    bool computeGreeks;           ///< Compute the Greeks as well as the price.
+};
+
+/**
+ * @brief Options priced with one engine and one configuration.
+ */
+struct PricingBatchRequest {
+    PricerType type;              ///< Engine.
+    PricingConfiguration config;  ///< Configuration of the engine.
+    OptionBatch options;          ///< The options, each with its maturity.
+    bool computeGreeks;           ///< Compute the Greeks of every option as well as the prices.
+};
+
+/**
+ * @brief Result of one option of a batch.
+ */
+struct PricingResult {
+    bool ok;              ///< False if the pricing failed or was cancelled.
+    double price;         ///< Price (if ok).
+    Greeks greeks;        ///< Greeks (if ok; NAN if they were not requested).
+    std::string error;    ///< Error message (if not ok).
+};
+
+/**
+ * @brief State of a ticket.
+ */
+enum class TicketStatus {
+    Pending,    ///< No option of the batch has started.
+    Running,    ///< Some options are being priced.
+    Completed,  ///< All the options are done (each result tells whether it succeeded).
+    Cancelled,  ///< cancel() dropped at least one option before it started; those options have no result.
+    Unknown     ///< No such ticket (never submitted, or already released).
+};
+
+/**
+ * @brief Background pricing of option batches on a pool of worker threads.
+ *
+ * The options of all the batches go through one queue in submission order, so a large batch
+ * keeps all the workers busy and a later batch starts as soon as workers are free. A ticket and
+ * its results are kept until they are released.
+ */
+class AsyncPricingService {
+public:
+    typedef unsigned long long Ticket;
+
+    /**
+     * @brief Callback run on a worker thread when a batch is completed or cancelled.
+     *
+     * The callback must not block for long, as it holds a worker; exceptions it throws are ignored.
+     */
+    typedef std::function<void(Ticket, const std::vector<PricingResult>&)> CompletionCallback;
+
+    /**
+     * @brief Returns the process-wide instance, whose workers are never stopped.
+     */
+    static AsyncPricingService& instance();
+
+    /**
+     * @brief Starts the worker threads.
+     * @param threads The number of workers (0 = hardware concurrency).
+     */
+    explicit AsyncPricingService(int threads = 0);
+
+    AsyncPricingService(const AsyncPricingService&) = delete;
+    AsyncPricingService& operator=(const AsyncPricingService&) = delete;
+
+    /**
+     * @brief Cancels the pending options and stops the workers once the running ones are done.
+     */
+    ~AsyncPricingService();
+
+    /**
+     * @brief Submits a batch.
+     * @param batch The options to price.
+     * @param callback Called once the batch is completed or cancelled (may be empty).
+     * @return The ticket of the batch (never 0).
+     */
+    Ticket submit(std::vector<PricingRequest> batch, CompletionCallback callback = CompletionCallback());
+
+    /**
+     * @brief Submits options sharing one engine and one configuration.
+     *
+     * One worker prices them all with one engine of the pool and a single priceBatch() call (and
+     * computeGreeksBatch() if requested). If the batch call fails, the options are priced one by one,
+     * so that only the failing ones get an error. A cancellation drops the whole batch if it has not
+     * started.
+     *
+     * @param batch The options and their engine.
+     * @param callback Called once the batch is completed or cancelled (may be empty).
+     * @return The ticket of the batch (never 0); the results are in the order of batch.options.
+     */
+    Ticket submit(PricingBatchRequest batch, CompletionCallback callback = CompletionCallback());
+
+    /**
+     * @brief Returns the state of a ticket.
+     */
+    TicketStatus status(Ticket ticket) const;
+
+    /**
+     * @brief Returns the number of options of a batch that are done.
+     */
+    size_t completedCount(Ticket ticket) const;
+
+    /**
+     * @brief Returns a future holding the results of a batch, in the order of the batch.
+     * @throw std::invalid_argument if the ticket is unknown.
+     */
+    std::shared_future<std::vector<PricingResult>> results(Ticket ticket) const;
+
+    /**
+     * @brief Cancels the options of a batch that have not started.
+     *
+     * The batch is reported as cancelled only if an option was dropped; if they had all started,
+     * it completes normally.
+     *
+     * @return False if the ticket is unknown or the batch is already completed.
+     */
+    bool cancel(Ticket ticket);
+
+    /**
+     * @brief Forgets a ticket. Futures already obtained remain valid.
+     * @return False if the ticket is unknown.
+     */
+    bool release(Ticket ticket);
+
+private:
+    /**
+     * @brief A submitted batch.
+     */
+    struct Job {
+        Ticket ticket;
+        std::vector<PricingRequest> requests;
+        std::unique_ptr<const PricingBatchRequest> batch; ///< Set instead of requests for submit(PricingBatchRequest).
+        std::vector<PricingResult> results;
+        CompletionCallback callback;
+        std::promise<std::vector<PricingResult>> promise;
+        std::shared_future<std::vector<PricingResult>> future;
+        std::atomic<size_t> started;   ///< Number of options taken by the workers.
+        std::atomic<size_t> done;      ///< Number of options done.
+        std::atomic<bool> cancelled;   ///< True once cancel() has dropped an option.
+        std::atomic<bool> finished;
+    };
+
+    /**
+     * @brief Body of a worker thread.
+     */
+    void work();
+
+    /**
+     * @brief Prices one option of a job and completes the job if it was the last one.
+     */
+    void run(const std::shared_ptr<Job>& job, size_t index);
+
+    /**
+     * @brief Prices all the options of a job submitted as a PricingBatchRequest.
+     */
+    void runBatch(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Registers a job and queues its work items.
+     */
+    Ticket enqueue(const std::shared_ptr<Job>& job, size_t items);
+
+    /**
+     * @brief Marks one option of a job as done, and completes the job after the last one.
+     */
+    void finishOne(const std::shared_ptr<Job>& job);
+
+    std::shared_ptr<Job> find(Ticket ticket) const;
+
+    mutable std::mutex mutex_;                              ///< Protects queue_, jobs_, nextTicket_ and stopping_.
+    std::condition_variable available_;                     ///< Signals new work or stopping.
+    std::deque<std::pair<std::shared_ptr<Job>, size_t>> queue_; ///< Options waiting for a worker (a single item for a batch job).
+    std::map<Ticket, std::shared_ptr<Job>> jobs_;           ///< Jobs not yet released.
+    Ticket nextTicket_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+};
+
+#endif // ASYNCPRICINGSERVICE_HPP
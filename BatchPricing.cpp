@@ -0,0 +1,152 @@
+/**
+ * @file BatchPricing.cpp
+ * @brief Implementation of the DLL batch exports shared by every engine.
+ */
+
+#include "pch.h"
+#include "BatchPricing.hpp"
+#include "OptionBatch.hpp"
+#include "DateConverter.hpp"
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    // Checks the input arrays of a batch call (they may be null when count is 0).
+    bool validInputs(const BatchExportInputs& in) {
+        if (in.count < 0)
+            return false;
+        return in.count == 0 || (in.S && in.K && in.T && in.r && in.sigma && in.q && in.optionType && in.optionStyle);
+    }
+
+    Option::OptionType typeOf(const BatchExportInputs& in, int i) {
+        return in.optionType[i] == 0 ? Option::OptionType::Call : Option::OptionType::Put;
+    }
+
+    Option::OptionStyle styleOf(const BatchExportInputs& in, int i) {
+        return in.optionStyle[i] == 0 ? Option::OptionStyle::European : Option::OptionStyle::American;
+    }
+
+    // Fills the batch with the rows [begin, end) of the input arrays.
+    void fillBatch(OptionBatch& batch, const BatchExportInputs& in, int begin, int end) {
+        batch.clear();
+        for (int i = begin; i < end; ++i) {
+            batch.add(in.S[i], in.K[i], in.sigma[i], in.q[i], in.T[i], typeOf(in, i), styleOf(in, i));
+        }
+    }
+
+    // Builds the option of row i, as the scalar exports do.
+    Option rowOption(const BatchExportInputs& in, int i) {
+        Option opt(in.S[i], in.K[i], in.sigma[i], in.q[i], typeOf(in, i), styleOf(in, i));
+        opt.setMaturity(in.T[i]);
+        return opt;
+    }
+
+    void writeGreeks(double* delta, double* gamma, double* vega, double* theta, double* rho, int i, const Greeks& g) {
+        if (delta) delta[i] = g.delta;
+        if (gamma) gamma[i] = g.gamma;
+        if (vega)  vega[i] = g.vega;
+        if (theta) theta[i] = g.theta;
+        if (rho)   rho[i] = g.rho;
+    }
+
+    /**
+     * Prices the rows of a batch export run by run, as described by priceBatchExport(): the fields
+     * common to the whole range are filled in once, then each run of equal rates gets its own
+     * configuration. runBatch(pricer, view, begin) prices a run with one batch call,
+     * rowCall(pricer, option, i) a single row, and rowFailed(i) marks a failing row.
+     */
+    template <typename RunBatch, typename RowCall, typename RowFailed>
+    int priceRateRuns(PricerType type, const BatchExportInputs& in, const BatchConfigFiller& fillConfig,
+        const RunBatch& runBatch, const RowCall& rowCall, const RowFailed& rowFailed) {
+        PricingConfiguration config;
+        if (in.calculationDate == nullptr || strlen(in.calculationDate) == 0)
+            config.calculationDate = DateConverter::getTodayDate();
+        else
+            config.calculationDate = in.calculationDate;
+        fillConfig(config);
+
+        int done = 0;
+        std::unique_ptr<IOptionPricer> pricer;
+        OptionBatch batch;
+        for (int begin = 0; begin < in.count;) {
+            int end = begin + 1;
+            while (end < in.count && in.r[end] == in.r[begin])
+                ++end;
+            done += static_cast<int>(priceRunWithFallback(static_cast<size_t>(begin), static_cast<size_t>(end),
+                [&]() {
+                    pricer.reset();
+                    config.riskFreeRate = in.r[begin];
+                    pricer = PricerFactory::createPricer(type, std::make_shared<const PricingConfiguration>(config));
+                    pricer->prepare();
+                    fillBatch(batch, in, begin, end);
+                    runBatch(*pricer, batch.view(), begin);
+                },
+                [&](size_t i) {
+                    if (!pricer)
+                        throw std::runtime_error("No pricer for this rate.");
+                    rowCall(*pricer, rowOption(in, static_cast<int>(i)), static_cast<int>(i));
+                },
+                [&](size_t i, const std::exception&) {
+                    rowFailed(static_cast<int>(i));
+                }));
+            begin = end;
+        }
+        return done;
+    }
+
+} // namespace
+
+int priceBatchExport(PricerType type, const BatchExportInputs& inputs, const BatchConfigFiller& fillConfig,
+    double* prices) {
+    if (!validInputs(inputs) || (inputs.count > 0 && !prices))
+        return -1;
+    try {
+        return priceRateRuns(type, inputs, fillConfig,
+            [&](const IOptionPricer& pricer, const OptionBatchView& run, int begin) {
+                pricer.priceBatch(run, prices + begin);
+            },
+            [&](const IOptionPricer& pricer, const Option& opt, int i) {
+                prices[i] = pricer.price(opt);
+            },
+            [&](int i) {
+                prices[i] = -1.0;
+            });
+    }
+    catch (const std::exception&) {
+        for (int i = 0; i < inputs.count; ++i)
+            prices[i] = -1.0;
+        return -1;
+    }
+}
+
+int computeGreeksBatchExport(PricerType type, const BatchExportInputs& inputs, const BatchConfigFiller& fillConfig,
+    double* delta, double* gamma, double* vega, double* theta, double* rho) {
+    if (!validInputs(inputs))
+        return -1;
+    const Greeks failed = { NAN, NAN, NAN, NAN, NAN };
+    try {
+        std::vector<Greeks> greeks;
+        return priceRateRuns(type, inputs, fillConfig,
+            [&](const IOptionPricer& pricer, const OptionBatchView& run, int begin) {
+                greeks.resize(run.size());
+                pricer.computeGreeksBatch(run, greeks.data());
+                for (size_t k = 0; k < run.size(); ++k)
+                    writeGreeks(delta, gamma, vega, theta, rho, begin + static_cast<int>(k), greeks[k]);
+            },
+            [&](const IOptionPricer& pricer, const Option& opt, int i) {
+                writeGreeks(delta, gamma, vega, theta, rho, i, pricer.computeGreeks(opt));
+            },
+            [&](int i) {
+                writeGreeks(delta, gamma, vega, theta, rho, i, failed);
+            });
+    }
+    catch (const std::exception&) {
+        for (int i = 0; i < inputs.count; ++i)
+            writeGreeks(delta, gamma, vega, theta, rho, i, failed);
+        return -1;
+    }
+}
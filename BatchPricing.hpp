@@ -0,0 +1,105 @@
+#ifndef BATCHPRICING_HPP
+#define BATCHPRICING_HPP
+
+/**
+ * @file BatchPricing.hpp
+ * @brief Batch pricing helpers shared by the DLL batch exports, the AsyncPricingService and the PortfolioPricer.
+ *
+ * priceRunWithFallback() runs one batch call over a run of rows and, if it fails, prices the rows
+ * one by one. priceBatchExport() and computeGreeksBatchExport() implement the Price*Batch and
+ * Compute*GreeksBatch exports of the pricer DLLs for every engine: the exports only fill the
+ * engine-specific fields of the configuration.
+ */
+
+#include "pch.h"
+#include "PricerFactory.hpp"
+#include "PricingConfiguration.hpp"
+#include <cstddef>
+#include <exception>
+#include <functional>
+
+/**
+ * @brief Runs one batch call over the rows [begin, end), falling back to the rows one by one if it throws.
+ *
+ * The batch methods of IOptionPricer stop at their first failing option and leave the results of the
+ * other options undetermined: the run is then priced again row by row, so that only the failing rows
+ * are marked.
+ *
+ * @param batchCall Called once, with no argument; prices every row of the run or throws.
+ * @param rowCall Called with the index of each row if batchCall throws; prices that row or throws.
+ * @param rowFailed Called with the index of each row whose rowCall throws, and with the exception.
+ * @return The number of rows priced without error.
+ */
+template <typename BatchCall, typename RowCall, typename RowFailed>
+size_t priceRunWithFallback(size_t begin, size_t end, const BatchCall& batchCall, const RowCall& rowCall,
+    const RowFailed& rowFailed) {
+    try {
+        batchCall();
+        return end - begin;
+    }
+    catch (const std::exception&) {
+        size_t priced = 0;
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                rowCall(i);
+                ++priced;
+            }
+            catch (const std::exception& ex) {
+                rowFailed(i, ex);
+            }
+        }
+        return priced;
+    }
+}
+
+/**
+ * @brief Input arrays of a DLL batch export: count values per array, one per option.
+ *
+ * The arrays may be null when count is 0. optionType is 0 for a call and 1 for a put, optionStyle
+ * 0 for a European and 1 for an American option. calculationDate is shared by all the options
+ * ("YYYY-MM-DD"; null or empty for today).
+ */
+struct BatchExportInputs {
+    int count;
+    const double* S;
+    const double* K;
+    const double* T;
+    const double* r;
+    const double* sigma;
+    const double* q;
+    const int* optionType;
+    const int* optionStyle;
+    const char* calculationDate;
+};
+
+/// Fills the engine-specific fields (yield curve, discretization) of the configuration of a batch export.
+typedef std::function<void(PricingConfiguration&)> BatchConfigFiller;
+
+/**
+ * @brief Prices the options of a DLL batch export with the engine of the given type.
+ *
+ * Each option is priced with its own rate r[i], exactly as by the scalar export of the engine with
+ * the same arguments. The consecutive rows with the same rate are priced by one priceBatch() call,
+ * on an engine built on a shared configuration carrying that rate.
+ *
+ * @param type The engine.
+ * @param inputs The input arrays.
+ * @param fillConfig Fills the engine-specific fields of the configuration (called once).
+ * @param prices Receives the price of option i at index i (-1 if this option fails).
+ * @return The number of options priced without error, or -1 if the arguments are invalid.
+ */
+int priceBatchExport(PricerType type, const BatchExportInputs& inputs, const BatchConfigFiller& fillConfig,
+    double* prices);
+
+/**
+ * @brief Computes the Greeks of the options of a DLL batch export, as priceBatchExport() does for the prices.
+ *
+ * The Greeks of option i are written at index i of the arrays provided (a null array is skipped;
+ * NAN if this option fails).
+ *
+ * @return The number of options computed without error, or -1 if the arguments are invalid.
+ */
+int computeGreeksBatchExport(PricerType type, const BatchExportInputs& inputs, const BatchConfigFiller& fillConfig,
+    double* delta, double* gamma, double* vega, double* theta, double* rho);
+
+#endif // BATCHPRICING_HPP
@@ -12,25 +12,100 @@
 #include "pch.h"
 #include "BinomialPricer.hpp"
 #include "Option.hpp"
+#include "OptionBatch.hpp"
+#include "ParallelFor.hpp"
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <map>
 #include <stdexcept>
 
+namespace {
+
+    /**
+     * @brief Places the levels of a Bermudan tree so that every exercise time is exactly a level.
+     *
+     * As the time grid of the Crank-Nicolson engine, the tree is cut at the exercise times and each
+     * interval is divided into uniform steps. Interval ends go on level lround(N * t / T), moved up
+     * if needed so that every interval keeps at least one step: the N steps stay N steps.
+     *
+     * @param opt The Bermudan option.
+     * @param T The maturity of the tree.
+     * @param N The number of steps of the tree.
+     * @param levelTimes Receives the N + 1 normalized times (fractions of T) of the levels.
+     * @param steps Receives the N step lengths, in years.
+     * @param exerciseLevel Receives N + 1 flags, 1 on the exercise levels.
+     * @throw std::runtime_error if the tree has fewer steps than exercise intervals.
+     */
+    void placeExerciseLevels(const Option& opt, double T, int N, std::vector<double>& levelTimes,
+        std::vector<double>& steps, std::vector<char>& exerciseLevel) {
+        // Exercise times strictly inside (0, T), in fractions of T, plus a flag for immediate exercise.
+        const double tolerance = 1e-10;
+        bool exerciseToday = false;
+        std::vector<double> breaks;
+        for (double tEx : opt.getExerciseTimes()) {
+            double f = tEx / T;
+            if (std::abs(f) <= tolerance) {
+                exerciseToday = true;
+            }
+            else if (f > tolerance && f < 1.0 - tolerance) {
+                breaks.push_back(f);
+            }
+        }
+        std::sort(breaks.begin(), breaks.end());
+        breaks.erase(std::unique(breaks.begin(), breaks.end()), breaks.end());
+        if (static_cast<int>(breaks.size()) >= N) {
+            throw std::runtime_error("The binomial tree has fewer steps than Bermudan exercise intervals.");
+        }
+
+        levelTimes.assign(N + 1, 0.0);
+        steps.assign(N, 0.0);
+        exerciseLevel.assign(N + 1, 0);
+        exerciseLevel[0] = exerciseToday ? 1 : 0;
+        int previousLevel = 0;
+        double previousTime = 0.0;
+        for (size_t b = 0; b <= breaks.size(); ++b) {
+            bool last = (b == breaks.size());
+            double time = last ? 1.0 : breaks[b];
+            int remaining = static_cast<int>(breaks.size() - b); // Interval ends still to place after this one.
+            int level = last ? N : static_cast<int>(std::lround(N * time));
+            level = std::min(std::max(level, previousLevel + 1), N - remaining);
+            int count = level - previousLevel;
+            double step = (time - previousTime) / count;
+            for (int k = 1; k <= count; ++k) {
+                levelTimes[previousLevel + k] = (k == count) ? time : previousTime + k * step;
+                steps[previousLevel + k - 1] = step * T;
+            }
+            if (!last) {
+                exerciseLevel[level] = 1;
+            }
+            previousLevel = level;
+            previousTime = time;
+        }
+    }
+
+} // namespace
+
  /// Default constructor, using default configuration values.
 BinomialPricer::BinomialPricer()
-    : config_() // Default configuration from PricingConfiguration's default constructor
+    : config_(std::make_shared<const PricingConfiguration>())
 {
     // No additional initialization required.
 }
 
 /// Constructor with pricing configuration.
 BinomialPricer::BinomialPricer(const PricingConfiguration& config)
-    : config_(config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
 {
     // The configuration parameters are now stored in config_.
 }
 
+/// Constructor sharing a configuration, with a bump overlay.
+BinomialPricer::BinomialPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
 /// Destructor.
 BinomialPricer::~BinomialPricer() {
     // No dynamic cleanup is required.
@@ -40,81 +115,326 @@ BinomialPricer::~BinomialPricer() {
  * @brief Computes the option price using the binomial CRR model.
  *
  * This function calculates the price of an option using a binomial tree.
- * The number of steps in the tree is taken from the configuration (config_.binomialSteps).
+ * The number of steps in the tree is taken from the configuration (config_->binomialSteps).
  *
  * Instead of using a constant risk-free rate, the backward induction uses a variable rate
  * obtained via interpolation from the yield curve stored in the configuration.
  * For each time step, the local rate is obtained by:
- *   r_local = config_.yieldCurve.getRate(t_norm)
- * where t_norm is the normalized time (between 0 and 1).
+ *   r_local = config_->yieldCurve.getRate(t_norm) + bump_.rateShift
+ * where t_norm is the normalized time (between 0 and 1). The shift of a bumped pricer applies to
+ * these local rates only: the drift rate riskFreeRate is not shifted.
+ *
+ * Barrier options are priced on a tree aligned with the barrier: the number of steps is moved
+ * to the nearest value for which the barrier lies a whole number k of CRR moves away from the
+ * spot (Boyle-Lau), and u is then set to (B/S)^(1/k) so that the barrier is exactly a lattice
+ * level. Knock-in options are valued by rolling back the vanilla tree alongside and switching to
+ * it on the nodes beyond the barrier. A barrier less than half a CRR move away from the spot would
+ * need more than 4 * binomialSteps steps: the tree keeps binomialSteps steps instead, and the price
+ * is interpolated in log(B/S) between the barriers on the two lattice levels around B (Derman-Kani).
+ *
+ * The early exercise check runs only on exercise levels: every level for American options, and
+ * the exercise times themselves for Bermudan options. A Bermudan tree is cut at its exercise times
+ * and every interval is divided into uniform steps (see placeExerciseLevels()), so the steps differ
+ * slightly from one interval to the next. The CRR move u stays the same on every level: the tree
+ * still recombines and an aligned barrier stays a lattice level, and the N moves still carry the
+ * variance sigma^2 T of the whole life. The trade-off is on the variance carried by each interval,
+ * which is off by at most half a step from sigma^2 times its length; like the rounding of the
+ * exercise times it replaces, this error vanishes in O(1/N).
  *
  * @param opt The option to be priced.
  * @return The computed option price.
  */
 double BinomialPricer::price(const Option& opt) const {
+    return rollBack(opt, nullptr, nullptr);
+}
+
+/**
+ * @brief Rolls back the binomial tree for price(), optionally with the sensitivities to the local rates.
+ *
+ * When rateSensitivities is given, the values of every level are kept and an adjoint sweep runs
+ * from the root towards maturity once the price is known. The adjoint of a node is the derivative
+ * of the price with respect to its value; it flows to the two children through the discounted
+ * probabilities, except on nodes where the option is exercised or knocked out, whose values do not
+ * depend on the children. The derivative with respect to the rate of level i then collects, over
+ * the nodes of the level, the adjoint times the derivative of the discounted continuation value.
+ * The cost is one extra pass over the tree, whatever the number of curve points.
+ *
+ * @param opt The option to be priced.
+ * @param rateTimes If not null, receives the normalized times at which the local rates are read.
+ * @param rateSensitivities If not null, receives the derivative of the price with respect to each local rate.
+ * @return The computed option price.
+ */
+double BinomialPricer::rollBack(const Option& opt, std::vector<double>* rateTimes,
+    std::vector<double>* rateSensitivities) const {
+    if (rateTimes) {
+        rateTimes->clear();
+    }
+    if (rateSensitivities) {
+        rateSensitivities->clear();
+    }
+
     // Retrieve basic option parameters.
     double S = opt.getUnderlying();
     double K = opt.getStrike();
     double sigma = opt.getVolatility();
     double q = opt.getDividend();
-    // Retrieve the maturity and the default risk-free rate from the pricing configuration.
-    double T = config_.maturity;
-    double r_const = config_.riskFreeRate; // fallback if yield curve is not loaded
+    // Retrieve the maturity (the option's own, if any) and the default risk-free rate.
+    double T = config_->maturityOf(opt);
+    double r_const = config_->riskFreeRate; // fallback if yield curve is not loaded
 
     // Retrieve the number of steps from the configuration.
-    int N = config_.binomialSteps;
+    int N = config_->binomialSteps;
     double dt = T / N;
 
     // Compute the up and down factors using the CRR model.
     double u = std::exp(sigma * std::sqrt(dt));
+
+    // Align the tree with the barrier, if any.
+    Option::BarrierType barrierType = opt.getBarrierType();
+    bool hasBarrier = (barrierType != Option::BarrierType::None);
+    bool isUp = (barrierType == Option::BarrierType::UpAndOut || barrierType == Option::BarrierType::UpAndIn);
+    bool isKnockIn = (barrierType == Option::BarrierType::UpAndIn || barrierType == Option::BarrierType::DownAndIn);
+    int barrierLevel = 0; // Barrier position, in powers of u from the spot.
+    if (hasBarrier) {
+        double B = opt.getBarrier();
+        if (B <= 0.0) {
+            throw std::runtime_error("The barrier level must be positive.");
+        }
+        double logRatio = std::log(B / S);
+        if ((isUp && logRatio <= 0.0) || (!isUp && logRatio >= 0.0)) {
+            // The barrier is already breached: knock-outs are worthless, knock-ins are vanilla.
+            if (!isKnockIn) {
+                return 0.0;
+            }
+            Option vanilla = opt;
+            vanilla.setBarrier(Option::BarrierType::None, 0.0);
+            return rollBack(vanilla, rateTimes, rateSensitivities);
+        }
+        double movesPerSqrtStep = std::abs(logRatio) / (sigma * std::sqrt(T));
+        int k = std::max(1, static_cast<int>(std::lround(movesPerSqrtStep * std::sqrt(static_cast<double>(N)))));
+        double alignedSteps = (k / movesPerSqrtStep) * (k / movesPerSqrtStep);
+        // Number of steps of an aligned tree, in multiples of binomialSteps, beyond which the barrier is
+        // interpolated instead (it is then less than half a CRR move away from the spot).
+        const double maxAlignedStepFactor = 4.0;
+        if (alignedSteps > maxAlignedStepFactor * N) {
+            // Derman-Kani interpolation: the tree of N steps is priced with the barrier moved to the two
+            // lattice levels that bracket it, and the prices are interpolated linearly in log(B/S).
+            double move = sigma * std::sqrt(T / N);
+            double position = std::abs(logRatio) / move;
+            int inner = static_cast<int>(std::floor(position));
+            double weight = position - inner;
+            double direction = isUp ? 1.0 : -1.0;
+            Option innerOpt = opt;
+            Option outerOpt = opt;
+            innerOpt.setBarrier(barrierType, S * std::exp(direction * inner * move));
+            outerOpt.setBarrier(barrierType, S * std::exp(direction * (inner + 1) * move));
+            std::vector<double> innerSensitivities;
+            double innerPrice = rollBack(innerOpt, nullptr, rateSensitivities ? &innerSensitivities : nullptr);
+            double outerPrice = rollBack(outerOpt, rateTimes, rateSensitivities);
+            if (rateSensitivities) {
+                // A knocked-out inner barrier has no sensitivity: its vector is then empty.
+                for (size_t i = 0; i < rateSensitivities->size(); ++i) {
+                    double innerValue = (i < innerSensitivities.size()) ? innerSensitivities[i] : 0.0;
+                    (*rateSensitivities)[i] = (1.0 - weight) * innerValue + weight * (*rateSensitivities)[i];
+                }
+            }
+            return (1.0 - weight) * innerPrice + weight * outerPrice;
+        }
+        N = std::max(1, static_cast<int>(std::lround(alignedSteps)));
+        dt = T / N;
+        u = std::exp(std::abs(logRatio) / k);
+        barrierLevel = isUp ? k : -k;
+    }
+
+    // Normalized time and length of every level, and levels on which early exercise is allowed.
+    std::vector<double> levelTimes(N + 1);
+    std::vector<double> steps(N, dt);
+    std::vector<char> exerciseLevel(N + 1, 0);
+    if (opt.getOptionStyle() == Option::OptionStyle::Bermudan) {
+        placeExerciseLevels(opt, T, N, levelTimes, steps, exerciseLevel);
+    }
+    else {
+        for (int i = 0; i <= N; ++i) {
+            levelTimes[i] = static_cast<double>(i) / N;
+        }
+        if (opt.getOptionStyle() == Option::OptionStyle::American) {
+            std::fill(exerciseLevel.begin(), exerciseLevel.end(), 1);
+        }
+    }
+
     double d = 1.0 / u;
-    // For the forward simulation, use the constant risk-free rate.
-    double p = (std::exp((r_const - q) * dt) - d) / (u - d);
+    // For the forward simulation, use the constant risk-free rate (checked on the longest step).
+    double p = (std::exp((r_const - q) * *std::max_element(steps.begin(), steps.end())) - d) / (u - d);
     if (p < 0.0 || p > 1.0) {
         throw std::runtime_error("Invalid risk-neutral probability in the binomial model.");
     }
 
-    // Create a vector to store the terminal payoffs.
+    // Underlying price on lattice position m (S * u^m, m = 2j - i) for m in [-N, N].
+    std::vector<double> spot(2 * N + 1);
+    for (int m = -N; m <= N; ++m) {
+        spot[m + N] = S * std::pow(u, m);
+    }
+    auto intrinsicAt = [&](int m) {
+        return (opt.getOptionType() == Option::OptionType::Call) ? std::max(spot[m + N] - K, 0.0)
+            : std::max(K - spot[m + N], 0.0);
+    };
+    auto knocked = [&](int m) {
+        return isUp ? (m >= barrierLevel) : (m <= barrierLevel);
+    };
+
+    // Create a vector to store the terminal payoffs. Knock-in options also roll back the vanilla tree.
     std::vector<double> prices(N + 1);
+    std::vector<double> vanilla(isKnockIn ? N + 1 : 0);
     for (int j = 0; j <= N; ++j) {
-        double S_j = S * std::pow(u, j) * std::pow(d, N - j);
-        if (opt.getOptionType() == Option::OptionType::Call) {
-            prices[j] = std::max(S_j - K, 0.0);
+        int m = 2 * j - N;
+        double payoff = intrinsicAt(m);
+        if (!hasBarrier) {
+            prices[j] = payoff;
         }
-        else { // Put option
-            prices[j] = std::max(K - S_j, 0.0);
+        else if (isKnockIn) {
+            vanilla[j] = payoff;
+            prices[j] = knocked(m) ? payoff : 0.0;
+        }
+        else {
+            prices[j] = knocked(m) ? 0.0 : payoff;
         }
     }
 
+    // Values of every level (level i at offset i(i+1)/2) and local rates, kept for the adjoint sweep.
+    const bool adjoint = (rateSensitivities != nullptr);
+    std::vector<double> levels;
+    std::vector<double> vanillaLevels;
+    std::vector<double> rates;
+    if (adjoint) {
+        size_t nodes = static_cast<size_t>(N + 1) * static_cast<size_t>(N + 2) / 2;
+        levels.resize(nodes);
+        std::copy(prices.begin(), prices.end(), levels.begin() + static_cast<size_t>(N) * (N + 1) / 2);
+        if (isKnockIn) {
+            vanillaLevels.resize(nodes);
+            std::copy(vanilla.begin(), vanilla.end(), vanillaLevels.begin() + static_cast<size_t>(N) * (N + 1) / 2);
+        }
+        rates.resize(N);
+    }
+
     // Backward induction through the binomial tree with variable interest rate.
     for (int i = N - 1; i >= 0; --i) {
-        // Compute normalized time for the current step (i/N).
-        double t_norm = static_cast<double>(i) / N;
+        // Normalized time and length of the current step.
+        double t_norm = levelTimes[i];
+        double dt_local = steps[i];
         // Obtain the local risk-free rate via the yield curve.
         // If the yield curve is not loaded, it should return the default risk-free rate.
-        double r_local = config_.yieldCurve.getRate(t_norm);
+        double r_local = config_->yieldCurve.getRate(t_norm) + bump_.rateShift;
         // Compute the discount factor using the local rate.
-        double discountFactor = std::exp(-r_local * dt);
+        double discountFactor = std::exp(-r_local * dt_local);
         // Compute the local risk-neutral probability using the local rate.
-        double p_local = (std::exp((r_local - q) * dt) - d) / (u - d);
+        double p_local = (std::exp((r_local - q) * dt_local) - d) / (u - d);
+        bool exercise = (exerciseLevel[i] != 0);
 
         for (int j = 0; j <= i; ++j) {
+            int m = 2 * j - i;
             double continuation = discountFactor * (p_local * prices[j + 1] + (1.0 - p_local) * prices[j]);
-            if (opt.getOptionStyle() == Option::OptionStyle::American) {
-                double S_i = S * std::pow(u, j) * std::pow(d, i - j);
-                double intrinsic = 0.0;
-                if (opt.getOptionType() == Option::OptionType::Call) {
-                    intrinsic = std::max(S_i - K, 0.0);
+            if (isKnockIn) {
+                double vanillaValue = discountFactor * (p_local * vanilla[j + 1] + (1.0 - p_local) * vanilla[j]);
+                if (exercise) {
+                    vanillaValue = std::max(vanillaValue, intrinsicAt(m));
                 }
-                else {
-                    intrinsic = std::max(K - S_i, 0.0);
-                }
-                prices[j] = std::max(continuation, intrinsic);
+                vanilla[j] = vanillaValue;
+                // Not yet knocked in: the holder owns no exercise right.
+                prices[j] = knocked(m) ? vanillaValue : continuation;
+            }
+            else if (hasBarrier && knocked(m)) {
+                prices[j] = 0.0;
+            }
+            else if (exercise) {
+                prices[j] = std::max(continuation, intrinsicAt(m));
             }
             else {
                 prices[j] = continuation;
             }
         }
+
+        if (adjoint) {
+            size_t offset = static_cast<size_t>(i) * (i + 1) / 2;
+            std::copy(prices.begin(), prices.begin() + i + 1, levels.begin() + offset);
+            if (isKnockIn) {
+                std::copy(vanilla.begin(), vanilla.begin() + i + 1, vanillaLevels.begin() + offset);
+            }
+            rates[i] = r_local;
+        }
+    }
+
+    if (adjoint) {
+        if (rateTimes) {
+            rateTimes->resize(N);
+            for (int i = 0; i < N; ++i) {
+                (*rateTimes)[i] = levelTimes[i];
+            }
+        }
+        rateSensitivities->assign(N, 0.0);
+
+        // Adjoint sweep from the root: lambda[j] is the derivative of the price with respect to node j
+        // of the current level (lambdaVanilla for the vanilla tree of a knock-in option).
+        std::vector<double> lambda(1, 1.0);
+        std::vector<double> lambdaVanilla(isKnockIn ? 1 : 0, 0.0);
+        std::vector<double> nextLambda;
+        std::vector<double> nextLambdaVanilla;
+        for (int i = 0; i < N; ++i) {
+            double r_local = rates[i];
+            double dt_local = steps[i];
+            double discountFactor = std::exp(-r_local * dt_local);
+            double growth = std::exp((r_local - q) * dt_local);
+            double p_local = (growth - d) / (u - d);
+            double dp_local = dt_local * growth / (u - d);
+            bool exercise = (exerciseLevel[i] != 0);
+            const double* next = levels.data() + static_cast<size_t>(i + 1) * (i + 2) / 2;
+            const double* nextVanilla = isKnockIn ? vanillaLevels.data() + static_cast<size_t>(i + 1) * (i + 2) / 2 : nullptr;
+            nextLambda.assign(i + 2, 0.0);
+            nextLambdaVanilla.assign(isKnockIn ? i + 2 : 0, 0.0);
+            double sensitivity = 0.0;
+
+            // Propagates the adjoint of a continuation value to the children and to the local rate.
+            auto propagate = [&](double weight, const double* values, std::vector<double>& target, int j) {
+                double continuation = discountFactor * (p_local * values[j + 1] + (1.0 - p_local) * values[j]);
+                sensitivity += weight * (-dt_local * continuation + discountFactor * dp_local * (values[j + 1] - values[j]));
+                target[j + 1] += weight * discountFactor * p_local;
+                target[j] += weight * discountFactor * (1.0 - p_local);
+            };
+
+            for (int j = 0; j <= i; ++j) {
+                int m = 2 * j - i;
+                if (isKnockIn) {
+                    double weight = lambda[j];
+                    double weightVanilla = lambdaVanilla[j];
+                    if (knocked(m)) {
+                        weightVanilla += weight;
+                        weight = 0.0;
+                    }
+                    double vanillaContinuation = discountFactor * (p_local * nextVanilla[j + 1] + (1.0 - p_local) * nextVanilla[j]);
+                    if (exercise && vanillaContinuation < intrinsicAt(m)) {
+                        weightVanilla = 0.0;
+                    }
+                    if (weightVanilla != 0.0) {
+                        propagate(weightVanilla, nextVanilla, nextLambdaVanilla, j);
+                    }
+                    if (weight != 0.0) {
+                        propagate(weight, next, nextLambda, j);
+                    }
+                }
+                else if (hasBarrier && knocked(m)) {
+                    continue;
+                }
+                else {
+                    double continuation = discountFactor * (p_local * next[j + 1] + (1.0 - p_local) * next[j]);
+                    if (exercise && continuation < intrinsicAt(m)) {
+                        continue;
+                    }
+                    propagate(lambda[j], next, nextLambda, j);
+                }
+            }
+            (*rateSensitivities)[i] = sensitivity;
+            lambda.swap(nextLambda);
+            lambdaVanilla.swap(nextLambdaVanilla);
+        }
     }
 
     return prices[0];
@@ -153,35 +473,16 @@ Greeks BinomialPricer::computeGreeks(const Option& opt) const {
 
     // --- Ajout de l'implmentation de Theta ---
     double dt_small = 1.0 / 365.0; // 1 jour en annes
-    PricingConfiguration config_time = config_;
-    config_time.maturity = config_.maturity - dt_small;
-    BinomialPricer pricer_time(config_time);
-    double price_T_down = pricer_time.price(opt);
+    Option opt_time = opt;
+    opt_time.setMaturity(config_->maturityOf(opt) - dt_small);
+    double price_T_down = price(opt_time);
     double theta = (basePrice - price_T_down) / dt_small;
 
     // --- Implmentation modifie de Rho ---
     double rStep = 0.001;
-    PricingConfiguration config_r_up = config_;
-    PricingConfiguration config_r_down = config_;
-
-    if (!config_.yieldCurve.getData().empty()) {
-        // Dcalage de tous les taux de la courbe pour reflter une variation uniforme
-        YieldCurve yc_up;
-        YieldCurve yc_down;
-        for (const auto& pt : config_.yieldCurve.getData()) {
-            yc_up.addRatePoint(pt.maturity, pt.rate + rStep);
-            yc_down.addRatePoint(pt.maturity, pt.rate - rStep);
-        }
-        config_r_up.yieldCurve = yc_up;
-        config_r_down.yieldCurve = yc_down;
-    }
-    else {
-        config_r_up.riskFreeRate = config_.riskFreeRate + rStep;
-        config_r_down.riskFreeRate = config_.riskFreeRate - rStep;
-    }
-
-    BinomialPricer pricer_r_up(config_r_up);
-    BinomialPricer pricer_r_down(config_r_down);
+    // The bumped pricers share the configuration and only shift the rates.
+    BinomialPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    BinomialPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
     double price_r_up = pricer_r_up.price(opt);
     double price_r_down = pricer_r_down.price(opt);
     double rho = (price_r_up - price_r_down) / (2 * rStep);
@@ -196,6 +497,237 @@ Greeks BinomialPricer::computeGreeks(const Option& opt) const {
     return g;
 }
 
+/**
+ * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+ *
+ * The derivatives of the price with respect to the local rate of every level come from the adjoint
+ * sweep of rollBack(), gathered during a single pricing, and are mapped onto the curve points with
+ * the interpolation weights. Their sum is the parallel-shift rho of the curve.
+ *
+ * @param opt The option to evaluate.
+ * @return The derivative of the price with respect to the rate of each curve point (empty if the
+ *         yield curve is empty).
+ */
+std::vector<double> BinomialPricer::computeKeyRateRho(const Option& opt) const {
+    std::vector<double> keyRateRho(config_->yieldCurve.getData().size(), 0.0);
+    if (keyRateRho.empty()) {
+        return keyRateRho;
+    }
+    std::vector<double> rateTimes;
+    std::vector<double> rateSensitivities;
+    rollBack(opt, &rateTimes, &rateSensitivities);
+    config_->yieldCurve.addPointSensitivities(rateTimes.data(), rateSensitivities.data(), rateTimes.size(),
+        keyRateRho.data());
+    return keyRateRho;
+}
+
+/**
+ * @brief Buffers of one thread pricing a batch, reused from one option to the next.
+ *
+ * The powers of u depend only on the volatility and the step, and the growth factors
+ * exp((r - q) dt) only on the levels and the dividend, so they are recomputed only when these change.
+ */
+struct BinomialPricer::Workspace {
+    const Levels* powerLevels = nullptr;   ///< Levels of the powers (null: no powers yet).
+    double u = 0.0;                         ///< Up factor of the powers.
+    std::vector<double> powers;             ///< u^m for m in [-N, N].
+    const Levels* growthLevels = nullptr;   ///< Levels of the growth factors (null: none yet).
+    double q = 0.0;                         ///< Dividend of the growth factors.
+    std::vector<double> growth;             ///< exp((rate - q) dt) for each level.
+    std::vector<double> spot;               ///< Underlying price on each lattice position.
+    std::vector<double> prices;             ///< Values of the current level.
+};
+
+/**
+ * @brief Sets up the levels of the tree of a configuration for one maturity.
+ *
+ * @param config The configuration (number of steps, rates).
+ * @param rateShift Shift added to the local rates of the yield curve (see PricingBump).
+ * @param maturity The maturity of the tree.
+ * @return The levels, with the local rate and the discount factor of each one.
+ */
+BinomialPricer::Levels BinomialPricer::makeLevels(const PricingConfiguration& config, double rateShift, double maturity) {
+    Levels levels;
+    levels.steps = config.binomialSteps;
+    levels.dt = maturity / levels.steps;
+    levels.riskFreeRate = config.riskFreeRate;
+    levels.rates.resize(levels.steps);
+    levels.discounts.resize(levels.steps);
+    for (int i = 0; i < levels.steps; ++i) {
+        double t_norm = static_cast<double>(i) / levels.steps;
+        levels.rates[i] = config.yieldCurve.getRate(t_norm) + rateShift;
+        levels.discounts[i] = std::exp(-levels.rates[i] * levels.dt);
+    }
+    return levels;
+}
+
+/**
+ * @brief Rolls back the tree of a vanilla option on precomputed levels.
+ *
+ * The operations are those of rollBack() for an option without barrier, so the price is the same;
+ * only the terms that do not depend on the option (local rates and discount factors) or that are
+ * shared with the previous option of the thread (powers of u, growth factors) are not recomputed.
+ *
+ * @return The computed option price.
+ * @throw std::runtime_error if the risk-neutral probability is not in [0, 1].
+ */
+double BinomialPricer::rollBackVanilla(const Levels& levels, double S, double K, double sigma, double q,
+    bool isCall, bool isAmerican, Workspace& workspace) {
+    const int N = levels.steps;
+    const double dt = levels.dt;
+    double u = std::exp(sigma * std::sqrt(dt));
+    double d = 1.0 / u;
+    double p = (std::exp((levels.riskFreeRate - q) * dt) - d) / (u - d);
+    if (p < 0.0 || p > 1.0) {
+        throw std::runtime_error("Invalid risk-neutral probability in the binomial model.");
+    }
+
+    if (workspace.powerLevels != &levels || workspace.u != u) {
+        workspace.powers.resize(2 * N + 1);
+        for (int m = -N; m <= N; ++m) {
+            workspace.powers[m + N] = std::pow(u, m);
+        }
+        workspace.powerLevels = &levels;
+        workspace.u = u;
+    }
+    if (workspace.growthLevels != &levels || workspace.q != q) {
+        workspace.growth.resize(N);
+        for (int i = 0; i < N; ++i) {
+            workspace.growth[i] = std::exp((levels.rates[i] - q) * dt);
+        }
+        workspace.growthLevels = &levels;
+        workspace.q = q;
+    }
+
+    std::vector<double>& spot = workspace.spot;
+    spot.resize(2 * N + 1);
+    for (int m = 0; m <= 2 * N; ++m) {
+        spot[m] = S * workspace.powers[m];
+    }
+    auto intrinsicAt = [&](int m) {
+        return isCall ? std::max(spot[m + N] - K, 0.0) : std::max(K - spot[m + N], 0.0);
+    };
+
+    std::vector<double>& prices = workspace.prices;
+    prices.resize(N + 1);
+    for (int j = 0; j <= N; ++j) {
+        prices[j] = intrinsicAt(2 * j - N);
+    }
+    for (int i = N - 1; i >= 0; --i) {
+        double discountFactor = levels.discounts[i];
+        double p_local = (workspace.growth[i] - d) / (u - d);
+        if (isAmerican) {
+            for (int j = 0; j <= i; ++j) {
+                double continuation = discountFactor * (p_local * prices[j + 1] + (1.0 - p_local) * prices[j]);
+                prices[j] = std::max(continuation, intrinsicAt(2 * j - i));
+            }
+        }
+        else {
+            for (int j = 0; j <= i; ++j) {
+                prices[j] = discountFactor * (p_local * prices[j + 1] + (1.0 - p_local) * prices[j]);
+            }
+        }
+    }
+    return prices[0];
+}
+
+/**
+ * @brief Computes the prices of a batch of options with the binomial CRR model.
+ *
+ * The options are grouped by maturity: the levels of one tree are set up per distinct maturity,
+ * before the options are distributed over the threads.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ */
+void BinomialPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    std::map<double, Levels> levels;
+    for (size_t i = 0; i < count; ++i) {
+        double T = options.maturity(i);
+        if (levels.find(T) == levels.end()) {
+            levels.emplace(T, makeLevels(*config_, bump_.rateShift, T));
+        }
+    }
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 8);
+    std::vector<Workspace> workspaces(threads);
+    parallelFor(count, 8, threads, [&](int thread, size_t begin, size_t end) {
+        Workspace& workspace = workspaces[thread];
+        for (size_t i = begin; i < end; ++i) {
+            prices[i] = rollBackVanilla(levels.at(options.maturity(i)), options.spot(i), options.strike(i),
+                options.volatility(i), options.dividend(i), !options.isPut(i), options.isAmerican(i), workspace);
+        }
+    });
+}
+
+/**
+ * @brief Computes the Greeks of a batch of options with the finite differences of computeGreeks().
+ *
+ * For every distinct maturity, the four trees of computeGreeks() (base, maturity shifted by one day,
+ * rates shifted up and down) are set up once; each option then needs eight roll-backs.
+ *
+ * @param options The options to evaluate.
+ * @param greeks Receives options.size() Greeks structures.
+ */
+void BinomialPricer::computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    const double volStep = 0.01;
+    const double dt_small = 1.0 / 365.0;
+    const double rStep = 0.001;
+
+    struct GreekLevels {
+        Levels base, timeDown, rateUp, rateDown;
+    };
+    std::map<double, GreekLevels> levels;
+    for (size_t i = 0; i < count; ++i) {
+        double T = options.maturity(i);
+        if (levels.find(T) == levels.end()) {
+            levels.emplace(T, GreekLevels{ makeLevels(*config_, bump_.rateShift, T),
+                makeLevels(*config_, bump_.rateShift, T - dt_small),
+                makeLevels(*config_, bump_.rateShift + rStep, T), makeLevels(*config_, bump_.rateShift - rStep, T) });
+        }
+    }
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 2);
+    std::vector<Workspace> workspaces(threads);
+    parallelFor(count, 2, threads, [&](int thread, size_t begin, size_t end) {
+        Workspace& workspace = workspaces[thread];
+        for (size_t i = begin; i < end; ++i) {
+            const GreekLevels& trees = levels.at(options.maturity(i));
+            double S = options.spot(i);
+            double K = options.strike(i);
+            double sigma = options.volatility(i);
+            double q = options.dividend(i);
+            bool isCall = !options.isPut(i);
+            bool isAmerican = options.isAmerican(i);
+            double h = 0.01 * S;
+
+            double price_up = rollBackVanilla(trees.base, S + h, K, sigma, q, isCall, isAmerican, workspace);
+            double price_down = rollBackVanilla(trees.base, S - h, K, sigma, q, isCall, isAmerican, workspace);
+            double basePrice = rollBackVanilla(trees.base, S, K, sigma, q, isCall, isAmerican, workspace);
+            double vol_up = rollBackVanilla(trees.base, S, K, sigma + volStep, q, isCall, isAmerican, workspace);
+            double vol_down = rollBackVanilla(trees.base, S, K, sigma - volStep, q, isCall, isAmerican, workspace);
+            double price_T_down = rollBackVanilla(trees.timeDown, S, K, sigma, q, isCall, isAmerican, workspace);
+            double price_r_up = rollBackVanilla(trees.rateUp, S, K, sigma, q, isCall, isAmerican, workspace);
+            double price_r_down = rollBackVanilla(trees.rateDown, S, K, sigma, q, isCall, isAmerican, workspace);
+
+            Greeks& g = greeks[i];
+            g.delta = (price_up - price_down) / (2 * h);
+            g.gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+            g.vega = (vol_up - vol_down) / (2 * volStep);
+            g.theta = (basePrice - price_T_down) / dt_small;
+            g.rho = (price_r_up - price_r_down) / (2 * rStep);
+        }
+    });
+}
+
 /**
  * @brief Sets the pricing configuration.
  *
@@ -204,14 +736,14 @@ Greeks BinomialPricer::computeGreeks(const Option& opt) const {
  * @param config A PricingConfiguration object containing the new parameters.
  */
 void BinomialPricer::setConfiguration(const PricingConfiguration& config) {
-    config_ = config;
+    config_ = std::make_shared<const PricingConfiguration>(config);
 }
 
 /**
  * @brief Gets the current pricing configuration.
  *
- * @return The current PricingConfiguration object.
+ * @return The current PricingConfiguration object (without the bump overlay).
  */
 PricingConfiguration BinomialPricer::getConfiguration() const {
-    return config_;
+    return *config_;
 }
@@ -20,6 +20,8 @@
 #include "pch.h"
 #include "InterfaceOptionPricer.hpp"
 #include "PricingConfiguration.hpp"
+#include <memory>
+#include <vector>
 
 class BinomialPricer : public IOptionPricer {
 public:
@@ -38,6 +40,16 @@ public:
      */
     BinomialPricer(const PricingConfiguration& config);
 
+    /**
+     * @brief Constructor sharing a configuration, with an optional bump overlay.
+     *
+     * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+     *
+     * @param config The shared configuration (not null).
+     * @param bump The overlay applied on top of the configuration.
+     */
+    BinomialPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
     /**
      * @brief Destructor.
      */
@@ -65,10 +77,47 @@ public:
      */
     virtual Greeks computeGreeks(const Option& opt) const override;
 
+    /**
+     * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+     *
+     * The sensitivities to the local rates are obtained by an adjoint sweep of the tree during a
+     * single pricing, so the cost does not depend on the number of curve points.
+     *
+     * @param opt The option to evaluate.
+     * @return The derivative of the price with respect to the rate of each curve point (empty if
+     *         the yield curve is empty).
+     */
+    std::vector<double> computeKeyRateRho(const Option& opt) const;
+
+    /**
+     * @brief Computes the prices of a batch of options.
+     *
+     * Each option is priced at its maturity in the batch. The local rates and discount factors of the
+     * tree levels are computed once per distinct maturity, the powers of u are shared by consecutive
+     * options with the same volatility and maturity, and the options are distributed over
+     * config.batchThreads threads. The prices are identical to those of price().
+     *
+     * @param options The options to be priced.
+     * @param prices Receives options.size() prices.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const override;
+
+    /**
+     * @brief Computes the Greeks of a batch of options, with the finite differences of computeGreeks().
+     *
+     * The trees of the shifted maturity and of the shifted rates are set up once per distinct
+     * maturity, instead of once per option.
+     *
+     * @param options The options to evaluate.
+     * @param greeks Receives options.size() Greeks structures.
+     */
+    virtual void computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const override;
+
     /**
      * @brief Sets the pricing configuration.
      *
-     * Allows updating the configuration parameters used by the BinomialPricer.
+     * Allows updating the configuration parameters used by the BinomialPricer. The pricer then
+     * holds its own copy; pricers sharing the previous configuration are not affected.
      *
      * @param config A PricingConfiguration structure containing the new parameters.
      */
@@ -77,12 +126,49 @@ public:
     /**
      * @brief Gets the current pricing configuration.
      *
-     * @return The current PricingConfiguration structure.
+     * @return The current PricingConfiguration structure (without the bump overlay).
      */
     PricingConfiguration getConfiguration() const;
 
 private:
-    PricingConfiguration config_; ///< Additional configuration parameters for the Binomial model.
+    /**
+     * @brief Rolls back the tree, optionally returning the sensitivities to the local rates.
+     *
+     * @param opt The option to be priced.
+     * @param rateTimes If not null, receives the normalized times at which the local rates are read.
+     * @param rateSensitivities If not null, receives the derivative of the price with respect to each local rate.
+     * @return The computed option price.
+     */
+    double rollBack(const Option& opt, std::vector<double>* rateTimes, std::vector<double>* rateSensitivities) const;
+
+    /**
+     * @brief Levels of a vanilla tree: they depend on the configuration only.
+     */
+    struct Levels {
+        int steps;                      ///< Number of steps N.
+        double dt;                      ///< Step T / N.
+        double riskFreeRate;            ///< Constant rate of the risk-neutral probability check.
+        std::vector<double> rates;      ///< Local rate of each level (read on the yield curve).
+        std::vector<double> discounts;  ///< exp(-rate dt) for each level.
+    };
+
+    /// Buffers of one thread pricing a batch.
+    struct Workspace;
+
+    /**
+     * @brief Sets up the levels of the tree of a configuration for one maturity.
+     */
+    static Levels makeLevels(const PricingConfiguration& config, double rateShift, double maturity);
+
+    /**
+     * @brief Rolls back the tree of a vanilla (European or American) option on precomputed levels,
+     *        with the same operations as rollBack().
+     */
+    static double rollBackVanilla(const Levels& levels, double S, double K, double sigma, double q,
+        bool isCall, bool isAmerican, Workspace& workspace);
+
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the Binomial model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
 };
 
 #endif // BINOMIALPRICER_HPP
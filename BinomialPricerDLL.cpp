@@ -1,12 +1,17 @@
 #include "pch.h"
 #include "BinomialPricerDLL.hpp"
 #include "BinomialPricer.hpp"     // Doit contenir la dclaration de la classe BinomialPricer
+#include "PricerFactory.hpp"
 #include "Option.hpp"
 #include "PricingConfiguration.hpp"
+#include "BatchPricing.hpp"
 #include "DateConverter.hpp"
+#include "YieldCurveCache.hpp"
 #include <stdexcept>
 #include <cstring>
 #include <cmath>
+#include <vector>
+#include <memory>
 
 extern "C" {
 
@@ -23,21 +28,22 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
-            // Recharger la yield curve  chaque appel (chemin  adapter si ncessaire)
-            config.yieldCurve.loadFromFile("C:\\Users\\shaki\\OneDrive\\Bureau\\YieldCurveData.txt");
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
 
             // Spcifique au modle binomial : nombre d'tapes de l'arbre.
             config.binomialSteps = binomialSteps;
 
-            BinomialPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::Binomial, config);
 
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            // La maturit est donne  l'option : les appels qui ne diffrent que par la maturit partagent un moteur du pool.
+            opt.setMaturity(T);
 
-            double price = pricer.price(opt);
+            double price = pricer->price(opt);
             return price;
         }
         catch (const std::exception& ex) {
@@ -58,20 +64,20 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
-            // Recharge la yield curve  chaque appel (chemin  adapter)
-            config.yieldCurve.loadFromFile("C:\\Users\\shaki\\OneDrive\\Bureau\\YieldCurveData.txt");
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
 
             config.binomialSteps = binomialSteps;
 
-            BinomialPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::Binomial, config);
 
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            opt.setMaturity(T);
 
-            Greeks g = pricer.computeGreeks(opt);
+            Greeks g = pricer->computeGreeks(opt);
             if (delta) *delta = g.delta;
             if (gamma) *gamma = g.gamma;
             if (vega)  *vega = g.vega;
@@ -87,4 +93,71 @@ extern "C" {
         }
     }
 
+    int __stdcall ComputeOptionKeyRateRhoBinomial(
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps,
+        double* keyRateRho, int capacity)
+    {
+        try {
+            PricingConfiguration config;
+            if (calculationDate == nullptr || strlen(calculationDate) == 0)
+                config.calculationDate = DateConverter::getTodayDate();
+            else
+                config.calculationDate = calculationDate;
+
+            config.riskFreeRate = r;
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+
+            config.binomialSteps = binomialSteps;
+
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::Binomial, config);
+
+            Option opt(S, K, sigma, q,
+                (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
+                (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            opt.setMaturity(T);
+
+            std::vector<double> rho = static_cast<const BinomialPricer&>(*pricer).computeKeyRateRho(opt);
+            for (int i = 0; i < capacity && i < static_cast<int>(rho.size()); ++i) {
+                keyRateRho[i] = rho[i];
+            }
+            return static_cast<int>(rho.size());
+        }
+        catch (const std::exception& ex) {
+            return -1;
+        }
+    }
+
+    int __stdcall PriceOptionBinomialBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int binomialSteps,
+        double* prices)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        // Champs propres au modle : courbe des taux partage par le processus et discrtisation.
+        return priceBatchExport(PricerType::Binomial, inputs, [binomialSteps](PricingConfiguration& config) {
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.binomialSteps = binomialSteps;
+        }, prices);
+    }
+
+    int __stdcall ComputeOptionGreeksBinomialBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int binomialSteps,
+        double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        // Champs propres au modle : courbe des taux partage par le processus et discrtisation.
+        return computeGreeksBatchExport(PricerType::Binomial, inputs, [binomialSteps](PricingConfiguration& config) {
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.binomialSteps = binomialSteps;
+        }, delta, gamma, vega, theta, rho);
+    }
+
 } // extern "C"
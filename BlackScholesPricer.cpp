@@ -10,6 +10,7 @@
 #include "pch.h"
 #include "BlackScholesPricer.hpp"
 #include "Option.hpp"
+#include "OptionBatch.hpp"
 #include "DateConverter.hpp"  // For date conversion functions
 #include <cmath>
 #include <stdexcept>
@@ -47,7 +48,9 @@ static double norm_pdf(double x) {
  *
  * Initializes the pricer using default configuration parameters.
  */
-BlackScholesPricer::BlackScholesPricer() {
+BlackScholesPricer::BlackScholesPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
     // Default constructor; no explicit configuration provided.
 }
 
@@ -61,11 +64,24 @@ BlackScholesPricer::BlackScholesPricer() {
  * @param config A PricingConfiguration object containing custom parameters.
  */
 BlackScholesPricer::BlackScholesPricer(const PricingConfiguration& config)
-    : config_(config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
 {
     // Configuration parameters are now stored in config_
 }
 
+/**
+ * @brief Constructor sharing a configuration, with a bump overlay.
+ *
+ * The configuration is shared, not copied: the bumped pricers of computeGreeks() are built this way.
+ *
+ * @param config The shared configuration.
+ * @param bump The overlay applied on top of the configuration.
+ */
+BlackScholesPricer::BlackScholesPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
 /**
  * @brief Destructor for BlackScholesPricer.
  */
@@ -73,6 +89,21 @@ BlackScholesPricer::~BlackScholesPricer() {
     // No dynamic cleanup required.
 }
 
+/**
+ * @brief Returns the time elapsed since the calculation date.
+ *
+ * @return The number of years between the calculation date and today, or 0 if no calculation date
+ *         is provided.
+ */
+double BlackScholesPricer::calculationDateOffset() const {
+    if (config_->calculationDate.empty()) {
+        return 0.0;
+    }
+    auto calcDate = DateConverter::parseDate(config_->calculationDate);
+    auto today = std::chrono::system_clock::now();
+    return DateConverter::yearsBetween(calcDate, today);
+}
+
 /**
  * @brief Computes the option price using the Black-Scholes formula.
  *
@@ -84,30 +115,26 @@ BlackScholesPricer::~BlackScholesPricer() {
  *
  * @param opt The option to be priced.
  * @return The computed option price.
- * @throw std::runtime_error if the option is not European.
+ * @throw std::runtime_error if the option is not a vanilla European option.
  */
 double BlackScholesPricer::price(const Option& opt) const {
     if (opt.getOptionStyle() != Option::OptionStyle::European) {
         throw std::runtime_error("BlackScholesPricer supports only European options.");
     }
+    if (opt.getBarrierType() != Option::BarrierType::None) {
+        throw std::runtime_error("BlackScholesPricer does not support barrier options.");
+    }
 
     double S = opt.getUnderlying();      // Underlying price
     double K = opt.getStrike();          // Strike price
     double sigma = opt.getVolatility();  // Volatility
     double q = opt.getDividend();        // Continuous dividend yield
 
-    // Retrieve maturity and default risk-free rate from configuration.
-    double T = config_.maturity;
-    double r_default = config_.riskFreeRate;
+    // Retrieve the default risk-free rate from configuration.
+    double r_default = config_->riskFreeRate + bump_.rateShift;
 
     // Adjust effective time to maturity using the calculation date if provided.
-    double T_effective = T;
-    if (!config_.calculationDate.empty()) {
-        auto calcDate = DateConverter::parseDate(config_.calculationDate);
-        auto today = std::chrono::system_clock::now();
-        double offset = DateConverter::yearsBetween(calcDate, today);
-        T_effective = T - offset;
-    }
+    double T_effective = config_->maturityOf(opt) - calculationDateOffset();
 
     // Determine effective risk-free rate using the yield curve if available.
     double effective_r = r_default;
@@ -139,29 +166,25 @@ double BlackScholesPricer::price(const Option& opt) const {
  *
  * @param opt The option to evaluate.
  * @return A Greeks structure containing the calculated values.
- * @throw std::runtime_error if the option is not European.
+ * @throw std::runtime_error if the option is not a vanilla European option.
  */
 Greeks BlackScholesPricer::computeGreeks(const Option& opt) const {
     if (opt.getOptionStyle() != Option::OptionStyle::European) {
         throw std::runtime_error("BlackScholesPricer supports only European options.");
     }
+    if (opt.getBarrierType() != Option::BarrierType::None) {
+        throw std::runtime_error("BlackScholesPricer does not support barrier options.");
+    }
 
     double S = opt.getUnderlying();
     double K = opt.getStrike();
     double sigma = opt.getVolatility();
     double q = opt.getDividend();
 
-    double T = config_.maturity;
-    double r_default = config_.riskFreeRate;
+    double r_default = config_->riskFreeRate + bump_.rateShift;
 
     // Adjust effective time to maturity using the calculation date if provided.
-    double T_effective = T;
-    if (!config_.calculationDate.empty()) {
-        auto calcDate = DateConverter::parseDate(config_.calculationDate);
-        auto today = std::chrono::system_clock::now();
-        double offset = DateConverter::yearsBetween(calcDate, today);
-        T_effective = T - offset;
-    }
+    double T_effective = config_->maturityOf(opt) - calculationDateOffset();
 
     // Determine effective risk-free rate using the yield curve if available.
     double effective_r = r_default;
@@ -202,3 +225,122 @@ Greeks BlackScholesPricer::computeGreeks(const Option& opt) const {
 
     return greeks;
 }
+
+/**
+ * @brief Computes the prices of a batch of options using the Black-Scholes formula.
+ *
+ * Each option is priced at its maturity in the batch. The calculation date is parsed once for the
+ * batch, and the square root of the effective maturity and the discount factor exp(-r T) are only
+ * recomputed when the maturity changes, so that a batch sorted by expiry computes them once per
+ * expiry instead of once per option. The put and call formulas are merged with the sign w = +1 (call) or
+ * -1 (put):
+ *
+ *    price = w (S exp(-q T) N(w d1) - K exp(-r T) N(w d2)),
+ *
+ * which gives the same values as the two formulas of price(), and leaves no branch in the loop.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ * @throw std::runtime_error if an option is not European.
+ */
+void BlackScholesPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    if (!options.allEuropean()) {
+        throw std::runtime_error("BlackScholesPricer supports only European options.");
+    }
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+
+    const double offset = calculationDateOffset();
+    const double effective_r = config_->riskFreeRate + bump_.rateShift;
+    double T = options.maturity(0);
+    double T_effective = T - offset;
+    double sqrtT = std::sqrt(T_effective);
+    double discount = std::exp(-effective_r * T_effective);
+
+    const double* spot = options.spots();
+    const double* strike = options.strikes();
+    const double* volatility = options.volatilities();
+    const double* dividend = options.dividends();
+    const double* maturity = options.maturities();
+    for (size_t i = 0; i < count; ++i) {
+        if (maturity[i] != T) {
+            T = maturity[i];
+            T_effective = T - offset;
+            sqrtT = std::sqrt(T_effective);
+            discount = std::exp(-effective_r * T_effective);
+        }
+        double S = spot[i];
+        double K = strike[i];
+        double sigma = volatility[i];
+        double q = dividend[i];
+        double w = options.isPut(i) ? -1.0 : 1.0;
+
+        double d1 = (std::log(S / K) + (effective_r - q + 0.5 * sigma * sigma) * T_effective) / (sigma * sqrtT);
+        double d2 = d1 - sigma * sqrtT;
+        prices[i] = w * (S * std::exp(-q * T_effective) * norm_cdf(w * d1) - K * discount * norm_cdf(w * d2));
+    }
+}
+
+/**
+ * @brief Computes the Greeks of a batch of options using the Black-Scholes model.
+ *
+ * Same shared terms and merged put and call formulas as priceBatch(); the values are those of
+ * computeGreeks().
+ *
+ * @param options The options to evaluate.
+ * @param greeks Receives options.size() Greeks structures.
+ * @throw std::runtime_error if an option is not European.
+ */
+void BlackScholesPricer::computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const {
+    if (!options.allEuropean()) {
+        throw std::runtime_error("BlackScholesPricer supports only European options.");
+    }
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+
+    const double offset = calculationDateOffset();
+    const double effective_r = config_->riskFreeRate + bump_.rateShift;
+    double T = options.maturity(0);
+    double T_effective = T - offset;
+    double sqrtT = std::sqrt(T_effective);
+    double discount = std::exp(-effective_r * T_effective);
+
+    const double* spot = options.spots();
+    const double* strike = options.strikes();
+    const double* volatility = options.volatilities();
+    const double* dividend = options.dividends();
+    const double* maturity = options.maturities();
+    for (size_t i = 0; i < count; ++i) {
+        if (maturity[i] != T) {
+            T = maturity[i];
+            T_effective = T - offset;
+            sqrtT = std::sqrt(T_effective);
+            discount = std::exp(-effective_r * T_effective);
+        }
+        double S = spot[i];
+        double K = strike[i];
+        double sigma = volatility[i];
+        double q = dividend[i];
+        double w = options.isPut(i) ? -1.0 : 1.0;
+
+        double d1 = (std::log(S / K) + (effective_r - q + 0.5 * sigma * sigma) * T_effective) / (sigma * sqrtT);
+        double d2 = d1 - sigma * sqrtT;
+        double dividendDiscount = std::exp(-q * T_effective);
+        double density = norm_pdf(d1);
+        double Nd1 = norm_cdf(w * d1);
+        double Nd2 = norm_cdf(w * d2);
+
+        Greeks& g = greeks[i];
+        g.delta = w * dividendDiscount * Nd1;
+        g.gamma = dividendDiscount * density / (S * sigma * sqrtT);
+        g.vega = S * dividendDiscount * density * sqrtT;
+        g.theta = -(-(S * sigma * dividendDiscount * density) / (2 * sqrtT)
+            - w * (effective_r * K * discount * Nd2)
+            + w * (q * S * dividendDiscount * Nd1));
+        g.rho = w * K * T_effective * discount * Nd2;
+    }
+}
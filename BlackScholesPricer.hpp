@@ -12,6 +12,7 @@
 #include "pch.h"
 #include "InterfaceOptionPricer.hpp"
 #include "PricingConfiguration.hpp"
+#include <memory>
 
  /**
   * @brief Class that implements the Black-Scholes pricing model.
@@ -34,6 +35,16 @@ public:
      */
     BlackScholesPricer(const PricingConfiguration& config);
 
+    /**
+     * @brief Constructor sharing a configuration, with an optional bump overlay.
+     *
+     * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+     *
+     * @param config The shared configuration (not null).
+     * @param bump The overlay applied on top of the configuration.
+     */
+    BlackScholesPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
     /**
      * @brief Destructor.
      */
@@ -43,12 +54,12 @@ public:
      * @brief Computes the price of the option using the Black-Scholes formula.
      *
      * This method calculates the price of a European option using the Black-Scholes formula.
-     * The calculation uses the option parameters and the configuration parameters (maturity
-     * and risk-free rate).
+     * The calculation uses the option parameters and the configuration parameters (maturity,
+     * unless the option has its own, and risk-free rate).
      *
      * @param opt The option to be priced.
      * @return The computed option price.
-     * @throw std::runtime_error if the option is not European.
+     * @throw std::runtime_error if the option is not a vanilla European option.
      */
     virtual double price(const Option& opt) const override;
 
@@ -62,17 +73,46 @@ public:
      * - Theta: sensitivity with respect to time.
      * - Rho: sensitivity with respect to the risk-free rate.
      *
-     * The classical Black-Scholes formulas are used, with maturity and risk-free rate
-     * taken from the configuration.
+     * The classical Black-Scholes formulas are used, with the maturity of the option (see
+     * PricingConfiguration::maturityOf()) and the risk-free rate of the configuration.
      *
      * @param opt The option to evaluate.
      * @return A Greeks structure containing the calculated values.
-     * @throw std::runtime_error if the option is not European.
+     * @throw std::runtime_error if the option is not a vanilla European option.
      */
     virtual Greeks computeGreeks(const Option& opt) const override;
 
+    /**
+     * @brief Computes the prices of a batch of options.
+     *
+     * Each option is priced at its maturity in the batch; the effective maturity and the discount
+     * factor are computed once per run of options with the same maturity, and the options are priced in a single branch-free loop over the columns of the batch. The prices are
+     * identical to those of price().
+     *
+     * @param options The options to be priced.
+     * @param prices Receives options.size() prices.
+     * @throw std::runtime_error if an option is not European.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const override;
+
+    /**
+     * @brief Computes the Greeks of a batch of options, as priceBatch() does for the prices.
+     *
+     * @param options The options to evaluate.
+     * @param greeks Receives options.size() Greeks structures.
+     * @throw std::runtime_error if an option is not European.
+     */
+    virtual void computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const override;
+
 private:
-    PricingConfiguration config_; ///< Additional configuration parameters for the Black-Scholes model.
+    /**
+     * @brief Returns the time elapsed since the calculation date (0 if there is none), which is
+     *        subtracted from the maturity of each option.
+     */
+    double calculationDateOffset() const;
+
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the Black-Scholes model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
 };
 
 #endif // BLACKSCHOLESPRICER_HPP
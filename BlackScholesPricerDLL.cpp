@@ -1,12 +1,16 @@
 #include "pch.h"
 #include "BlackScholesPricerDLL.hpp"
 #include "BlackScholesPricer.hpp"
+#include "PricerFactory.hpp"
 #include "Option.hpp"
 #include "PricingConfiguration.hpp"
+#include "BatchPricing.hpp"
 #include "DateConverter.hpp"
 #include <stdexcept>
 #include <cstring>
 #include <cmath>
+#include <vector>
+#include <memory>
 
 extern "C" {
     // Parameters:
@@ -30,18 +34,19 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
 
-            BlackScholesPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::BlackScholes, config);
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            // The maturity is set on the option: the calls that differ only by the maturity share a pooled engine.
+            opt.setMaturity(T);
 
             if (opt.getOptionStyle() != Option::OptionStyle::European)
                 throw std::runtime_error("BlackScholesPricer supports only European options.");
 
-            return pricer.price(opt);
+            return pricer->price(opt);
         }
         catch (const std::exception& ex) {
             return -1.0;
@@ -62,18 +67,18 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
 
-            BlackScholesPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::BlackScholes, config);
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            opt.setMaturity(T);
 
             if (opt.getOptionStyle() != Option::OptionStyle::European)
                 throw std::runtime_error("BlackScholesPricer supports only European options.");
 
-            Greeks g = pricer.computeGreeks(opt);
+            Greeks g = pricer->computeGreeks(opt);
             if (delta) *delta = g.delta;
             if (gamma) *gamma = g.gamma;
             if (vega)  *vega = g.vega;
@@ -89,4 +94,25 @@ extern "C" {
         }
     }
 
+    int __stdcall PriceOptionBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        double* prices)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        return priceBatchExport(PricerType::BlackScholes, inputs, [](PricingConfiguration&) {}, prices);
+    }
+
+    int __stdcall ComputeOptionGreeksBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        return computeGreeksBatchExport(PricerType::BlackScholes, inputs, [](PricingConfiguration&) {},
+            delta, gamma, vega, theta, rho);
+    }
+
 } // extern "C"
@@ -22,6 +22,26 @@ extern "C" {
         int optionType, int optionStyle, const char* calculationDate,
         double* delta, double* gamma, double* vega, double* theta, double* rho);
 
+    // Batch version of PriceOption, to price a whole range in one call.
+    // The inputs S to optionStyle are arrays of count values (one per option); the calculation date
+    // and the model parameters are shared by all the options. The price of option i is written to
+    // prices[i] (-1 if this option fails). Returns the number of options priced without error, or -1
+    // if the arguments are invalid.
+    BLACK_SCHOLES_API int __stdcall PriceOptionBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        double* prices);
+
+    // Batch version of ComputeOptionGreeks. The Greeks of option i are written at index i of the
+    // arrays provided (a null array is skipped; NAN if this option fails).
+    // Returns the number of options computed without error, or -1 if the arguments are invalid.
+    BLACK_SCHOLES_API int __stdcall ComputeOptionGreeksBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        double* delta, double* gamma, double* vega, double* theta, double* rho);
+
 }
 
 #endif // BLACK_SCHOLES_PRICER_DLL_HPP
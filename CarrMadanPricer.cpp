@@ -0,0 +1,285 @@
+/**
+ * @file CarrMadanPricer.cpp
+ * @brief Implementation of the CarrMadanPricer class (Carr-Madan FFT method).
+ *
+ * The call price damped by exp(alpha k), k = ln K, is square integrable and its Fourier transform is
+ *
+ *    psi(v) = exp(-r T) phi(v - (alpha + 1) i) / (alpha^2 + alpha - v^2 + i (2 alpha + 1) v),
+ *
+ * where phi is the characteristic function of ln S_T. The call prices are recovered on the grid
+ * k_m = ln S_0 - b + lambda m, m = 0..N-1, by
+ *
+ *    C(k_m) = exp(-alpha k_m) / pi * Re[sum_j exp(-2 i pi j m / N) exp(i b v_j) psi(v_j) eta w_j],
+ *
+ * with v_j = eta j, lambda eta = 2 pi / N, b = N lambda / 2 and the Simpson weights w_j. The sum is a
+ * single forward FFT. Prices at the requested strikes are interpolated with a natural cubic spline
+ * in log-strike, built only on the part of the grid that covers the strikes. Puts are obtained by
+ * put-call parity.
+ */
+
+#include "pch.h"
+#include "CarrMadanPricer.hpp"
+#include "Option.hpp"
+#include "OptionBatch.hpp"
+#include "DateConverter.hpp"
+#include "CharacteristicFunction.hpp"
+#include "FourierTransform.hpp"
+#include "TridiagonalSolver.hpp"
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846 // Definition of the constant PI
+#endif
+
+/// Default constructor, using default configuration values.
+CarrMadanPricer::CarrMadanPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
+    // No additional initialization required.
+}
+
+/// Constructor with pricing configuration.
+CarrMadanPricer::CarrMadanPricer(const PricingConfiguration& config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
+{
+    // The configuration parameters are now stored in config_.
+}
+
+/// Constructor sharing a configuration, with a bump overlay.
+CarrMadanPricer::CarrMadanPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
+/// Destructor.
+CarrMadanPricer::~CarrMadanPricer() {
+    // No dynamic cleanup is required.
+}
+
+/**
+ * @brief Computes the option price with the Carr-Madan method.
+ * @param opt The option to be priced.
+ * @return The computed option price.
+ * @throw std::runtime_error if the option is not a vanilla European option, the strike is
+ *        outside the FFT grid or the parameters are inconsistent.
+ */
+double CarrMadanPricer::price(const Option& opt) const {
+    return priceStrikes(opt, std::vector<double>(1, opt.getStrike())).front();
+}
+
+/**
+ * @brief Computes the prices of a chain of European options with the Carr-Madan method.
+ *
+ * The effective time to maturity is adjusted by the calculation date as in the other pricers and
+ * riskFreeRate is used as a constant rate, as in the Black-Scholes pricer.
+ *
+ * @param opt The option providing every parameter but the strike.
+ * @param strikes The strikes of the chain.
+ * @return The prices, in the order of the strikes.
+ * @throw std::runtime_error if the option is not a vanilla European option, a strike is
+ *        outside the FFT grid or the parameters are inconsistent.
+ */
+std::vector<double> CarrMadanPricer::priceStrikes(const Option& opt, const std::vector<double>& strikes) const {
+    if (opt.getOptionStyle() != Option::OptionStyle::European || opt.getBarrierType() != Option::BarrierType::None) {
+        throw std::runtime_error("CarrMadanPricer supports only vanilla European options.");
+    }
+
+    double S0 = opt.getUnderlying();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+    bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+
+    double T = config_->maturityOf(opt);
+    double r = config_->riskFreeRate + bump_.rateShift;
+
+    // Adjust effective time to maturity using calculationDate if provided.
+    double T_effective = T;
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
+        auto today = std::chrono::system_clock::now();
+        double offset = DateConverter::yearsBetween(calcDate, today);
+        T_effective = T - offset;
+    }
+
+    const int N = config_->carrMadanPoints;
+    const double eta = config_->carrMadanSpacing;
+    const double alpha = config_->carrMadanDamping;
+    if (N < 4 || eta <= 0.0 || alpha <= 0.0) {
+        throw std::runtime_error("The Carr-Madan method requires at least 4 points, a positive spacing and a positive damping.");
+    }
+    if (strikes.empty()) {
+        return std::vector<double>();
+    }
+
+    // Log-strike grid, centered on ln S0.
+    const double lambda = 2.0 * M_PI / (N * eta);
+    const double b = 0.5 * N * lambda;
+    const double k0 = std::log(S0) - b;
+
+    // Locate the strikes on the grid; the spline only spans the nodes that surround them.
+    const int margin = 8;
+    std::vector<double> positions(strikes.size());
+    double lowest = static_cast<double>(N);
+    double highest = 0.0;
+    for (size_t s = 0; s < strikes.size(); ++s) {
+        if (strikes[s] <= 0.0) {
+            throw std::runtime_error("The strikes must be positive.");
+        }
+        positions[s] = (std::log(strikes[s]) - k0) / lambda;
+        if (positions[s] < 0.0 || positions[s] > N - 1) {
+            throw std::runtime_error("A strike lies outside the Carr-Madan log-strike grid.");
+        }
+        lowest = std::min(lowest, positions[s]);
+        highest = std::max(highest, positions[s]);
+    }
+    const int first = std::max(0, static_cast<int>(std::floor(lowest)) - margin);
+    const int last = std::min(N - 1, static_cast<int>(std::ceil(highest)) + margin);
+
+    // FFT of the damped transform.
+    CharacteristicFunction phi(*config_, sigma, r, q, T_effective);
+    const double discount = std::exp(-r * T_effective);
+    const std::complex<double> i(0.0, 1.0);
+    std::vector<std::complex<double>> data(N);
+    for (int j = 0; j < N; ++j) {
+        double v = eta * j;
+        double simpson = (j == 0) ? 1.0 / 3.0 : ((j % 2 == 1) ? 4.0 / 3.0 : 2.0 / 3.0);
+        std::complex<double> denominator(alpha * alpha + alpha - v * v, (2.0 * alpha + 1.0) * v);
+        std::complex<double> psi = discount * phi(std::complex<double>(v, -(alpha + 1.0))) / denominator;
+        data[j] = std::exp(i * (b * v)) * psi * eta * simpson;
+    }
+    fft(data, false);
+
+    // Call prices on the spline nodes. With k_m - ln S0 = lambda m - b, the factor
+    // exp(-alpha k_m) S0^(alpha + 1) of the transform is S0 exp(-alpha (lambda m - b)).
+    const int nodes = last - first + 1;
+    std::vector<double> calls(nodes);
+    for (int m = first; m <= last; ++m) {
+        calls[m - first] = S0 * std::exp(-alpha * (lambda * m - b)) / M_PI * data[m].real();
+    }
+
+    // Natural cubic spline: second derivatives on the interior nodes.
+    std::vector<double> curvature(nodes, 0.0);
+    if (nodes > 2) {
+        const int n = nodes - 2;
+        std::vector<double> a(n, 1.0), diag(n, 4.0), c(n, 1.0), d(n), x(n), c_prime(n), d_prime(n);
+        for (int m = 0; m < n; ++m) {
+            d[m] = 6.0 * (calls[m + 2] - 2.0 * calls[m + 1] + calls[m]) / (lambda * lambda);
+        }
+        solveTridiagonal(a, diag, c, d, x, c_prime, d_prime);
+        for (int m = 0; m < n; ++m) {
+            curvature[m + 1] = x[m];
+        }
+    }
+
+    const double forward = S0 * std::exp(-q * T_effective);
+    std::vector<double> prices(strikes.size());
+    for (size_t s = 0; s < strikes.size(); ++s) {
+        double position = positions[s] - first;
+        int m = std::min(static_cast<int>(position), nodes - 2);
+        double t = position - m;
+        double call = (1.0 - t) * calls[m] + t * calls[m + 1]
+            - lambda * lambda / 6.0 * t * (1.0 - t)
+            * ((2.0 - t) * curvature[m] + (1.0 + t) * curvature[m + 1]);
+        call = std::max(call, 0.0);
+        prices[s] = isCall ? call : std::max(call - forward + strikes[s] * discount, 0.0);
+    }
+    return prices;
+}
+
+/**
+ * @brief Computes the prices of a batch of options, one priceStrikes() call per chain.
+ *
+ * The rows are grouped by (spot, volatility, dividend, maturity, type, style); each group is a
+ * chain priced by priceStrikes() on the option of its first row.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ */
+void CarrMadanPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    typedef std::tuple<double, double, double, double, bool, bool> ChainKey;
+    std::map<ChainKey, std::vector<size_t>> chains;
+    for (size_t i = 0; i < options.size(); ++i) {
+        ChainKey key(options.spot(i), options.volatility(i), options.dividend(i), options.maturity(i),
+            options.isPut(i), options.isAmerican(i));
+        chains[key].push_back(i);
+    }
+
+    Option opt;
+    std::vector<double> strikes;
+    for (const auto& chain : chains) {
+        const std::vector<size_t>& rows = chain.second;
+        options.load(rows.front(), opt);
+        strikes.resize(rows.size());
+        for (size_t j = 0; j < rows.size(); ++j) {
+            strikes[j] = options.strike(rows[j]);
+        }
+        std::vector<double> chainPrices = priceStrikes(opt, strikes);
+        for (size_t j = 0; j < rows.size(); ++j) {
+            prices[rows[j]] = chainPrices[j];
+        }
+    }
+}
+
+/**
+ * @brief Computes the Greeks of the option using finite differences applied to the Carr-Madan pricer.
+ *
+ * The Greeks (Delta, Gamma, Vega, Theta, and Rho) are estimated by perturbing the input parameters
+ * and recalculating the option price. For the Heston model, Vega is the sensitivity to the
+ * initial volatility sqrt(v0).
+ *
+ * @param opt The option to evaluate.
+ * @return A Greeks structure containing the calculated values.
+ */
+Greeks CarrMadanPricer::computeGreeks(const Option& opt) const {
+    double h = 0.01 * opt.getUnderlying();
+    double volStep = 0.01;
+    double rStep = 0.001;
+    double timeStep = 1.0 / 365.0; // One day
+
+    double basePrice = price(opt);
+
+    // --- Delta ---
+    Option opt_up = opt;
+    Option opt_down = opt;
+    opt_up.setUnderlying(opt.getUnderlying() + h);
+    opt_down.setUnderlying(opt.getUnderlying() - h);
+    double price_up = price(opt_up);
+    double price_down = price(opt_down);
+    double delta = (price_up - price_down) / (2 * h);
+
+    // --- Gamma ---
+    double gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+
+    // --- Vega ---
+    Option opt_vol_up = opt;
+    Option opt_vol_down = opt;
+    opt_vol_up.setVolatility(opt.getVolatility() + volStep);
+    opt_vol_down.setVolatility(opt.getVolatility() - volStep);
+    double vega = (price(opt_vol_up) - price(opt_vol_down)) / (2 * volStep);
+
+    // --- Theta ---
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - timeStep);
+    double price_T_down = price(opt_T_down);
+    double theta = (price_T_down - basePrice) / (-timeStep);
+
+    // --- Rho ---
+    // The bumped pricers share the configuration and only shift the rates.
+    CarrMadanPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    CarrMadanPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
+    double rho = (pricer_r_up.price(opt) - pricer_r_down.price(opt)) / (2 * rStep);
+
+    Greeks greeks;
+    greeks.delta = delta;
+    greeks.gamma = gamma;
+    greeks.vega = vega;
+    greeks.theta = theta;
+    greeks.rho = rho;
+    return greeks;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file CharacteristicFunction.cpp
+ * @brief Implementation of the CharacteristicFunction class.
+ *
+ * With X = ln(S_T / S_0) the characteristic functions are
+ *
+ *    Black-Scholes:  exp(i u (r - q - sigma^2 / 2) T - sigma^2 u^2 T / 2),
+ *    Jump-diffusion: exp(T (i u w - sigma^2 u^2 / 2 + lambda (E[exp(i u Y)] - 1))),
+ *                    w = r - q - sigma^2 / 2 - lambda (E[exp(Y)] - 1),
+ *    Variance-Gamma: exp(i u (r - q + omega) T) (1 - i u theta nu + sigma^2 nu u^2 / 2)^(-T / nu),
+ *                    omega = ln(1 - theta nu - sigma^2 nu / 2) / nu,
+ *
+ * and the Heston function is written in the form of Albrecher et al. ("little Heston trap"),
+ * which avoids the branch cut of the complex logarithm for long maturities.
+ */
+
+#include "pch.h"
+#include "CharacteristicFunction.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+/// Constructor, validating the parameters of the selected model.
+CharacteristicFunction::CharacteristicFunction(const PricingConfiguration& config, double sigma, double r, double q, double T)
+    : model_(config.fourierModel),
+    sigma_(sigma),
+    r_(r),
+    q_(q),
+    T_(T),
+    kappa_(config.hestonKappa),
+    theta_(config.hestonTheta),
+    xi_(config.hestonXi),
+    rho_(config.hestonRho),
+    jumpModel_(config.jumpModel),
+    lambda_(config.jumpIntensity),
+    jumpMean_(config.mertonJumpMean),
+    jumpVolatility_(config.mertonJumpVolatility),
+    upProbability_(config.kouUpProbability),
+    upRate_(config.kouUpRate),
+    downRate_(config.kouDownRate),
+    compensator_(0.0),
+    vgTheta_(config.vgTheta),
+    vgNu_(config.vgNu),
+    vgOmega_(0.0)
+{
+    if (T_ <= 0.0) {
+        throw std::runtime_error("The time to maturity must be positive.");
+    }
+    switch (model_) {
+    case FourierModel::BlackScholes:
+        break;
+    case FourierModel::Heston:
+        if (kappa_ <= 0.0 || xi_ <= 0.0) {
+            throw std::runtime_error("The Heston model requires positive kappa and xi.");
+        }
+        break;
+    case FourierModel::JumpDiffusion:
+        if (lambda_ < 0.0) {
+            throw std::runtime_error("The jump intensity must be non-negative.");
+        }
+        if (jumpModel_ == JumpModel::Merton) {
+            compensator_ = std::exp(jumpMean_ + 0.5 * jumpVolatility_ * jumpVolatility_) - 1.0;
+        }
+        else {
+            if (upProbability_ < 0.0 || upProbability_ > 1.0 || upRate_ <= 1.0 || downRate_ <= 0.0) {
+                throw std::runtime_error("The Kou model requires 0 <= p <= 1, an upward rate above 1 and a positive downward rate.");
+            }
+            compensator_ = upProbability_ * upRate_ / (upRate_ - 1.0)
+                + (1.0 - upProbability_) * downRate_ / (downRate_ + 1.0) - 1.0;
+        }
+        break;
+    case FourierModel::VarianceGamma: {
+        double base = 1.0 - vgTheta_ * vgNu_ - 0.5 * sigma_ * sigma_ * vgNu_;
+        if (vgNu_ <= 0.0 || base <= 0.0) {
+            throw std::runtime_error("The Variance-Gamma model requires nu > 0 and theta nu + sigma^2 nu / 2 < 1.");
+        }
+        vgOmega_ = std::log(base) / vgNu_;
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown Fourier model.");
+    }
+}
+
+std::complex<double> CharacteristicFunction::operator()(std::complex<double> u) const {
+    const std::complex<double> i(0.0, 1.0);
+    const std::complex<double> iu = i * u;
+    const double variance = sigma_ * sigma_;
+
+    switch (model_) {
+    case FourierModel::Heston:
+        return std::exp(hestonExponent(u));
+    case FourierModel::JumpDiffusion: {
+        std::complex<double> jumpTransform;
+        if (jumpModel_ == JumpModel::Merton) {
+            jumpTransform = std::exp(iu * jumpMean_ + 0.5 * jumpVolatility_ * jumpVolatility_ * iu * iu);
+        }
+        else {
+            jumpTransform = upProbability_ * upRate_ / (upRate_ - iu) + (1.0 - upProbability_) * downRate_ / (downRate_ + iu);
+        }
+        double drift = r_ - q_ - 0.5 * variance - lambda_ * compensator_;
+        return std::exp(T_ * (iu * drift + 0.5 * variance * iu * iu + lambda_ * (jumpTransform - 1.0)));
+    }
+    case FourierModel::VarianceGamma: {
+        std::complex<double> base = 1.0 - iu * vgTheta_ * vgNu_ - 0.5 * variance * vgNu_ * iu * iu;
+        return std::exp(iu * (r_ - q_ + vgOmega_) * T_ - (T_ / vgNu_) * std::log(base));
+    }
+    case FourierModel::BlackScholes:
+    default:
+        return std::exp(iu * (r_ - q_ - 0.5 * variance) * T_ + 0.5 * variance * T_ * iu * iu);
+    }
+}
+
+std::complex<double> CharacteristicFunction::hestonExponent(std::complex<double> u) const {
+    const std::complex<double> i(0.0, 1.0);
+    const std::complex<double> iu = i * u;
+    const double v0 = sigma_ * sigma_;
+    const double xi2 = xi_ * xi_;
+
+    std::complex<double> beta = kappa_ - rho_ * xi_ * iu;
+    std::complex<double> d = std::sqrt(beta * beta + xi2 * (iu - iu * iu));
+    std::complex<double> g = (beta - d) / (beta + d);
+    std::complex<double> e = std::exp(-d * T_);
+
+    std::complex<double> C = iu * (r_ - q_) * T_
+        + (kappa_ * theta_ / xi2) * ((beta - d) * T_ - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+    std::complex<double> D = ((beta - d) / xi2) * (1.0 - e) / (1.0 - g * e);
+    return C + D * v0;
+}
+
+void CharacteristicFunction::cumulants(double& c1, double& c2, double& c4) const {
+    // Re ln phi(h) / h^2 = -c2 / 2 + c4 h^2 / 24 + O(h^4) and Im ln phi(h) = c1 h + O(h^3);
+    // c4 is extrapolated from the values at h and 2h.
+    const double h = 0.02;
+    std::complex<double> logPhi = std::log((*this)(std::complex<double>(h, 0.0)));
+    std::complex<double> logPhi2 = std::log((*this)(std::complex<double>(2.0 * h, 0.0)));
+    double A1 = logPhi.real() / (h * h);
+    double A2 = logPhi2.real() / (4.0 * h * h);
+    c4 = std::max(8.0 * (A2 - A1) / (h * h), 0.0);
+    c2 = std::max(-2.0 * (A1 - c4 * h * h / 24.0), 0.0);
+    c1 = (8.0 * logPhi.imag() - logPhi2.imag()) / (6.0 * h);
+}
@@ -0,0 +1,87 @@
+#ifndef CHARACTERISTICFUNCTION_HPP
+#define CHARACTERISTICFUNCTION_HPP
+
+/**
+ * @file CharacteristicFunction.hpp
+ * @brief Declaration of the CharacteristicFunction class.
+ *
+ * This class evaluates the risk-neutral characteristic function of the log-return ln(S_T / S_0)
+ * for the models supported by the Fourier pricing engines (Black-Scholes, Heston, Merton/Kou
+ * jump-diffusion and Variance-Gamma). It is shared by all the Fourier engines.
+ */
+
+#include "pch.h"
+#include "PricingConfiguration.hpp"
+#include <complex>
+
+/**
+ * @brief Risk-neutral characteristic function of the log-return of a model.
+ */
+class CharacteristicFunction {
+public:
+    /**
+     * @brief Constructor.
+     * @param config The configuration holding the model choice and its parameters.
+     * @param sigma The diffusion volatility (Heston: square root of the initial variance).
+     * @param r The risk-free rate.
+     * @param q The continuous dividend yield.
+     * @param T The time to maturity.
+     * @throw std::runtime_error if the model parameters are inconsistent.
+     */
+    CharacteristicFunction(const PricingConfiguration& config, double sigma, double r, double q, double T);
+
+    /**
+     * @brief Evaluates E[exp(i u ln(S_T / S_0))].
+     *
+     * The argument may be complex, as required by the damped transforms; the function is then
+     * evaluated by analytic continuation.
+     *
+     * @param u The frequency.
+     * @return The value of the characteristic function.
+     */
+    std::complex<double> operator()(std::complex<double> u) const;
+
+    /**
+     * @brief Computes the first, second and fourth cumulants of the log-return.
+     *
+     * They are obtained from the expansion of the logarithm of the characteristic function
+     * around zero, which is the same for every model.
+     *
+     * @param c1 Receives the mean.
+     * @param c2 Receives the variance.
+     * @param c4 Receives the fourth cumulant (floored at zero).
+     */
+    void cumulants(double& c1, double& c2, double& c4) const;
+
+private:
+    /**
+     * @brief Characteristic exponent of the Heston model (logarithm of the function).
+     */
+    std::complex<double> hestonExponent(std::complex<double> u) const;
+
+    FourierModel model_;
+    double sigma_;
+    double r_;
+    double q_;
+    double T_;
+    // Heston parameters.
+    double kappa_;
+    double theta_;
+    double xi_;
+    double rho_;
+    // Jump-diffusion parameters.
+    JumpModel jumpModel_;
+    double lambda_;
+    double jumpMean_;
+    double jumpVolatility_;
+    double upProbability_;
+    double upRate_;
+    double downRate_;
+    double compensator_; ///< E[exp(Y)] - 1 for the jump size Y.
+    // Variance-Gamma parameters.
+    double vgTheta_;
+    double vgNu_;
+    double vgOmega_; ///< Martingale correction of the Variance-Gamma process.
+};
+
+#endif // CHARACTERISTICFUNCTION_HPP
@@ -0,0 +1,253 @@
+/**
+ * @file CosPricer.cpp
+ * @brief Implementation of the CosPricer class (Fang-Oosterlee COS method).
+ *
+ * With y = ln(S_T / K) truncated to [a, b] and u_k = k pi / (b - a), the put price is
+ *
+ *    P = exp(-r T) sum'_k Re[phi(u_k) exp(i u_k (x - a))] V_k,   x = ln(S_0 / K),
+ *
+ * where phi is the characteristic function of ln(S_T / S_0), the first term of the sum is halved
+ * and V_k are the cosine coefficients of the put payoff K (1 - e^y)^+, known in closed form.
+ * The range is centered on the mean of the log-return, a = x + c1 - L sqrt(c2 + sqrt(c4)) and
+ * b = x + c1 + L sqrt(c2 + sqrt(c4)) with c_n the cumulants of ln(S_T / S_0), so x - a and the frequencies do not depend on the strike and the
+ * characteristic function terms are computed once for a whole chain. Calls are obtained by
+ * put-call parity, which avoids the cancellation of the call coefficients for large strikes.
+ */
+
+#include "pch.h"
+#include "CosPricer.hpp"
+#include "Option.hpp"
+#include "OptionBatch.hpp"
+#include "DateConverter.hpp"
+#include "CharacteristicFunction.hpp"
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846 // Definition of the constant PI
+#endif
+
+/// Default constructor, using default configuration values.
+CosPricer::CosPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
+    // No additional initialization required.
+}
+
+/// Constructor with pricing configuration.
+CosPricer::CosPricer(const PricingConfiguration& config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
+{
+    // The configuration parameters are now stored in config_.
+}
+
+/// Constructor sharing a configuration, with a bump overlay.
+CosPricer::CosPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
+/// Destructor.
+CosPricer::~CosPricer() {
+    // No dynamic cleanup is required.
+}
+
+/**
+ * @brief Computes the option price with the COS method.
+ * @param opt The option to be priced.
+ * @return The computed option price.
+ * @throw std::runtime_error if the option is not a vanilla European option or the parameters
+ *        are inconsistent.
+ */
+double CosPricer::price(const Option& opt) const {
+    return priceStrikes(opt, std::vector<double>(1, opt.getStrike())).front();
+}
+
+/**
+ * @brief Computes the prices of a chain of European options with the COS method.
+ *
+ * The effective time to maturity is adjusted by the calculation date as in the other pricers and
+ * riskFreeRate is used as a constant rate, as in the Black-Scholes pricer.
+ *
+ * @param opt The option providing every parameter but the strike.
+ * @param strikes The strikes of the chain.
+ * @return The prices, in the order of the strikes.
+ * @throw std::runtime_error if the option is not a vanilla European option or the parameters
+ *        are inconsistent.
+ */
+std::vector<double> CosPricer::priceStrikes(const Option& opt, const std::vector<double>& strikes) const {
+    if (opt.getOptionStyle() != Option::OptionStyle::European || opt.getBarrierType() != Option::BarrierType::None) {
+        throw std::runtime_error("CosPricer supports only vanilla European options.");
+    }
+
+    double S0 = opt.getUnderlying();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+    bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+
+    double T = config_->maturityOf(opt);
+    double r = config_->riskFreeRate + bump_.rateShift;
+
+    // Adjust effective time to maturity using calculationDate if provided.
+    double T_effective = T;
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
+        auto today = std::chrono::system_clock::now();
+        double offset = DateConverter::yearsBetween(calcDate, today);
+        T_effective = T - offset;
+    }
+
+    const int N = config_->cosTerms;
+    if (N < 2 || config_->cosTruncation <= 0.0) {
+        throw std::runtime_error("The COS method requires at least 2 terms and a positive truncation range.");
+    }
+
+    // Truncation range of the log-return and strike-independent series terms.
+    CharacteristicFunction phi(*config_, sigma, r, q, T_effective);
+    double c1 = 0.0;
+    double c2 = 0.0;
+    double c4 = 0.0;
+    phi.cumulants(c1, c2, c4);
+    double halfRange = config_->cosTruncation * std::sqrt(std::max(c2 + std::sqrt(c4), 1e-12));
+    double a0 = c1 - halfRange;
+    double width = 2.0 * halfRange;
+    double frequency = M_PI / width;
+
+    std::vector<double> terms(N);
+    for (int k = 0; k < N; ++k) {
+        double u = k * frequency;
+        std::complex<double> value = phi(u) * std::exp(std::complex<double>(0.0, -u * a0));
+        terms[k] = value.real();
+    }
+    terms[0] *= 0.5;
+
+    const double discount = std::exp(-r * T_effective);
+    const double forward = S0 * std::exp(-q * T_effective);
+    std::vector<double> prices(strikes.size());
+    for (size_t s = 0; s < strikes.size(); ++s) {
+        double K = strikes[s];
+        if (K <= 0.0) {
+            throw std::runtime_error("The strikes must be positive.");
+        }
+        double a = std::log(S0 / K) + a0;
+        double d = std::min(0.0, a + width);
+
+        // Put coefficients on [a, d]; cos/sin(k w (d - a)) are generated by rotation.
+        double put = 0.0;
+        if (d > a) {
+            double expA = std::exp(a);
+            double expD = std::exp(d);
+            double step = frequency * (d - a);
+            std::complex<double> rotation(std::cos(step), std::sin(step));
+            std::complex<double> angle(1.0, 0.0);
+            double sum = terms[0] * ((d - a) - (expD - expA));
+            for (int k = 1; k < N; ++k) {
+                angle *= rotation;
+                double w = k * frequency;
+                double chi = (angle.real() * expD - expA + w * angle.imag() * expD) / (1.0 + w * w);
+                double psi = angle.imag() / w;
+                sum += terms[k] * (psi - chi);
+            }
+            put = std::max(discount * 2.0 / width * K * sum, 0.0);
+        }
+        prices[s] = isCall ? put + forward - K * discount : put;
+    }
+    return prices;
+}
+
+/**
+ * @brief Computes the prices of a batch of options, one priceStrikes() call per chain.
+ *
+ * The rows are grouped by (spot, volatility, dividend, maturity, type, style); each group is a
+ * chain priced by priceStrikes() on the option of its first row.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ */
+void CosPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    typedef std::tuple<double, double, double, double, bool, bool> ChainKey;
+    std::map<ChainKey, std::vector<size_t>> chains;
+    for (size_t i = 0; i < options.size(); ++i) {
+        ChainKey key(options.spot(i), options.volatility(i), options.dividend(i), options.maturity(i),
+            options.isPut(i), options.isAmerican(i));
+        chains[key].push_back(i);
+    }
+
+    Option opt;
+    std::vector<double> strikes;
+    for (const auto& chain : chains) {
+        const std::vector<size_t>& rows = chain.second;
+        options.load(rows.front(), opt);
+        strikes.resize(rows.size());
+        for (size_t j = 0; j < rows.size(); ++j) {
+            strikes[j] = options.strike(rows[j]);
+        }
+        std::vector<double> chainPrices = priceStrikes(opt, strikes);
+        for (size_t j = 0; j < rows.size(); ++j) {
+            prices[rows[j]] = chainPrices[j];
+        }
+    }
+}
+
+/**
+ * @brief Computes the Greeks of the option using finite differences applied to the COS pricer.
+ *
+ * The Greeks (Delta, Gamma, Vega, Theta, and Rho) are estimated by perturbing the input parameters
+ * and recalculating the option price. For the Heston model, Vega is the sensitivity to the
+ * initial volatility sqrt(v0).
+ *
+ * @param opt The option to evaluate.
+ * @return A Greeks structure containing the calculated values.
+ */
+Greeks CosPricer::computeGreeks(const Option& opt) const {
+    double h = 0.01 * opt.getUnderlying();
+    double volStep = 0.01;
+    double rStep = 0.001;
+    double timeStep = 1.0 / 365.0; // One day
+
+    double basePrice = price(opt);
+
+    // --- Delta ---
+    Option opt_up = opt;
+    Option opt_down = opt;
+    opt_up.setUnderlying(opt.getUnderlying() + h);
+    opt_down.setUnderlying(opt.getUnderlying() - h);
+    double price_up = price(opt_up);
+    double price_down = price(opt_down);
+    double delta = (price_up - price_down) / (2 * h);
+
+    // --- Gamma ---
+    double gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+
+    // --- Vega ---
+    Option opt_vol_up = opt;
+    Option opt_vol_down = opt;
+    opt_vol_up.setVolatility(opt.getVolatility() + volStep);
+    opt_vol_down.setVolatility(opt.getVolatility() - volStep);
+    double vega = (price(opt_vol_up) - price(opt_vol_down)) / (2 * volStep);
+
+    // --- Theta ---
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - timeStep);
+    double price_T_down = price(opt_T_down);
+    double theta = (price_T_down - basePrice) / (-timeStep);
+
+    // --- Rho ---
+    // The bumped pricers share the configuration and only shift the rates.
+    CosPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    CosPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
+    double rho = (pricer_r_up.price(opt) - pricer_r_down.price(opt)) / (2 * rStep);
+
+    Greeks greeks;
+    greeks.delta = delta;
+    greeks.gamma = gamma;
+    greeks.vega = vega;
+    greeks.theta = theta;
+    greeks.rho = rho;
+    return greeks;
+}
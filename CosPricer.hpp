@@ -0,0 +1,93 @@
+#ifndef COSPRICER_HPP
+#define COSPRICER_HPP
+
+/**
+ * @file CosPricer.hpp
+ * @brief Declaration of the CosPricer class.
+ *
+ * This class implements the Fang-Oosterlee COS method for European options. The density of the
+ * log-return is expanded in a cosine series whose coefficients come directly from the
+ * characteristic function of the model selected by PricingConfiguration::fourierModel.
+ * The characteristic function is evaluated once per frequency and shared by all the strikes
+ * of a chain.
+ */
+
+#include "pch.h"
+#include "InterfaceOptionPricer.hpp"
+#include "PricingConfiguration.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Class that implements the COS pricing method.
+ */
+class CosPricer : public IOptionPricer {
+public:
+    /**
+     * @brief Default constructor.
+     */
+    CosPricer();
+
+    /**
+     * @brief Constructor with pricing configuration.
+     * @param config A PricingConfiguration structure containing additional parameters,
+     *               such as the calculation date, maturity, model and expansion settings.
+     */
+    CosPricer(const PricingConfiguration& config);
+
+    /**
+     * @brief Constructor sharing a configuration, with an optional bump overlay.
+     *
+     * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+     *
+     * @param config The shared configuration (not null).
+     * @param bump The overlay applied on top of the configuration.
+     */
+    CosPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~CosPricer();
+
+    /**
+     * @brief Computes the price of the option with the COS method.
+     * @param opt The option to be priced.
+     * @return The computed option price.
+     */
+    virtual double price(const Option& opt) const override;
+
+    /**
+     * @brief Computes the prices of a chain of options that differ only by their strike.
+     * @param opt The option providing every parameter but the strike.
+     * @param strikes The strikes of the chain.
+     * @return The prices, in the order of the strikes.
+     */
+    std::vector<double> priceStrikes(const Option& opt, const std::vector<double>& strikes) const;
+
+    /**
+     * @brief Computes the prices of a batch of options, one priceStrikes() call per chain.
+     *
+     * The options with the same spot, volatility, dividend, maturity, type and style form a chain
+     * priced by a single priceStrikes() call, so that the characteristic function terms are
+     * computed once per chain. The prices are identical to those of price(), since the series terms do not depend on the strike.
+     *
+     * @param options The options to be priced.
+     * @param prices Receives options.size() prices.
+     * @throw std::runtime_error as price(), for the first chain that cannot be priced.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const override;
+
+    /**
+     * @brief Computes the Greeks of the option using finite differences applied to the COS pricer.
+     * @param opt The option to evaluate.
+     * @return A Greeks structure containing the calculated values.
+     */
+    virtual Greeks computeGreeks(const Option& opt) const override;
+
+private:
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the COS method (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
+};
+
+#endif // COSPRICER_HPP
@@ -13,16 +13,512 @@
 #include "pch.h"
 #include "CrankNicolsonPricer.hpp"
 #include "Option.hpp"
+#include "OptionBatch.hpp"
 #include "DateConverter.hpp" // For date conversion functions
+#include "TridiagonalSolver.hpp"
+#include "ParallelFor.hpp"
 #include <vector>
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
 
+/**
+ * @brief Centered cubic B-spline M4, supported on [-2, 2].
+ * @param s Abscissa (in grid steps).
+ * @return The value of the B-spline at s.
+ */
+static double cubicBSpline(double s) {
+    double as = std::abs(s);
+    if (as >= 2.0) {
+        return 0.0;
+    }
+    if (as >= 1.0) {
+        return (2.0 - as) * (2.0 - as) * (2.0 - as) / 6.0;
+    }
+    return (4.0 - 6.0 * as * as + 3.0 * as * as * as) / 6.0;
+}
+
+/**
+ * @brief Kreiss fourth-order smoothing kernel Phi4, supported on [-3, 3].
+ *
+ * Phi4 = (I - delta^2 / 6) M4, whose Fourier transform is
+ * (sin(w/2) / (w/2))^4 (1 + 2/3 sin^2(w/2)). Convolving the payoff with it removes the
+ * kink at the strike while reproducing cubic polynomials exactly, so the fourth-order
+ * spatial convergence of the compact scheme is preserved.
+ *
+ * @param s Abscissa (in grid steps).
+ * @return The value of the kernel at s.
+ */
+static double kreissSmoothingKernel(double s) {
+    return (4.0 / 3.0) * cubicBSpline(s) - (cubicBSpline(s - 1.0) + cubicBSpline(s + 1.0)) / 6.0;
+}
+
+/**
+ * @brief Computes the payoff at a given log-spot, smoothed with the Phi4 kernel.
+ *
+ * The integral over [-3h, 3h] is evaluated with 5-point Gauss-Legendre quadrature on each
+ * unit sub-interval, splitting additionally at the kink so that every panel is smooth.
+ *
+ * @param x Log-spot of the node.
+ * @param h Log-spot grid step.
+ * @param K Strike price.
+ * @param isCall True for a call payoff, false for a put payoff.
+ * @return The smoothed payoff at x.
+ */
+static double smoothedPayoff(double x, double h, double K, bool isCall) {
+    static const double nodes[5] = { -0.9061798459386640, -0.5384693101056831, 0.0,
+                                      0.5384693101056831, 0.9061798459386640 };
+    static const double weights[5] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                                       0.4786286704993665, 0.2369268850561891 };
+
+    // Breakpoints of the integrand in kernel units: the kernel knots and the strike.
+    std::vector<double> breaks;
+    for (int k = -3; k <= 3; ++k) {
+        breaks.push_back(static_cast<double>(k));
+    }
+    double sKink = (x - std::log(K)) / h;
+    if (sKink > -3.0 && sKink < 3.0) {
+        breaks.push_back(sKink);
+    }
+    std::sort(breaks.begin(), breaks.end());
+
+    double value = 0.0;
+    for (size_t i = 0; i + 1 < breaks.size(); ++i) {
+        double lo = breaks[i];
+        double hi = breaks[i + 1];
+        double half = 0.5 * (hi - lo);
+        double mid = 0.5 * (hi + lo);
+        for (int k = 0; k < 5; ++k) {
+            double s = mid + half * nodes[k];
+            double S = std::exp(x - h * s);
+            double payoff = isCall ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+            value += half * weights[k] * kreissSmoothingKernel(s) * payoff;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Tells whether a barrier is monitored from above.
+ * @param type The barrier type.
+ * @return True for up-and-out and up-and-in barriers.
+ */
+static bool isUpBarrier(Option::BarrierType type) {
+    return type == Option::BarrierType::UpAndOut || type == Option::BarrierType::UpAndIn;
+}
+
+/**
+ * @brief Tells whether a barrier activates the option.
+ * @param type The barrier type.
+ * @return True for up-and-in and down-and-in barriers.
+ */
+static bool isKnockInBarrier(Option::BarrierType type) {
+    return type == Option::BarrierType::UpAndIn || type == Option::BarrierType::DownAndIn;
+}
+
+/**
+ * @brief Builds the time levels of the backward induction.
+ *
+ * Without Bermudan exercise the grid is uniform (times[n] = n * T_effective / N). For Bermudan options
+ * the steps are distributed over the intervals between exercise times, in proportion to their length
+ * and with at least one step each, so that every exercise time is exactly a time level.
+ * exerciseLevel[n] tells whether exercise is allowed at times[n]: every level but maturity for
+ * American options, only the exercise times for Bermudan options, none for European options.
+ *
+ * @param opt The option (style and exercise times).
+ * @param T_effective Effective time to maturity.
+ * @param offset Years elapsed since the calculation date, subtracted from the exercise times.
+ * @param N Requested number of time steps.
+ * @param times Output time levels (size steps.size() + 1).
+ * @param steps Output step sizes.
+ * @param exerciseLevel Output exercise flags per time level.
+ */
+static void buildTimeGrid(const Option& opt, double T_effective, double offset, int N,
+    std::vector<double>& times, std::vector<double>& steps, std::vector<char>& exerciseLevel) {
+    times.clear();
+    steps.clear();
+    std::vector<char> exercisable;
+
+    if (opt.getOptionStyle() != Option::OptionStyle::Bermudan) {
+        double dt = T_effective / N;
+        for (int n = 0; n <= N; ++n) {
+            times.push_back(n * dt);
+        }
+        steps.assign(N, dt);
+        exerciseLevel.assign(N + 1, opt.getOptionStyle() == Option::OptionStyle::American ? 1 : 0);
+        exerciseLevel[N] = 0;
+        return;
+    }
+
+    // Exercise times strictly inside (0, T_effective), plus a flag for immediate exercise.
+    const double tolerance = 1e-10 * std::max(T_effective, 1.0);
+    bool exerciseToday = false;
+    std::vector<double> breaks;
+    for (double tEx : opt.getExerciseTimes()) {
+        double t = tEx - offset;
+        if (std::abs(t) <= tolerance) {
+            exerciseToday = true;
+        }
+        else if (t > tolerance && t < T_effective - tolerance) {
+            breaks.push_back(t);
+        }
+    }
+    std::sort(breaks.begin(), breaks.end());
+    breaks.erase(std::unique(breaks.begin(), breaks.end()), breaks.end());
+    breaks.insert(breaks.begin(), 0.0);
+    breaks.push_back(T_effective);
+
+    times.push_back(0.0);
+    exerciseLevel.assign(1, exerciseToday ? 1 : 0);
+    for (size_t s = 0; s + 1 < breaks.size(); ++s) {
+        double length = breaks[s + 1] - breaks[s];
+        int count = std::max(1, static_cast<int>(std::lround(N * length / T_effective)));
+        double dt = length / count;
+        for (int k = 1; k <= count; ++k) {
+            times.push_back(k == count ? breaks[s + 1] : breaks[s] + k * dt);
+            steps.push_back(dt);
+            exerciseLevel.push_back(0);
+        }
+        // The end of every interval but the last (maturity) is an exercise time.
+        if (s + 2 < breaks.size()) {
+            exerciseLevel.back() = 1;
+        }
+    }
+}
+
+/**
+ * @brief Applies early exercise and the barrier condition after a time step.
+ *
+ * The exercise projection is applied only when the current level is an exercise level. Nodes beyond the
+ * barrier are set to zero for knock-out options, and to the value of the vanilla option (rolled back
+ * alongside) for knock-in options, which carry no exercise right until they are knocked in.
+ *
+ * @param V Values of the option on the grid.
+ * @param vanilla Values of the vanilla option on the grid (knock-in options only).
+ * @param payoff Intrinsic values on the grid.
+ * @param exercise True if exercise is allowed at this time level.
+ * @param type Barrier type.
+ * @param barrierNode Index of the grid node on the barrier.
+ */
+static void applyStepConstraints(std::vector<double>& V, std::vector<double>& vanilla,
+    const std::vector<double>& payoff, bool exercise, Option::BarrierType type, int barrierNode) {
+    const int size = static_cast<int>(V.size());
+    if (type == Option::BarrierType::None) {
+        if (exercise) {
+            for (int j = 0; j < size; ++j) {
+                V[j] = std::max(V[j], payoff[j]);
+            }
+        }
+        return;
+    }
+
+    bool up = isUpBarrier(type);
+    if (isKnockInBarrier(type)) {
+        for (int j = 0; j < size; ++j) {
+            if (exercise) {
+                vanilla[j] = std::max(vanilla[j], payoff[j]);
+            }
+            if (up ? (j >= barrierNode) : (j <= barrierNode)) {
+                V[j] = vanilla[j];
+            }
+        }
+    }
+    else {
+        for (int j = 0; j < size; ++j) {
+            if (up ? (j >= barrierNode) : (j <= barrierNode)) {
+                V[j] = 0.0;
+            }
+            else if (exercise) {
+                V[j] = std::max(V[j], payoff[j]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adjoint of applyStepConstraints.
+ *
+ * On entry lambda and lambdaVanilla hold the derivatives of the price with respect to the values after
+ * the constraints; on exit, with respect to the values before them. Nodes set to the payoff or knocked
+ * out do not depend on the solved values; knocked-in nodes pass their derivative to the vanilla option.
+ *
+ * @param lambda Derivatives with respect to the option values.
+ * @param lambdaVanilla Derivatives with respect to the vanilla values (knock-in options only).
+ * @param solved Option values before the constraints.
+ * @param solvedVanilla Vanilla values before the constraints.
+ * @param payoff Intrinsic values on the grid.
+ * @param exercise True if exercise is allowed at this time level.
+ * @param type Barrier type.
+ * @param barrierNode Index of the grid node on the barrier.
+ */
+static void applyStepConstraintsAdjoint(std::vector<double>& lambda, std::vector<double>& lambdaVanilla,
+    const std::vector<double>& solved, const std::vector<double>& solvedVanilla, const std::vector<double>& payoff,
+    bool exercise, Option::BarrierType type, int barrierNode) {
+    const int size = static_cast<int>(lambda.size());
+    bool barrier = (type != Option::BarrierType::None);
+    bool up = isUpBarrier(type);
+    bool knockIn = barrier && isKnockInBarrier(type);
+    for (int j = 0; j < size; ++j) {
+        bool knocked = barrier && (up ? (j >= barrierNode) : (j <= barrierNode));
+        if (knockIn) {
+            if (knocked) {
+                lambdaVanilla[j] += lambda[j];
+                lambda[j] = 0.0;
+            }
+            if (exercise && solvedVanilla[j] < payoff[j]) {
+                lambdaVanilla[j] = 0.0;
+            }
+        }
+        else if (knocked || (exercise && solved[j] < payoff[j])) {
+            lambda[j] = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Tells whether an interior row of the system of a time step is beyond the barrier.
+ * @param row Index of the row (the row of node row + 1).
+ * @param type Barrier type (None: no row is beyond the barrier).
+ * @param barrierNode Index of the grid node on the barrier.
+ */
+static bool isKnockedRow(int row, Option::BarrierType type, int barrierNode) {
+    if (type == Option::BarrierType::None) {
+        return false;
+    }
+    return isUpBarrier(type) ? (row + 1 >= barrierNode) : (row + 1 <= barrierNode);
+}
+
+/**
+ * @brief Enforces the barrier as a Dirichlet condition in the system of a time step.
+ *
+ * The rows of the nodes on and beyond the barrier become x_j = 0 for a knock-out, and x_j = the vanilla
+ * value of the new level for a knock-in, so that the nodes next to the barrier are solved with the
+ * barrier value of the same level: the barrier is monitored continuously, not only at the time levels.
+ * The boundary terms must already be in the right-hand side.
+ *
+ * @param a, b, c Rows of the system, copied from those of the vanilla option.
+ * @param d Right-hand side.
+ * @param vanilla Vanilla values of the new level (knock-in options only).
+ * @param type Barrier type.
+ * @param barrierNode Index of the grid node on the barrier.
+ */
+static void applyBarrierRows(std::vector<double>& a, std::vector<double>& b, std::vector<double>& c,
+    std::vector<double>& d, const std::vector<double>& vanilla, Option::BarrierType type, int barrierNode) {
+    const int rows = static_cast<int>(d.size());
+    const bool knockIn = isKnockInBarrier(type);
+    for (int i = 0; i < rows; ++i) {
+        if (isKnockedRow(i, type, barrierNode)) {
+            a[i] = 0.0;
+            b[i] = 1.0;
+            c[i] = 0.0;
+            d[i] = knockIn ? vanilla[i + 1] : 0.0;
+        }
+    }
+}
+
+/**
+ * Each step solves T x = R V + (boundary terms), where V holds the values of the previous level, x the
+ * interior values of the new level, and T and R are tridiagonal matrices depending on the local rate;
+ * the early exercise and barrier constraints are then applied. The record keeps, for every step, the two
+ * matrices, the values before the constraints, and the vector g = dR/dr V - dT/dr x (including the rate
+ * dependence of the boundary coupling), so that the derivative of x with respect to the rate is
+ * T^{-1} g. The adjoint sweep then runs from the price back to maturity: the derivative of the price
+ * with respect to the rate of a step is mu . g plus the boundary terms, where mu solves T^T mu = lambda,
+ * and the derivatives with respect to the previous level are R^T mu. One transposed Thomas solve per
+ * step gives the sensitivities to all the local rates.
+ *
+ * The record keeps the rows of the vanilla option. For a barrier option the rows beyond the barrier are
+ * identity rows (see applyBarrierRows()): they have no rate term, and for a knock-in the part of mu on
+ * these rows is the derivative with respect to the vanilla values of the same level.
+ */
+struct CrankNicolsonPricer::RateTrace {
+    /**
+     * @brief Record of one time step.
+     */
+    struct Step {
+        double rateTime;                       ///< Normalized time at which the local rate is read.
+        bool exercise;                         ///< True if exercise is allowed at the new level.
+        std::vector<double> a, b, c;           ///< Implicit rows: a x[j-1] + b x[j] + c x[j+1].
+        std::vector<double> lo, mid, up;       ///< Explicit rows applied to the previous level.
+        std::vector<double> g;                 ///< dR/dr V - dT/dr x for the option.
+        std::vector<double> gVanilla;          ///< Same for the vanilla option of a knock-in.
+        std::vector<double> solved;            ///< Option values before the constraints.
+        std::vector<double> solvedVanilla;     ///< Vanilla values before the constraints.
+        double couplingLow, couplingUp;        ///< Coefficients of the boundary values subtracted from the first and last right-hand sides.
+        double dLower, dUpper;                 ///< Derivatives of the option boundary values.
+        double dLowerVanilla, dUpperVanilla;   ///< Derivatives of the vanilla boundary values.
+    };
+
+    std::vector<Step> steps;                   ///< Steps in the order of the rollback (from maturity).
+    std::vector<double> payoff;                ///< Intrinsic values on the grid.
+    Option::BarrierType barrierType = Option::BarrierType::None; ///< Barrier of the option (set before the first step).
+    int barrierNode = -1;                      ///< Index of the grid node on the barrier.
+    int readIndex = 0;                         ///< The price is read on the nodes from readIndex on...
+    std::vector<double> readWeights;           ///< ... with these interpolation weights.
+
+    // Scratch data of the step being recorded.
+    std::vector<double> input, inputVanilla;   ///< Values of the previous level.
+    std::vector<double> da, db, dc, dlo, dmid, dup; ///< Derivatives of the rows with respect to the rate.
+    double dCouplingLow = 0.0, dCouplingUp = 0.0;
+
+    /**
+     * @brief Starts the record of a step, from the values of the previous level.
+     */
+    Step& beginStep(double rateTime, const std::vector<double>& V, const std::vector<double>& vanilla) {
+        const size_t rows = V.size() - 2;
+        steps.emplace_back();
+        Step& step = steps.back();
+        step.rateTime = rateTime;
+        step.lo.resize(rows);
+        step.mid.resize(rows);
+        step.up.resize(rows);
+        step.dLower = step.dUpper = step.dLowerVanilla = step.dUpperVanilla = 0.0;
+        input = V;
+        inputVanilla = vanilla;
+        for (std::vector<double>* v : { &da, &db, &dc, &dlo, &dmid, &dup }) {
+            v->assign(rows, 0.0);
+        }
+        return step;
+    }
+
+    /**
+     * @brief Completes the record of the current step once the new level is solved.
+     */
+    void endStep(const std::vector<double>& a, const std::vector<double>& b, const std::vector<double>& c,
+        const std::vector<double>& V, const std::vector<double>& vanilla, bool exercise) {
+        Step& step = steps.back();
+        step.exercise = exercise;
+        step.a = a;
+        step.b = b;
+        step.c = c;
+        step.solved = V;
+        step.solvedVanilla = vanilla;
+        rateTerm(input, V, step.g);
+        for (size_t i = 0; i < step.g.size(); ++i) {
+            if (isKnockedRow(static_cast<int>(i), barrierType, barrierNode)) {
+                step.g[i] = 0.0;
+            }
+        }
+        if (!vanilla.empty()) {
+            rateTerm(inputVanilla, vanilla, step.gVanilla);
+        }
+    }
+
+    /**
+     * @brief Computes g = dR/dr V - dT/dr x for one step.
+     */
+    void rateTerm(const std::vector<double>& V, const std::vector<double>& x, std::vector<double>& g) const {
+        const int rows = static_cast<int>(da.size());
+        const int M = rows + 1;
+        g.resize(rows);
+        for (int i = 0; i < rows; ++i) {
+            int j = i + 1;
+            double rhs = dlo[i] * V[j - 1] + dmid[i] * V[j] + dup[i] * V[j + 1];
+            double lhs = db[i] * x[j]
+                + ((i > 0) ? da[i] * x[j - 1] : dCouplingLow * x[0])
+                + ((i < rows - 1) ? dc[i] * x[j + 1] : dCouplingUp * x[M]);
+            g[i] = rhs - lhs;
+        }
+    }
+
+    /**
+     * @brief Runs the adjoint sweep.
+     * @param rateTimes Receives the normalized times of the local rates.
+     * @param rateSensitivities Receives the derivative of the price with respect to each local rate.
+     */
+    void sensitivities(std::vector<double>& rateTimes, std::vector<double>& rateSensitivities) const {
+        rateTimes.clear();
+        rateSensitivities.clear();
+        if (steps.empty()) {
+            return;
+        }
+        const int M = static_cast<int>(payoff.size()) - 1;
+        const int rows = M - 1;
+        const bool knockIn = !steps.front().solvedVanilla.empty();
+
+        std::vector<double> lambda(M + 1, 0.0);
+        std::vector<double> lambdaVanilla(knockIn ? M + 1 : 0, 0.0);
+        for (size_t k = 0; k < readWeights.size(); ++k) {
+            lambda[readIndex + k] += readWeights[k];
+        }
+
+        std::vector<double> at(rows), bt(rows), ct(rows), rhs(rows), mu(rows), muVanilla(rows), cPrime(rows), dPrime(rows);
+        std::vector<double> previous(M + 1);
+        const bool barrier = (barrierType != Option::BarrierType::None);
+        const bool knockedLow = isKnockedRow(0, barrierType, barrierNode);
+        const bool knockedUp = isKnockedRow(rows - 1, barrierType, barrierNode);
+        for (size_t s = steps.size(); s-- > 0;) {
+            const Step& step = steps[s];
+            applyStepConstraintsAdjoint(lambda, lambdaVanilla, step.solved, step.solvedVanilla, payoff, step.exercise,
+                barrierType, barrierNode);
+
+            // Transposed system: T^T has c shifted down as sub-diagonal and a shifted up as super-diagonal.
+            // With withBarrier, the rows beyond the barrier are identity rows.
+            auto transpose = [&](bool withBarrier) {
+                for (int i = 0; i < rows; ++i) {
+                    bool fixed = withBarrier && isKnockedRow(i, barrierType, barrierNode);
+                    at[i] = (i > 0 && !(withBarrier && isKnockedRow(i - 1, barrierType, barrierNode))) ? step.c[i - 1] : 0.0;
+                    bt[i] = fixed ? 1.0 : step.b[i];
+                    ct[i] = (i < rows - 1 && !(withBarrier && isKnockedRow(i + 1, barrierType, barrierNode))) ? step.a[i + 1] : 0.0;
+                }
+            };
+            auto adjointSolve = [&](const std::vector<double>& l, const std::vector<double>& g,
+                double dLower, double couplingLow, double dUpper, double couplingUp, std::vector<double>& m) {
+                for (int i = 0; i < rows; ++i) {
+                    rhs[i] = l[i + 1];
+                }
+                solveTridiagonal(at, bt, ct, rhs, m, cPrime, dPrime);
+                double sensitivity = (l[0] - m[0] * couplingLow) * dLower
+                    + (l[M] - m[rows - 1] * couplingUp) * dUpper;
+                for (int i = 0; i < rows; ++i) {
+                    sensitivity += m[i] * g[i];
+                }
+                return sensitivity;
+            };
+            transpose(barrier);
+            double sensitivity = adjointSolve(lambda, step.g, step.dLower, knockedLow ? 0.0 : step.couplingLow,
+                step.dUpper, knockedUp ? 0.0 : step.couplingUp, mu);
+            if (knockIn) {
+                // The identity rows of a knock-in read the vanilla values of the same level.
+                for (int i = 0; i < rows; ++i) {
+                    if (isKnockedRow(i, barrierType, barrierNode)) {
+                        lambdaVanilla[i + 1] += mu[i];
+                    }
+                }
+                transpose(false);
+                sensitivity += adjointSolve(lambdaVanilla, step.gVanilla, step.dLowerVanilla, step.couplingLow,
+                    step.dUpperVanilla, step.couplingUp, muVanilla);
+            }
+            rateTimes.push_back(step.rateTime);
+            rateSensitivities.push_back(sensitivity);
+
+            // Derivatives with respect to the previous level: R^T mu (the identity rows have no explicit part).
+            auto transposeExplicit = [&](const std::vector<double>& m, std::vector<double>& l, bool withBarrier) {
+                std::fill(previous.begin(), previous.end(), 0.0);
+                for (int i = 0; i < rows; ++i) {
+                    if (withBarrier && isKnockedRow(i, barrierType, barrierNode)) {
+                        continue;
+                    }
+                    previous[i] += m[i] * step.lo[i];
+                    previous[i + 1] += m[i] * step.mid[i];
+                    previous[i + 2] += m[i] * step.up[i];
+                }
+                l.swap(previous);
+            };
+            transposeExplicit(mu, lambda, barrier);
+            if (knockIn) {
+                transposeExplicit(muVanilla, lambdaVanilla, false);
+            }
+        }
+    }
+};
+
  /**
   * @brief Default constructor of CrankNicolsonPricer.
   */
-CrankNicolsonPricer::CrankNicolsonPricer() {
+CrankNicolsonPricer::CrankNicolsonPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
     // No explicit configuration provided; default configuration is assumed.
 }
 
@@ -43,11 +539,24 @@ CrankNicolsonPricer::~CrankNicolsonPricer() {
  * @param config A PricingConfiguration object containing custom parameters.
  */
 CrankNicolsonPricer::CrankNicolsonPricer(const PricingConfiguration& config)
-    : config_(config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
 {
     // Configuration parameters are now stored in config_
 }
 
+/**
+ * @brief Constructor sharing a configuration, with a bump overlay.
+ *
+ * The configuration is shared, not copied: the bumped pricers of computeGreeks() are built this way.
+ *
+ * @param config The shared configuration.
+ * @param bump The overlay applied on top of the configuration.
+ */
+CrankNicolsonPricer::CrankNicolsonPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
 /**
  * @brief Computes the option price using the Crank-Nicolson method.
  *
@@ -57,85 +566,196 @@ CrankNicolsonPricer::CrankNicolsonPricer(const PricingConfiguration& config)
  *
  *    T_effective = T - offset,
  *
- * where offset is the number of years between config_.calculationDate and today.
+ * where offset is the number of years between config_->calculationDate and today.
  *
  * Moreover, at each time step the local risk-free rate is determined by interpolating the yield curve.
  * If the yield curve is empty, the default risk-free rate from config_ is used.
  *
+ * Barrier options are priced on a grid whose step is adjusted so that the barrier is exactly a node,
+ * and Bermudan exercise times are exactly time levels (see buildTimeGrid). The exercise projection
+ * runs only on exercise levels.
+ *
+ * When config_->crankHighOrder is set, the computation is delegated to priceHighOrderCompact().
+ *
  * @param opt The option to be priced.
  * @return The computed option price.
  */
 double CrankNicolsonPricer::price(const Option& opt) const {
+    return solve(opt, nullptr);
+}
+
+/**
+ * @brief Computes the price for price(), optionally recording the time steps for computeKeyRateRho().
+ *
+ * @param opt The option to be priced.
+ * @param trace If not null, receives the record of the time steps.
+ * @return The computed option price.
+ */
+double CrankNicolsonPricer::solve(const Option& opt, RateTrace* trace) const {
+    // A barrier breached at inception: knock-outs are worthless, knock-ins are vanilla.
+    Option::BarrierType barrierType = opt.getBarrierType();
+    if (barrierType != Option::BarrierType::None) {
+        if (opt.getBarrier() <= 0.0) {
+            throw std::runtime_error("The barrier level must be positive.");
+        }
+        bool breached = isUpBarrier(barrierType) ? (opt.getUnderlying() >= opt.getBarrier())
+            : (opt.getUnderlying() <= opt.getBarrier());
+        if (breached) {
+            if (!isKnockInBarrier(barrierType)) {
+                return 0.0;
+            }
+            Option vanilla = opt;
+            vanilla.setBarrier(Option::BarrierType::None, 0.0);
+            return solve(vanilla, trace);
+        }
+    }
+
+    if (config_->crankHighOrder) {
+        return priceHighOrderCompact(opt, trace);
+    }
+
     // Option parameters
     double S0 = opt.getUnderlying();    // Underlying price
     double K = opt.getStrike();         // Strike price
     double sigma = opt.getVolatility(); // Volatility
     double q = opt.getDividend();       // Continuous dividend yield
+    bool isKnockIn = isKnockInBarrier(barrierType);
 
     // Retrieve maturity and default risk-free rate from configuration.
-    double T = config_.maturity;
-    double r_default = config_.riskFreeRate;
+    double T = config_->maturityOf(opt);
+    double r_default = config_->riskFreeRate + bump_.rateShift;
 
     // Adjust effective time to maturity using calculationDate if provided.
     double T_effective = T;
-    if (!config_.calculationDate.empty()) {
-        auto calcDate = DateConverter::parseDate(config_.calculationDate);
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
         auto today = std::chrono::system_clock::now();
         double offset = DateConverter::yearsBetween(calcDate, today);
         T_effective = T - offset;
     }
 
     // Retrieve discretization parameters.
-    const int M = config_.crankSpotSteps;  // Number of spatial steps
-    const int N = config_.crankTimeSteps;    // Number of time steps
-    double Smax = (config_.S_max > 0.0) ? config_.S_max : std::max(3.0 * K, 3.0 * S0);
+    const int M = config_->crankSpotSteps;  // Number of spatial steps
+    double Smax = (config_->S_max > 0.0) ? config_->S_max : std::max(3.0 * K, 3.0 * S0);
     double dS = Smax / M;
-    double dt = T_effective / N;           // Use effective time here
+
+    // Align the grid with the barrier: dS is adjusted so that the barrier is node barrierNode.
+    int barrierNode = -1;
+    if (barrierType != Option::BarrierType::None) {
+        double B = opt.getBarrier();
+        if (B > Smax) {
+            Smax = B;
+            dS = Smax / M;
+        }
+        barrierNode = std::max(1, static_cast<int>(std::lround(B / dS)));
+        dS = B / barrierNode;
+        Smax = M * dS;
+    }
+
+    // Time levels (exact Bermudan exercise times) and exercise flags.
+    std::vector<double> times;
+    std::vector<double> steps;
+    std::vector<char> exerciseLevel;
+    buildTimeGrid(opt, T_effective, T - T_effective, config_->crankTimeSteps, times, steps, exerciseLevel);
+    const int N = static_cast<int>(steps.size()); // Number of time steps
 
     // Build spatial grid.
     std::vector<double> S(M + 1);
     for (int j = 0; j <= M; ++j) {
         S[j] = j * dS;
     }
+    auto knocked = [&](int j) {
+        return isUpBarrier(barrierType) ? (j >= barrierNode) : (j <= barrierNode);
+    };
 
     // Terminal condition: payoff at maturity.
-    std::vector<double> V(M + 1, 0.0);
+    std::vector<double> payoff(M + 1, 0.0);
     if (opt.getOptionType() == Option::OptionType::Call) {
         for (int j = 0; j <= M; ++j) {
-            V[j] = std::max(S[j] - K, 0.0);
+            payoff[j] = std::max(S[j] - K, 0.0);
         }
     }
     else { // Put option
         for (int j = 0; j <= M; ++j) {
-            V[j] = std::max(K - S[j], 0.0);
+            payoff[j] = std::max(K - S[j], 0.0);
+        }
+    }
+    std::vector<double> V(payoff);
+    // Vanilla values rolled back alongside a knock-in option.
+    std::vector<double> vanilla(isKnockIn ? M + 1 : 0, 0.0);
+    if (barrierType != Option::BarrierType::None) {
+        for (int j = 0; j <= M; ++j) {
+            V[j] = (knocked(j) == isKnockIn) ? payoff[j] : 0.0;
+        }
+        if (isKnockIn) {
+            vanilla = payoff;
         }
     }
 
     // Temporary vector for current time step.
     std::vector<double> newV(M + 1, 0.0);
+    std::vector<double> newVanilla(vanilla.size(), 0.0);
     // Vectors for the tridiagonal system.
     std::vector<double> a(M - 1, 0.0); // Coefficient for V_{j-1}^{n+1}
     std::vector<double> b(M - 1, 0.0); // Coefficient for V_{j}^{n+1}
     std::vector<double> c(M - 1, 0.0); // Coefficient for V_{j+1}^{n+1}
+    // System of a barrier option, with the barrier condition (see applyBarrierRows).
+    const bool hasBarrier = (barrierType != Option::BarrierType::None);
+    std::vector<double> aBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    std::vector<double> bBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    std::vector<double> cBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    if (trace) {
+        trace->barrierType = barrierType;
+        trace->barrierNode = barrierNode;
+    }
     std::vector<double> d_vec(M - 1, 0.0); // Right-hand side
+    std::vector<double> d_vanilla(isKnockIn ? M - 1 : 0, 0.0); // Right-hand side of the vanilla option
+    // Solution of the tridiagonal system and Thomas scratch space, reused at every step.
+    std::vector<double> interior(M - 1, 0.0);
+    std::vector<double> c_prime(M - 1, 0.0);
+    std::vector<double> d_prime(M - 1, 0.0);
 
     // Backward induction loop (n from N-1 to 0)
     for (int n = N - 1; n >= 0; --n) {
-        double t = n * dt;
+        double t = times[n];
+        double dt = steps[n];
         // Compute normalized time (for yield curve interpolation).
         // Here, we define normTime such that normTime = 1 at t = 0 (start) and 0 at t = T_effective (maturity)
         double normTime = (T_effective - t) / T_effective;
         // Obtain local risk-free rate from yield curve (if available); otherwise, use default.
-        double r_local = (!config_.yieldCurve.getData().empty()) ? config_.yieldCurve.getRate(normTime) : r_default;
+        double r_local = (!config_->yieldCurve.getData().empty()) ? config_->yieldCurve.getRate(normTime) + bump_.rateShift : r_default;
+        RateTrace::Step* step = trace ? &trace->beginStep(normTime, V, vanilla) : nullptr;
 
         // Boundary conditions at time t.
+        double lower = 0.0;
+        double upper = 0.0;
         if (opt.getOptionType() == Option::OptionType::Call) {
-            newV[0] = 0.0;
-            newV[M] = Smax - K * std::exp(-r_local * (T_effective - t));
+            lower = 0.0;
+            upper = Smax - K * std::exp(-r_local * (T_effective - t));
         }
         else {
-            newV[0] = K * std::exp(-r_local * (T_effective - t));
-            newV[M] = 0.0;
+            lower = K * std::exp(-r_local * (T_effective - t));
+            upper = 0.0;
+        }
+        if (step) {
+            // d/dr of K exp(-r (T - t)), the only rate-dependent term of the boundary values.
+            double dDiscountedStrike = -(T_effective - t) * K * std::exp(-r_local * (T_effective - t));
+            bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+            step->dLowerVanilla = isCall ? 0.0 : dDiscountedStrike;
+            step->dUpperVanilla = isCall ? -dDiscountedStrike : 0.0;
+            bool barrier = (barrierType != Option::BarrierType::None);
+            step->dLower = (!barrier || knocked(0) == isKnockIn) ? step->dLowerVanilla : 0.0;
+            step->dUpper = (!barrier || knocked(M) == isKnockIn) ? step->dUpperVanilla : 0.0;
+        }
+        newV[0] = lower;
+        newV[M] = upper;
+        if (barrierType != Option::BarrierType::None) {
+            newV[0] = (knocked(0) == isKnockIn) ? lower : 0.0;
+            newV[M] = (knocked(M) == isKnockIn) ? upper : 0.0;
+            if (isKnockIn) {
+                newVanilla[0] = lower;
+                newVanilla[M] = upper;
+            }
         }
 
         // Form the tridiagonal system for interior nodes j = 1 to M-1.
@@ -155,48 +775,68 @@ double CrankNicolsonPricer::price(const Option& opt) const {
             b[j - 1] = B;
             c[j - 1] = -C;
             d_vec[j - 1] = D_coef * V[j - 1] + E_coef * V[j] + F * V[j + 1];
+            if (step) {
+                double dA = -0.5 * dt * S_j / (2 * dS);
+                double dC = 0.5 * dt * S_j / (2 * dS);
+                step->lo[j - 1] = D_coef;
+                step->mid[j - 1] = E_coef;
+                step->up[j - 1] = F;
+                trace->da[j - 1] = -dA;
+                trace->db[j - 1] = 0.5 * dt;
+                trace->dc[j - 1] = -dC;
+                trace->dlo[j - 1] = dA;
+                trace->dmid[j - 1] = -0.5 * dt;
+                trace->dup[j - 1] = dC;
+            }
+            if (isKnockIn) {
+                d_vanilla[j - 1] = D_coef * vanilla[j - 1] + E_coef * vanilla[j] + F * vanilla[j + 1];
+            }
         }
 
         // Adjust right-hand side for boundary conditions.
         d_vec[0] -= (-a[0]) * newV[0];
         d_vec[M - 2] -= (-c[M - 2]) * newV[M];
+        if (step) {
+            step->couplingLow = -a[0];
+            step->couplingUp = -c[M - 2];
+            trace->dCouplingLow = -trace->da[0];
+            trace->dCouplingUp = -trace->dc[M - 2];
+        }
 
-        // Solve the tridiagonal system using the Thomas algorithm.
-        std::vector<double> c_prime(M - 1, 0.0);
-        std::vector<double> d_prime(M - 1, 0.0);
-
-        c_prime[0] = c[0] / b[0];
-        d_prime[0] = d_vec[0] / b[0];
-
-        for (int j = 1; j < M - 1; ++j) {
-            double m = b[j] - a[j] * c_prime[j - 1];
-            c_prime[j] = c[j] / m;
-            d_prime[j] = (d_vec[j] - a[j] * d_prime[j - 1]) / m;
+        // The vanilla option of a knock-in is solved first: its new values are the barrier condition.
+        if (isKnockIn) {
+            d_vanilla[0] -= (-a[0]) * newVanilla[0];
+            d_vanilla[M - 2] -= (-c[M - 2]) * newVanilla[M];
+            solveTridiagonal(a, b, c, d_vanilla, interior, c_prime, d_prime);
+            for (int j = 1; j < M; ++j) {
+                newVanilla[j] = interior[j - 1];
+            }
+            vanilla.swap(newVanilla);
         }
 
-        newV[M - 1] = d_prime[M - 2];
-        for (int j = M - 2; j >= 1; --j) {
-            newV[j] = d_prime[j - 1] - c_prime[j - 1] * newV[j + 1];
+        // Solve the tridiagonal system using the Thomas algorithm.
+        if (hasBarrier) {
+            aBarrier = a;
+            bBarrier = b;
+            cBarrier = c;
+            applyBarrierRows(aBarrier, bBarrier, cBarrier, d_vec, vanilla, barrierType, barrierNode);
+            solveTridiagonal(aBarrier, bBarrier, cBarrier, d_vec, interior, c_prime, d_prime);
+        }
+        else {
+            solveTridiagonal(a, b, c, d_vec, interior, c_prime, d_prime);
+        }
+        for (int j = 1; j < M; ++j) {
+            newV[j] = interior[j - 1];
         }
 
         // Update V for the next time step.
-        for (int j = 0; j <= M; ++j) {
-            V[j] = newV[j];
-        }
+        V.swap(newV);
 
-        // Projection step for American options: update value with intrinsic payoff.
-        if (opt.getOptionStyle() == Option::OptionStyle::American) {
-            for (int j = 0; j <= M; ++j) {
-                double payoff = 0.0;
-                if (opt.getOptionType() == Option::OptionType::Call) {
-                    payoff = std::max(S[j] - K, 0.0);
-                }
-                else {
-                    payoff = std::max(K - S[j], 0.0);
-                }
-                V[j] = std::max(V[j], payoff);
-            }
+        // Projection step on exercise levels and barrier condition.
+        if (step) {
+            trace->endStep(a, b, c, V, vanilla, exerciseLevel[n] != 0);
         }
+        applyStepConstraints(V, vanilla, payoff, exerciseLevel[n] != 0, barrierType, barrierNode);
     }
 
     // Linear interpolation to obtain the option price at S0.
@@ -213,9 +853,461 @@ double CrankNicolsonPricer::price(const Option& opt) const {
         price = V[j] * (1.0 - weight) + V[j + 1] * weight;
     }
 
+    if (trace) {
+        trace->payoff = payoff;
+        trace->barrierType = barrierType;
+        trace->barrierNode = barrierNode;
+        trace->readIndex = (S0 <= 0) ? 0 : (S0 >= Smax) ? M : static_cast<int>(S0 / dS);
+        double weight = (S0 > 0 && S0 < Smax) ? (S0 - S[trace->readIndex]) / dS : 0.0;
+        trace->readWeights = (weight != 0.0) ? std::vector<double>{ 1.0 - weight, weight } : std::vector<double>{ 1.0 };
+    }
+
+    return price;
+}
+
+/**
+ * @brief Computes the option price with the fourth-order compact (HOC) scheme.
+ *
+ * In log-spot x = ln(S) the Black-Scholes PDE has constant coefficients,
+ *
+ *    V_tau = a V_xx + b V_x - r V,   a = sigma^2 / 2,   b = r - q - sigma^2 / 2,
+ *
+ * and differentiating it to eliminate the O(h^2) truncation terms of the central differences
+ * yields the compact relation
+ *
+ *    P (V_tau + r V) = L V,
+ *    L = (a + h^2 b^2 / (12 a)) delta_xx + b delta_x,
+ *    P = I + h^2 / 12 delta_xx + h^2 b / (12 a) delta_x,
+ *
+ * which is fourth-order accurate in space while both operators stay tridiagonal. Time stepping is
+ * Crank-Nicolson, so each step is a single Thomas solve as in the second-order scheme.
+ *
+ * The grid is centered on ln(S0), so the price is read directly at the central node without
+ * interpolation, and the terminal payoff is smoothed near the strike with the Kreiss Phi4 kernel
+ * to remove the kink that would otherwise reduce the observed convergence order. For barrier
+ * options the grid keeps its width and step, and its nodes are shifted by at most half a step so
+ * that ln(B) is a node; the price is then read by cubic interpolation on the side of the spot.
+ *
+ * Maturity, calculation date, local rates, barriers and early exercise are handled exactly as in price().
+ *
+ * @param opt The option to be priced.
+ * @return The computed option price.
+ * @throw std::runtime_error if the underlying, strike or volatility is not positive, or if S_max is below the spot.
+ */
+double CrankNicolsonPricer::priceHighOrderCompact(const Option& opt, RateTrace* trace) const {
+    double S0 = opt.getUnderlying();
+    double K = opt.getStrike();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+    bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+    Option::BarrierType barrierType = opt.getBarrierType();
+    bool isKnockIn = isKnockInBarrier(barrierType);
+
+    if (S0 <= 0.0 || K <= 0.0 || sigma <= 0.0) {
+        throw std::runtime_error("The high-order compact scheme requires a positive underlying, strike and volatility.");
+    }
+
+    double T = config_->maturityOf(opt);
+    double r_default = config_->riskFreeRate + bump_.rateShift;
+
+    // Adjust effective time to maturity using calculationDate if provided.
+    double T_effective = T;
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
+        auto today = std::chrono::system_clock::now();
+        double offset = DateConverter::yearsBetween(calcDate, today);
+        T_effective = T - offset;
+    }
+
+    // An even number of steps keeps ln(S0) on the central node.
+    int M = config_->crankSpotSteps;
+    if (M % 2 != 0) {
+        ++M;
+    }
+
+    std::vector<double> times;
+    std::vector<double> steps;
+    std::vector<char> exerciseLevel;
+    buildTimeGrid(opt, T_effective, T - T_effective, config_->crankTimeSteps, times, steps, exerciseLevel);
+    const int N = static_cast<int>(steps.size());
+
+    // Log-spot grid symmetric around ln(S0). S_max, if given, fixes the upper bound.
+    double halfWidth = 0.0;
+    if (config_->S_max > 0.0) {
+        if (config_->S_max <= S0) {
+            throw std::runtime_error("S_max must be greater than the underlying price.");
+        }
+        halfWidth = std::log(config_->S_max / S0);
+    }
+    else {
+        halfWidth = std::max(std::log(3.0 * std::max(K, S0) / S0),
+            std::abs(std::log(K / S0)) + 5.0 * sigma * std::sqrt(std::max(T_effective, 0.0)));
+    }
+
+    if (barrierType != Option::BarrierType::None) {
+        halfWidth = std::max(halfWidth, std::abs(std::log(opt.getBarrier() / S0)));
+    }
+    double xMin = std::log(S0) - halfWidth;
+    const double h = 2.0 * halfWidth / M;
+
+    // Align the grid with the barrier: the nodes are shifted by at most h / 2, without changing the
+    // width or the step, so that ln(B) is node barrierNode.
+    int barrierNode = -1;
+    if (barrierType != Option::BarrierType::None) {
+        double xBarrier = std::log(opt.getBarrier());
+        barrierNode = static_cast<int>(std::lround((xBarrier - xMin) / h));
+        xMin = xBarrier - barrierNode * h;
+    }
+
+    std::vector<double> S(M + 1);
+    std::vector<double> payoff(M + 1);
+    std::vector<double> V(M + 1);
+    for (int j = 0; j <= M; ++j) {
+        double x = xMin + j * h;
+        S[j] = std::exp(x);
+        payoff[j] = isCall ? std::max(S[j] - K, 0.0) : std::max(K - S[j], 0.0);
+        // Only nodes whose smoothing window contains the strike differ from the raw payoff.
+        V[j] = (std::abs(x - std::log(K)) < 3.0 * h) ? smoothedPayoff(x, h, K, isCall) : payoff[j];
+    }
+    auto knocked = [&](int j) {
+        return isUpBarrier(barrierType) ? (j >= barrierNode) : (j <= barrierNode);
+    };
+    std::vector<double> vanilla(isKnockIn ? M + 1 : 0, 0.0);
+    if (barrierType != Option::BarrierType::None) {
+        if (isKnockIn) {
+            vanilla = V;
+        }
+        for (int j = 0; j <= M; ++j) {
+            if (knocked(j) != isKnockIn) {
+                V[j] = 0.0;
+            }
+        }
+    }
+
+    std::vector<double> newV(M + 1, 0.0);
+    std::vector<double> newVanilla(vanilla.size(), 0.0);
+    std::vector<double> a(M - 1, 0.0);
+    std::vector<double> b(M - 1, 0.0);
+    std::vector<double> c(M - 1, 0.0);
+    const bool hasBarrier = (barrierType != Option::BarrierType::None);
+    std::vector<double> aBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    std::vector<double> bBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    std::vector<double> cBarrier(hasBarrier ? M - 1 : 0, 0.0);
+    if (trace) {
+        trace->barrierType = barrierType;
+        trace->barrierNode = barrierNode;
+    }
+    std::vector<double> d_vec(M - 1, 0.0);
+    std::vector<double> d_vanilla(isKnockIn ? M - 1 : 0, 0.0);
+    std::vector<double> interior(M - 1, 0.0);
+    std::vector<double> c_prime(M - 1, 0.0);
+    std::vector<double> d_prime(M - 1, 0.0);
+
+    const double diffusion = 0.5 * sigma * sigma;
+
+    for (int n = N - 1; n >= 0; --n) {
+        double t = times[n];
+        double dt = steps[n];
+        double tau = T_effective - t;
+        double normTime = (T_effective - t) / T_effective;
+        double r_local = (!config_->yieldCurve.getData().empty()) ? config_->yieldCurve.getRate(normTime) + bump_.rateShift : r_default;
+        RateTrace::Step* step = trace ? &trace->beginStep(normTime, V, vanilla) : nullptr;
+
+        // Dirichlet boundaries from the asymptotic behaviour of the option.
+        double lower = 0.0;
+        double upper = 0.0;
+        if (isCall) {
+            upper = S[M] * std::exp(-q * tau) - K * std::exp(-r_local * tau);
+        }
+        else {
+            lower = K * std::exp(-r_local * tau) - S[0] * std::exp(-q * tau);
+        }
+        if (step) {
+            // d/dr of -K exp(-r tau), the only rate-dependent term of the boundary values.
+            double dDiscountedStrike = -tau * K * std::exp(-r_local * tau);
+            step->dLowerVanilla = isCall ? 0.0 : dDiscountedStrike;
+            step->dUpperVanilla = isCall ? -dDiscountedStrike : 0.0;
+            if (opt.getOptionStyle() == Option::OptionStyle::American) {
+                step->dLowerVanilla = (lower < payoff[0]) ? 0.0 : step->dLowerVanilla;
+                step->dUpperVanilla = (upper < payoff[M]) ? 0.0 : step->dUpperVanilla;
+            }
+            bool barrier = (barrierType != Option::BarrierType::None);
+            step->dLower = (!barrier || knocked(0) == isKnockIn) ? step->dLowerVanilla : 0.0;
+            step->dUpper = (!barrier || knocked(M) == isKnockIn) ? step->dUpperVanilla : 0.0;
+        }
+        if (opt.getOptionStyle() == Option::OptionStyle::American) {
+            lower = std::max(lower, payoff[0]);
+            upper = std::max(upper, payoff[M]);
+        }
+        newV[0] = lower;
+        newV[M] = upper;
+        if (barrierType != Option::BarrierType::None) {
+            newV[0] = (knocked(0) == isKnockIn) ? lower : 0.0;
+            newV[M] = (knocked(M) == isKnockIn) ? upper : 0.0;
+            if (isKnockIn) {
+                newVanilla[0] = lower;
+                newVanilla[M] = upper;
+            }
+        }
+
+        // Stencils of L, P and Q = L - r P (identical on every interior node).
+        double drift = r_local - q - diffusion;
+        double A = diffusion + h * h * drift * drift / (12.0 * diffusion);
+        double lLow = A / (h * h) - drift / (2.0 * h);
+        double lMid = -2.0 * A / (h * h);
+        double lUp = A / (h * h) + drift / (2.0 * h);
+        double pLow = 1.0 / 12.0 - h * drift / (24.0 * diffusion);
+        double pMid = 10.0 / 12.0;
+        double pUp = 1.0 / 12.0 + h * drift / (24.0 * diffusion);
+        double qLow = lLow - r_local * pLow;
+        double qMid = lMid - r_local * pMid;
+        double qUp = lUp - r_local * pUp;
+
+        // Derivatives of the stencils with respect to the local rate (d drift / dr = 1).
+        double dA = h * h * drift / (6.0 * diffusion);
+        double dqLow = dA / (h * h) - 1.0 / (2.0 * h) - pLow + r_local * h / (24.0 * diffusion);
+        double dqMid = -2.0 * dA / (h * h) - pMid;
+        double dqUp = dA / (h * h) + 1.0 / (2.0 * h) - pUp - r_local * h / (24.0 * diffusion);
+        double dpLow = -h / (24.0 * diffusion);
+        double dpUp = h / (24.0 * diffusion);
+
+        // Crank-Nicolson: (P - dt/2 Q) V^{n} = (P + dt/2 Q) V^{n+1}.
+        for (int j = 1; j < M; ++j) {
+            a[j - 1] = pLow - 0.5 * dt * qLow;
+            b[j - 1] = pMid - 0.5 * dt * qMid;
+            c[j - 1] = pUp - 0.5 * dt * qUp;
+            d_vec[j - 1] = (pLow + 0.5 * dt * qLow) * V[j - 1]
+                + (pMid + 0.5 * dt * qMid) * V[j]
+                + (pUp + 0.5 * dt * qUp) * V[j + 1];
+            if (step) {
+                step->lo[j - 1] = pLow + 0.5 * dt * qLow;
+                step->mid[j - 1] = pMid + 0.5 * dt * qMid;
+                step->up[j - 1] = pUp + 0.5 * dt * qUp;
+                trace->da[j - 1] = dpLow - 0.5 * dt * dqLow;
+                trace->db[j - 1] = -0.5 * dt * dqMid;
+                trace->dc[j - 1] = dpUp - 0.5 * dt * dqUp;
+                trace->dlo[j - 1] = dpLow + 0.5 * dt * dqLow;
+                trace->dmid[j - 1] = 0.5 * dt * dqMid;
+                trace->dup[j - 1] = dpUp + 0.5 * dt * dqUp;
+            }
+            if (isKnockIn) {
+                d_vanilla[j - 1] = (pLow + 0.5 * dt * qLow) * vanilla[j - 1]
+                    + (pMid + 0.5 * dt * qMid) * vanilla[j]
+                    + (pUp + 0.5 * dt * qUp) * vanilla[j + 1];
+            }
+        }
+
+        d_vec[0] -= a[0] * newV[0];
+        d_vec[M - 2] -= c[M - 2] * newV[M];
+        if (step) {
+            step->couplingLow = a[0];
+            step->couplingUp = c[M - 2];
+            trace->dCouplingLow = trace->da[0];
+            trace->dCouplingUp = trace->dc[M - 2];
+        }
+
+        if (isKnockIn) {
+            d_vanilla[0] -= a[0] * newVanilla[0];
+            d_vanilla[M - 2] -= c[M - 2] * newVanilla[M];
+            solveTridiagonal(a, b, c, d_vanilla, interior, c_prime, d_prime);
+            for (int j = 1; j < M; ++j) {
+                newVanilla[j] = interior[j - 1];
+            }
+            vanilla.swap(newVanilla);
+        }
+
+        if (hasBarrier) {
+            aBarrier = a;
+            bBarrier = b;
+            cBarrier = c;
+            applyBarrierRows(aBarrier, bBarrier, cBarrier, d_vec, vanilla, barrierType, barrierNode);
+            solveTridiagonal(aBarrier, bBarrier, cBarrier, d_vec, interior, c_prime, d_prime);
+        }
+        else {
+            solveTridiagonal(a, b, c, d_vec, interior, c_prime, d_prime);
+        }
+        for (int j = 1; j < M; ++j) {
+            newV[j] = interior[j - 1];
+        }
+
+        V.swap(newV);
+
+        if (step) {
+            trace->endStep(a, b, c, V, vanilla, exerciseLevel[n] != 0);
+        }
+        applyStepConstraints(V, vanilla, payoff, exerciseLevel[n] != 0, barrierType, barrierNode);
+    }
+
+    // Without a barrier ln(S0) is the central node. Otherwise the price is interpolated with a cubic
+    // on four nodes of the side of the spot (the barrier node included), where the values are smooth.
+    int readIndex = M / 2;
+    std::vector<double> readWeights{ 1.0 };
+    if (barrierType != Option::BarrierType::None) {
+        double position = (std::log(S0) - xMin) / h;
+        readIndex = static_cast<int>(std::floor(position)) - 1;
+        readIndex = isUpBarrier(barrierType) ? std::min(readIndex, barrierNode - 3) : std::max(readIndex, barrierNode);
+        readIndex = std::max(0, std::min(readIndex, M - 3));
+        double s = position - readIndex;
+        readWeights = { -(s - 1.0) * (s - 2.0) * (s - 3.0) / 6.0, s * (s - 2.0) * (s - 3.0) / 2.0,
+            -s * (s - 1.0) * (s - 3.0) / 2.0, s * (s - 1.0) * (s - 2.0) / 6.0 };
+    }
+    double price = 0.0;
+    for (size_t k = 0; k < readWeights.size(); ++k) {
+        price += readWeights[k] * V[readIndex + k];
+    }
+
+    if (trace) {
+        trace->payoff = payoff;
+        trace->barrierType = barrierType;
+        trace->barrierNode = barrierNode;
+        trace->readIndex = readIndex;
+        trace->readWeights = readWeights;
+    }
+
     return price;
 }
 
+/**
+ * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+ *
+ * The time steps of a single pricing are recorded and differentiated by the adjoint sweep of
+ * RateTrace; the sensitivities to the local rates are then mapped onto the curve points with the
+ * interpolation weights. Their sum is the parallel-shift rho of the curve.
+ *
+ * @param opt The option to evaluate.
+ * @return The derivative of the price with respect to the rate of each curve point (empty if the
+ *         yield curve is empty).
+ */
+std::vector<double> CrankNicolsonPricer::computeKeyRateRho(const Option& opt) const {
+    std::vector<double> keyRateRho(config_->yieldCurve.getData().size(), 0.0);
+    if (keyRateRho.empty()) {
+        return keyRateRho;
+    }
+    RateTrace trace;
+    solve(opt, &trace);
+    std::vector<double> rateTimes;
+    std::vector<double> rateSensitivities;
+    trace.sensitivities(rateTimes, rateSensitivities);
+    config_->yieldCurve.addPointSensitivities(rateTimes.data(), rateSensitivities.data(), rateTimes.size(),
+        keyRateRho.data());
+    return keyRateRho;
+}
+
+/**
+ * @brief Returns the configuration without its calculation date.
+ *
+ * The batches resolve the calculation date once and give each option the maturity T - offset, the
+ * value that price() computes on every call. The offset only matters otherwise for Bermudan exercise
+ * times, which batches do not hold.
+ *
+ * @param config The configuration.
+ */
+static PricingConfiguration withoutCalculationDate(const PricingConfiguration& config) {
+    PricingConfiguration folded = config;
+    folded.calculationDate.clear();
+    return folded;
+}
+
+/**
+ * @brief Returns the number of years elapsed since the calculation date of a configuration (0 if none).
+ */
+static double calculationDateOffset(const PricingConfiguration& config) {
+    if (config.calculationDate.empty()) {
+        return 0.0;
+    }
+    auto calcDate = DateConverter::parseDate(config.calculationDate);
+    auto today = std::chrono::system_clock::now();
+    return DateConverter::yearsBetween(calcDate, today);
+}
+
+/**
+ * @brief Computes the prices of a batch of options using the Crank-Nicolson method.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ */
+void CrankNicolsonPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    const double offset = calculationDateOffset(*config_);
+    const CrankNicolsonPricer pricer(std::make_shared<const PricingConfiguration>(withoutCalculationDate(*config_)), bump_);
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 1);
+    parallelFor(count, 1, threads, [&](int, size_t begin, size_t end) {
+        Option opt;
+        for (size_t i = begin; i < end; ++i) {
+            options.load(i, opt);
+            opt.setMaturity(options.maturity(i) - offset);
+            prices[i] = pricer.solve(opt, nullptr);
+        }
+    });
+}
+
+/**
+ * @brief Computes the Greeks of a batch of options with the finite differences of computeGreeks().
+ *
+ * The three pricers of computeGreeks() (base, rates shifted up and down) are built once, with the
+ * calculation date resolved once for all of them; the shifted maturity is set on the option.
+ *
+ * @param options The options to evaluate.
+ * @param greeks Receives options.size() Greeks structures.
+ */
+void CrankNicolsonPricer::computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    const double volStep = 0.01;
+    const double rStep = 0.001;
+    const double CranktimeStep = 1.0 / 365.0;
+    const double offset = calculationDateOffset(*config_);
+
+    const std::shared_ptr<const PricingConfiguration> folded =
+        std::make_shared<const PricingConfiguration>(withoutCalculationDate(*config_));
+    const CrankNicolsonPricer base(folded, bump_);
+    const CrankNicolsonPricer pricer_r_up(folded, PricingBump(bump_.rateShift + rStep));
+    const CrankNicolsonPricer pricer_r_down(folded, PricingBump(bump_.rateShift - rStep));
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 1);
+    parallelFor(count, 1, threads, [&](int, size_t begin, size_t end) {
+        Option opt;
+        Option bumped;
+        for (size_t i = begin; i < end; ++i) {
+            options.load(i, opt);
+            opt.setMaturity(options.maturity(i) - offset);
+            double h = 0.01 * opt.getUnderlying();
+            double basePrice = base.solve(opt, nullptr);
+
+            bumped = opt;
+            bumped.setUnderlying(opt.getUnderlying() + h);
+            double price_up = base.solve(bumped, nullptr);
+            bumped.setUnderlying(opt.getUnderlying() - h);
+            double price_down = base.solve(bumped, nullptr);
+
+            bumped = opt;
+            bumped.setVolatility(opt.getVolatility() + volStep);
+            double price_vol_up = base.solve(bumped, nullptr);
+            bumped.setVolatility(opt.getVolatility() - volStep);
+            double price_vol_down = base.solve(bumped, nullptr);
+
+            bumped = opt;
+            bumped.setMaturity((options.maturity(i) - CranktimeStep) - offset);
+            double price_T_down = base.solve(bumped, nullptr);
+            double price_r_up = pricer_r_up.solve(opt, nullptr);
+            double price_r_down = pricer_r_down.solve(opt, nullptr);
+
+            Greeks& g = greeks[i];
+            g.delta = (price_up - price_down) / (2 * h);
+            g.gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+            g.vega = (price_vol_up - price_vol_down) / (2 * volStep);
+            g.theta = (price_T_down - basePrice) / (-CranktimeStep);
+            g.rho = (price_r_up - price_r_down) / (2 * rStep);
+        }
+    });
+}
+
 /**
  * @brief Computes the Greeks of the option using finite differences applied to the Crank-Nicolson pricer.
  *
@@ -255,35 +1347,18 @@ Greeks CrankNicolsonPricer::computeGreeks(const Option& opt) const {
     // --- Theta ---
     // Utiliser un pas de temps d'un jour (en annes)
     double CranktimeStep = 1.0 / 365.0;
-    // Crer une nouvelle configuration avec la maturit rduite de timeStep
-    PricingConfiguration config_T_down = config_;
-    config_T_down.maturity = config_.maturity - CranktimeStep;
-    // Recalculer le prix avec cette configuration modifie
-    CrankNicolsonPricer pricer_T_down(config_T_down);
-    double price_T_down = pricer_T_down.price(opt);
+    // Recalculer le prix de la mme option, avec la maturit rduite de timeStep
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - CranktimeStep);
+    double price_T_down = price(opt_T_down);
     // Calculer Theta avec une diffrence finie arrire
     double theta = (price_T_down - basePrice) / (-CranktimeStep);
 
 
     // --- Rho ---
-    PricingConfiguration config_r_up = config_;
-    PricingConfiguration config_r_down = config_;
-    if (!config_.yieldCurve.getData().empty()) {
-        YieldCurve yc_up;
-        YieldCurve yc_down;
-        for (const auto& pt : config_.yieldCurve.getData()) {
-            yc_up.addRatePoint(pt.maturity, pt.rate + rStep);
-            yc_down.addRatePoint(pt.maturity, pt.rate - rStep);
-        }
-        config_r_up.yieldCurve = yc_up;
-        config_r_down.yieldCurve = yc_down;
-    }
-    else {
-        config_r_up.riskFreeRate = config_.riskFreeRate + rStep;
-        config_r_down.riskFreeRate = config_.riskFreeRate - rStep;
-    }
-    CrankNicolsonPricer pricer_r_up(config_r_up);
-    CrankNicolsonPricer pricer_r_down(config_r_down);
+    // The bumped pricers share the configuration and only shift the rates.
+    CrankNicolsonPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    CrankNicolsonPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
     double price_r_up = pricer_r_up.price(opt);
     double price_r_down = pricer_r_down.price(opt);
     double rho = (price_r_up - price_r_down) / (2 * rStep);
@@ -13,6 +13,8 @@
 #include "pch.h"
 #include "InterfaceOptionPricer.hpp"
 #include "PricingConfiguration.hpp"
+#include <memory>
+#include <vector>
 
 
  /**
@@ -44,6 +46,40 @@ public:
      */
     virtual Greeks computeGreeks(const Option& opt) const override;
 
+    /**
+     * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+     *
+     * The sensitivities to the local rates are obtained by the discrete adjoint of the time stepping,
+     * recorded during a single pricing, so the cost does not depend on the number of curve points.
+     *
+     * @param opt The option to evaluate.
+     * @return The derivative of the price with respect to the rate of each curve point (empty if
+     *         the yield curve is empty).
+     */
+    std::vector<double> computeKeyRateRho(const Option& opt) const;
+
+    /**
+     * @brief Computes the prices of a batch of options.
+     *
+     * Each option is priced at its maturity in the batch. The calculation date is resolved once for
+     * the batch instead of once per option, and the options, each solved on its own grid, are distributed over config.batchThreads threads. The
+     * prices are identical to those of price().
+     *
+     * @param options The options to be priced.
+     * @param prices Receives options.size() prices.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const override;
+
+    /**
+     * @brief Computes the Greeks of a batch of options, with the finite differences of computeGreeks().
+     *
+     * The pricers of the shifted rates are set up once for the batch, instead of once per option.
+     *
+     * @param options The options to evaluate.
+     * @param greeks Receives options.size() Greeks structures.
+     */
+    virtual void computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const override;
+
     /**
     * @brief Constructor with pricing configuration.
     * @param config A PricingConfiguration structure containing additional parameters,
@@ -51,8 +87,40 @@ public:
     */
     CrankNicolsonPricer(const PricingConfiguration& config);
 
+    /**
+    * @brief Constructor sharing a configuration, with an optional bump overlay.
+    *
+    * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+    *
+    * @param config The shared configuration (not null).
+    * @param bump The overlay applied on top of the configuration.
+    */
+    CrankNicolsonPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
 private:
-    PricingConfiguration config_; ///< Additional configuration parameters for the Crank-Nicolson model.
+    /**
+     * @brief Record of the time steps of a pricing, used to compute the sensitivities to the local rates.
+     */
+    struct RateTrace;
+
+    /**
+     * @brief Computes the price with the second-order scheme (or delegates to the compact scheme).
+     * @param opt The option to be priced.
+     * @param trace If not null, receives the record of the time steps.
+     * @return The computed option price.
+     */
+    double solve(const Option& opt, RateTrace* trace) const;
+
+    /**
+     * @brief Computes the price with the fourth-order compact scheme on a log-spot grid.
+     * @param opt The option to be priced.
+     * @param trace If not null, receives the record of the time steps.
+     * @return The computed option price.
+     */
+    double priceHighOrderCompact(const Option& opt, RateTrace* trace) const;
+
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the Crank-Nicolson model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
 };
 
 #endif // CRANKNICOLSONPRICER_HPP
@@ -40,6 +40,39 @@ extern "C" {
         int crankTimeSteps, int crankSpotSteps, double S_max,
         double* delta, double* gamma, double* vega, double* theta, double* rho);
 
+    // Function to compute the key-rate rho (one value per yield curve point) using the Crank-Nicolson model.
+    // The sensitivities of the price to the rate of each curve point are written to keyRateRho
+    // (at most capacity values). Returns the number of curve points, or -1 on error.
+    CRANK_NICOLSON_API int __stdcall ComputeOptionKeyRateRhoCrankNicolson(
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int crankTimeSteps, int crankSpotSteps, double S_max,
+        double* keyRateRho, int capacity);
+
+    // Batch version of PriceOptionCrankNicolson, to price a whole range in one call.
+    // The inputs S to optionStyle are arrays of count values (one per option); the calculation date
+    // and the model parameters are shared by all the options. The price of option i is written to
+    // prices[i] (-1 if this option fails). Returns the number of options priced without error, or -1
+    // if the arguments are invalid.
+    // Each option is priced with its own rate r[i], exactly as by PriceOptionCrankNicolson with the same arguments.
+    CRANK_NICOLSON_API int __stdcall PriceOptionCrankNicolsonBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int crankTimeSteps, int crankSpotSteps, double S_max,
+        double* prices);
+
+    // Batch version of ComputeOptionGreeksCrankNicolson. The Greeks of option i are written at index i of the
+    // arrays provided (a null array is skipped; NAN if this option fails).
+    // Returns the number of options computed without error, or -1 if the arguments are invalid.
+    // The rates are handled as in PriceOptionCrankNicolsonBatch.
+    CRANK_NICOLSON_API int __stdcall ComputeOptionGreeksCrankNicolsonBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int crankTimeSteps, int crankSpotSteps, double S_max,
+        double* delta, double* gamma, double* vega, double* theta, double* rho);
+
 #ifdef __cplusplus
 }
 #endif
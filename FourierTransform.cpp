@@ -0,0 +1,139 @@
+/**
+ * @file FourierTransform.cpp
+ * @brief Implementation of the in-tree fast Fourier transform.
+ *
+ * Power-of-two sizes use the iterative radix-2 algorithm. Other sizes use a recursive mixed-radix
+ * decimation in time: a size n = p m, with p the smallest prime factor of n, is split into p
+ * interleaved subsequences of size m whose transforms are combined with a direct DFT of size p.
+ * The cost is O(n (p1 + p2 + ...)) for n = p1 p2 ..., hence O(n log n) for smooth sizes.
+ */
+
+#include "pch.h"
+#include "FourierTransform.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846 // Definition of the constant PI
+#endif
+
+namespace {
+
+    /**
+     * @brief In-place iterative radix-2 transform (without the 1/n scaling), for power-of-two sizes.
+     */
+    void fftRadix2(std::vector<std::complex<double>>& data, bool inverse) {
+        const size_t n = data.size();
+
+        // Bit-reversal permutation.
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+
+        // Butterflies, doubling the transform length at each stage. The twiddle factors of each stage are
+        // computed directly rather than by repeated multiplication, which would accumulate rounding errors.
+        std::vector<std::complex<double>> twiddles;
+        for (size_t length = 2; length <= n; length <<= 1) {
+            const size_t half = length / 2;
+            double angle = (inverse ? 2.0 : -2.0) * M_PI / static_cast<double>(length);
+            twiddles.resize(half);
+            for (size_t k = 0; k < half; ++k) {
+                twiddles[k] = std::polar(1.0, angle * static_cast<double>(k));
+            }
+            for (size_t start = 0; start < n; start += length) {
+                for (size_t k = 0; k < half; ++k) {
+                    std::complex<double> even = data[start + k];
+                    std::complex<double> odd = data[start + k + half] * twiddles[k];
+                    data[start + k] = even + odd;
+                    data[start + k + half] = even - odd;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Recursive mixed-radix transform (without the 1/n scaling) of the n values
+     *        in[0], in[stride], ..., written contiguously to out.
+     */
+    void fftMixedRadix(const std::complex<double>* in, size_t stride, size_t n,
+        std::complex<double>* out, bool inverse) {
+        if (n == 1) {
+            out[0] = in[0];
+            return;
+        }
+
+        size_t p = 2;
+        while (n % p != 0 && p * p <= n) {
+            ++p;
+        }
+        if (n % p != 0) {
+            p = n; // n is prime: direct DFT below
+        }
+        const size_t m = n / p;
+
+        // Transforms of the p subsequences in[r], in[r + p], ... stored in out[r m .. r m + m).
+        for (size_t r = 0; r < p; ++r) {
+            fftMixedRadix(in + r * stride, stride * p, m, out + r * m, inverse);
+        }
+
+        // X[k + m s] = sum_r w^(r (k + m s)) Y_r[k] with w = exp(-/+ 2 i pi / n).
+        const double angle = (inverse ? 2.0 : -2.0) * M_PI / static_cast<double>(n);
+        std::vector<std::complex<double>> roots(p); // p-th roots of unity w^(m j)
+        for (size_t j = 0; j < p; ++j) {
+            roots[j] = std::polar(1.0, angle * static_cast<double>(m * j));
+        }
+        std::vector<std::complex<double>> column(p);
+        for (size_t k = 0; k < m; ++k) {
+            for (size_t r = 0; r < p; ++r) {
+                column[r] = out[r * m + k] * std::polar(1.0, angle * static_cast<double>(r * k));
+            }
+            for (size_t s = 0; s < p; ++s) {
+                std::complex<double> sum = 0.0;
+                for (size_t r = 0; r < p; ++r) {
+                    sum += column[r] * roots[(r * s) % p];
+                }
+                out[k + m * s] = sum;
+            }
+        }
+    }
+
+} // namespace
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+void fft(std::vector<std::complex<double>>& data, bool inverse) {
+    const size_t n = data.size();
+    if (n == 0) {
+        throw std::invalid_argument("The FFT size must be positive.");
+    }
+
+    if ((n & (n - 1)) == 0) {
+        fftRadix2(data, inverse);
+    }
+    else {
+        std::vector<std::complex<double>> result(n);
+        fftMixedRadix(data.data(), 1, n, result.data(), inverse);
+        data.swap(result);
+    }
+
+    if (inverse) {
+        for (auto& value : data) {
+            value /= static_cast<double>(n);
+        }
+    }
+}
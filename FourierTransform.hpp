@@ -0,0 +1,37 @@
+#ifndef FOURIERTRANSFORM_HPP
+#define FOURIERTRANSFORM_HPP
+
+/**
+ * @file FourierTransform.hpp
+ * @brief Declaration of the in-tree fast Fourier transform used by the Fourier-based engines.
+ *
+ * The transform is implemented in the project itself so that the DLL has no external numerical
+ * dependency.
+ */
+
+#include "pch.h"
+#include <vector>
+#include <complex>
+
+/**
+ * @brief Computes the discrete Fourier transform of a sequence in place.
+ *
+ * The forward transform is X[k] = sum_n x[n] exp(-2 i pi k n / N); the inverse transform uses the
+ * opposite sign and divides by N, so that an inverse transform undoes a forward one.
+ * Power-of-two sizes use the iterative radix-2 Cooley-Tukey algorithm and other sizes a mixed-radix
+ * decomposition, which is fastest when the size has only small prime factors.
+ *
+ * @param data The sequence to transform, overwritten by its transform.
+ * @param inverse True for the inverse transform.
+ * @throw std::invalid_argument if the sequence is empty.
+ */
+void fft(std::vector<std::complex<double>>& data, bool inverse);
+
+/**
+ * @brief Returns the smallest power of two greater than or equal to n.
+ * @param n The requested minimal size.
+ * @return The power of two.
+ */
+size_t nextPowerOfTwo(size_t n);
+
+#endif // FOURIERTRANSFORM_HPP
@@ -0,0 +1,27 @@
+/**
+ * @file InterfaceOptionPricer.cpp
+ * @brief Default implementations of the batch methods and of prepare() of IOptionPricer.
+ */
+
+#include "pch.h"
+#include "InterfaceOptionPricer.hpp"
+#include "OptionBatch.hpp"
+
+void IOptionPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    Option opt;
+    for (size_t i = 0; i < options.size(); ++i) {
+        options.load(i, opt);
+        prices[i] = price(opt);
+    }
+}
+
+void IOptionPricer::computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const {
+    Option opt;
+    for (size_t i = 0; i < options.size(); ++i) {
+        options.load(i, opt);
+        greeks[i] = computeGreeks(opt);
+    }
+}
+
+void IOptionPricer::prepare() {
+}
@@ -9,6 +9,8 @@
 #include "pch.h"
 #include "Option.hpp"
 
+class OptionBatchView;
+
  /**
   * @brief Interface pour un moteur de pricing d'options.
   *
@@ -34,6 +36,49 @@ public:
      * @return Une structure Greeks contenant les greeks calculs.
      */
     virtual Greeks computeGreeks(const Option& opt) const = 0;
+
+    /**
+     * @brief Calcule le prix de chaque option d'un lot.
+     *
+     * Chaque option est value  sa maturit dans le lot, comme une option dont la maturit propre
+     * est donne par Option::setMaturity() : un mme moteur value ainsi des options d'chances
+     * diffrentes. L'implmentation par dfaut appelle price() pour chaque
+     * option ; les moteurs la redfinissent pour mettre en commun les calculs qui ne dpendent pas
+     * de l'option ou pour rpartir le lot entre plusieurs threads.
+     *
+     * @param options Les options  valuer.
+     * @param prices Reoit options.size() prix (le prix de l'option i  l'indice i).
+     * @throw Les mmes exceptions que price(), pour la premire option qui ne peut tre value ;
+     *        les prix dj crits sont alors indtermins.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const;
+
+    /**
+     * @brief Calcule les greeks de chaque option d'un lot.
+     *
+     * Mme fonctionnement que priceBatch(), avec computeGreeks().
+     *
+     * @param options Les options  valuer.
+     * @param greeks Reoit options.size() structures Greeks (celles de l'option i  l'indice i).
+     * @throw Les mmes exceptions que computeGreeks(), pour la premire option qui ne peut tre value.
+     */
+    virtual void computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const;
+
+    /**
+     * @brief Prcalcule les tables qui ne dpendent que de la configuration du moteur.
+     *
+     * Les valuations suivantes rutilisent ces tables au lieu de les recalculer  chaque appel,
+     * avec des rsultats identiques. L'appel est facultatif : PricerFactory::acquirePricer() le fait
+     * une fois pour chaque moteur qu'elle met en commun. L'implmentation par dfaut ne fait rien.
+     * Le moteur ne doit pas tre utilis par un autre thread pendant l'appel.
+     *
+     * C'est un point d'extension facultatif, que seul MonteCarloPricer redfinit (tirages normaux
+     * partags par nombre de chemins et de pas). Les tables des autres moteurs (niveaux de l'arbre
+     * binomial, grilles et coefficients des EDP, termes de la fonction caractristique) dpendent de
+     * la maturit ou de la volatilit de l'option : elles sont calcules  chaque valuation, et mises
+     * en commun entre les options d'un lot par priceBatch().
+     */
+    virtual void prepare();
 };
 
 #endif // IOPTIONPRICER_HPP
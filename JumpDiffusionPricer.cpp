@@ -0,0 +1,323 @@
+/**
+ * @file JumpDiffusionPricer.cpp
+ * @brief Implementation of the JumpDiffusionPricer class (Merton and Kou PIDE solver).
+ *
+ * In the log-spot variable x = ln(S / S0) and time to maturity tau, the option value solves
+ *
+ *    u_tau = 1/2 sigma^2 u_xx + (r - q - 1/2 sigma^2 - lambda kappa) u_x - (r + lambda) u
+ *            + lambda * integral u(x + y) f(y) dy,
+ *
+ * where f is the density of the log-jump size and kappa = E[exp(Y)] - 1 the jump compensator.
+ * On a uniform grid of step h the integral becomes sum_k w_k u_{i+k}, where w_k is the mass of f
+ * on the cell [(k - 1/2) h, (k + 1/2) h]. The compensator is computed from the same weights so that
+ * the discrete scheme stays risk neutral. The convolution is a single FFT product per time step:
+ * the grid is padded on both sides with the asymptotic option values and the transform of the
+ * weights is computed once per pricing.
+ *
+ * Time stepping is IMEX: Crank-Nicolson for the differential part and second-order Adams-Bashforth
+ * for the jump term (explicit Euler on the first step), so each step is a single tridiagonal solve.
+ */
+
+#include "pch.h"
+#include "JumpDiffusionPricer.hpp"
+#include "Option.hpp"
+#include "DateConverter.hpp"
+#include "TridiagonalSolver.hpp"
+#include "FourierTransform.hpp"
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+    /**
+     * @brief Standard normal cumulative distribution function.
+     */
+    double normalCdf(double x) {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    /**
+     * @brief Cumulative distribution function of the log-jump size.
+     */
+    double jumpCdf(const PricingConfiguration& config, double y) {
+        if (config.jumpModel == JumpModel::Merton) {
+            return normalCdf((y - config.mertonJumpMean) / config.mertonJumpVolatility);
+        }
+        double p = config.kouUpProbability;
+        if (y < 0.0) {
+            return (1.0 - p) * std::exp(config.kouDownRate * y);
+        }
+        return (1.0 - p) + p * (1.0 - std::exp(-config.kouUpRate * y));
+    }
+
+} // namespace
+
+/// Default constructor, using default configuration values.
+JumpDiffusionPricer::JumpDiffusionPricer()
+    : config_(std::make_shared<const PricingConfiguration>())
+{
+    // No additional initialization required.
+}
+
+/// Constructor with pricing configuration.
+JumpDiffusionPricer::JumpDiffusionPricer(const PricingConfiguration& config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
+{
+    // The configuration parameters are now stored in config_.
+}
+
+/// Constructor sharing a configuration, with a bump overlay.
+JumpDiffusionPricer::JumpDiffusionPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
+/// Destructor.
+JumpDiffusionPricer::~JumpDiffusionPricer() {
+    // No dynamic cleanup is required.
+}
+
+/**
+ * @brief Computes the option price by solving the jump-diffusion PIDE.
+ *
+ * The grid uses crankSpotSteps log-spot steps centered on the current spot and crankTimeSteps time
+ * steps. Its half-width covers six standard deviations of the log-return (diffusion and jumps) around
+ * the strike, and at least ln(S_max / S0) when S_max is set. The risk-free rate at each step is
+ * interpolated from the yield curve, or taken from riskFreeRate when no curve is loaded.
+ * American options are handled by projection onto the payoff after each time step.
+ *
+ * @param opt The option to be priced.
+ * @return The computed option price.
+ * @throw std::runtime_error if the option is not vanilla, the grid is too small or the jump
+ *        parameters are inconsistent.
+ */
+double JumpDiffusionPricer::price(const Option& opt) const {
+    if (opt.getBarrierType() != Option::BarrierType::None || opt.getOptionStyle() == Option::OptionStyle::Bermudan) {
+        throw std::runtime_error("JumpDiffusionPricer supports only vanilla European and American options.");
+    }
+
+    double S0 = opt.getUnderlying();
+    double K = opt.getStrike();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+    bool isCall = (opt.getOptionType() == Option::OptionType::Call);
+    bool isAmerican = (opt.getOptionStyle() == Option::OptionStyle::American);
+
+    double T = config_->maturityOf(opt);
+    double r_default = config_->riskFreeRate + bump_.rateShift;
+
+    // Adjust effective time to maturity using calculationDate if provided.
+    double T_effective = T;
+    if (!config_->calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config_->calculationDate);
+        auto today = std::chrono::system_clock::now();
+        double offset = DateConverter::yearsBetween(calcDate, today);
+        T_effective = T - offset;
+    }
+
+    // The spot sits on the middle node, hence an even number of steps.
+    int M = config_->crankSpotSteps;
+    M += M % 2;
+    const int N = config_->crankTimeSteps;
+    if (M < 4 || N < 1) {
+        throw std::runtime_error("The jump-diffusion grid requires at least 4 spot steps and 1 time step.");
+    }
+
+    const double lambda = config_->jumpIntensity;
+    if (lambda < 0.0) {
+        throw std::runtime_error("The jump intensity must be non-negative.");
+    }
+    double jumpSecondMoment = 0.0; // E[Y^2]
+    double jumpRange = 0.0;        // Half-width of the support of the jump weights
+    if (config_->jumpModel == JumpModel::Merton) {
+        if (config_->mertonJumpVolatility <= 0.0) {
+            throw std::runtime_error("The Merton model requires a positive jump volatility.");
+        }
+        double mu = config_->mertonJumpMean;
+        double delta = config_->mertonJumpVolatility;
+        jumpSecondMoment = mu * mu + delta * delta;
+        jumpRange = std::abs(mu) + 8.0 * delta;
+    }
+    else {
+        double p = config_->kouUpProbability;
+        double eta1 = config_->kouUpRate;
+        double eta2 = config_->kouDownRate;
+        if (p < 0.0 || p > 1.0 || eta1 <= 1.0 || eta2 <= 0.0) {
+            throw std::runtime_error("The Kou model requires 0 <= p <= 1, an upward rate above 1 and a positive downward rate.");
+        }
+        jumpSecondMoment = 2.0 * p / (eta1 * eta1) + 2.0 * (1.0 - p) / (eta2 * eta2);
+        jumpRange = 28.0 / std::min(eta1, eta2); // Tail mass below 1e-12
+    }
+
+    // Log-spot grid x_i = (i - M/2) h.
+    double totalVariance = (sigma * sigma + lambda * jumpSecondMoment) * T_effective;
+    double halfWidth = std::abs(std::log(K / S0)) + 6.0 * std::sqrt(totalVariance);
+    if (config_->S_max > S0) {
+        halfWidth = std::max(halfWidth, std::log(config_->S_max / S0));
+    }
+    halfWidth = std::max(halfWidth, 0.5);
+    const double h = 2.0 * halfWidth / M;
+    const int center = M / 2;
+    std::vector<double> S(M + 1);
+    std::vector<double> payoff(M + 1);
+    for (int i = 0; i <= M; ++i) {
+        S[i] = S0 * std::exp((i - center) * h);
+        payoff[i] = isCall ? std::max(S[i] - K, 0.0) : std::max(K - S[i], 0.0);
+    }
+
+    // Jump weights w_k, k = -P..P, and the matching discrete compensator.
+    const int P = std::max(1, static_cast<int>(std::ceil(jumpRange / h)));
+    std::vector<double> weights(2 * P + 1);
+    double kappa = -1.0;
+    for (int k = -P; k <= P; ++k) {
+        double w = jumpCdf(*config_, (k + 0.5) * h) - jumpCdf(*config_, (k - 0.5) * h);
+        weights[k + P] = w;
+        kappa += w * std::exp(k * h);
+    }
+
+    // Transform of the reversed weights, g[j] = w_{P - j}. The padded grid holds M + 1 + 2P values
+    // and (J u)_i is entry i + 2P of the linear convolution.
+    const int extended = M + 1 + 2 * P;
+    const size_t fftSize = nextPowerOfTwo(static_cast<size_t>(extended + 2 * P));
+    std::vector<std::complex<double>> kernel(fftSize, 0.0);
+    for (int j = 0; j <= 2 * P; ++j) {
+        kernel[j] = weights[2 * P - j];
+    }
+    fft(kernel, false);
+    std::vector<std::complex<double>> buffer(fftSize);
+
+    // Asymptotic option value, used on the boundaries and on the padding nodes.
+    auto farValue = [&](double s, double tau, double r) {
+        double value = isCall ? std::max(s * std::exp(-q * tau) - K * std::exp(-r * tau), 0.0)
+            : std::max(K * std::exp(-r * tau) - s * std::exp(-q * tau), 0.0);
+        if (isAmerican) {
+            value = std::max(value, isCall ? std::max(s - K, 0.0) : std::max(K - s, 0.0));
+        }
+        return value;
+    };
+
+    // Computes out_i = sum_k w_k u(x_i + k h) on the interior nodes.
+    auto applyJumps = [&](const std::vector<double>& u, double tau, double r, std::vector<double>& out) {
+        std::fill(buffer.begin(), buffer.end(), 0.0);
+        for (int m = 0; m < extended; ++m) {
+            int i = m - P;
+            buffer[m] = (i >= 0 && i <= M) ? u[i] : farValue(S0 * std::exp((i - center) * h), tau, r);
+        }
+        fft(buffer, false);
+        for (size_t m = 0; m < fftSize; ++m) {
+            buffer[m] *= kernel[m];
+        }
+        fft(buffer, true);
+        for (int i = 1; i < M; ++i) {
+            out[i] = buffer[i + 2 * P].real();
+        }
+    };
+
+    // Terminal condition and workspaces.
+    std::vector<double> U = payoff;
+    std::vector<double> jump(M + 1, 0.0), jumpPrevious(M + 1, 0.0);
+    std::vector<double> a(M - 1), b(M - 1), c(M - 1), d(M - 1), x(M - 1), c_prime(M - 1), d_prime(M - 1);
+
+    const double dt = T_effective / N;
+    double r_previous = (!config_->yieldCurve.getData().empty()) ? config_->yieldCurve.getRate(0.0) + bump_.rateShift : r_default;
+    for (int n = 0; n < N; ++n) {
+        double tau = (n + 1) * dt;
+        double normTime = tau / T_effective;
+        double r = (!config_->yieldCurve.getData().empty()) ? config_->yieldCurve.getRate(normTime) + bump_.rateShift : r_default;
+
+        // Differential operator coefficients (per unit of dt).
+        double diffusion = 0.5 * sigma * sigma / (h * h);
+        double drift = (r - q - 0.5 * sigma * sigma - lambda * kappa) / (2.0 * h);
+        double lower = diffusion - drift;
+        double upper = diffusion + drift;
+        double diagonal = -2.0 * diffusion - (r + lambda);
+
+        // Explicit jump term: Adams-Bashforth after the first step.
+        std::swap(jump, jumpPrevious);
+        applyJumps(U, n * dt, r_previous, jump);
+        for (int i = 1; i < M; ++i) {
+            double explicitJump = (n == 0) ? jump[i] : 1.5 * jump[i] - 0.5 * jumpPrevious[i];
+            a[i - 1] = -0.5 * dt * lower;
+            b[i - 1] = 1.0 - 0.5 * dt * diagonal;
+            c[i - 1] = -0.5 * dt * upper;
+            d[i - 1] = U[i] + 0.5 * dt * (lower * U[i - 1] + diagonal * U[i] + upper * U[i + 1])
+                + dt * lambda * explicitJump;
+        }
+
+        double low = farValue(S[0], tau, r);
+        double high = farValue(S[M], tau, r);
+        d[0] -= a[0] * low;
+        d[M - 2] -= c[M - 2] * high;
+        solveTridiagonal(a, b, c, d, x, c_prime, d_prime);
+
+        U[0] = low;
+        for (int i = 1; i < M; ++i) {
+            U[i] = isAmerican ? std::max(x[i - 1], payoff[i]) : x[i - 1];
+        }
+        U[M] = high;
+        r_previous = r;
+    }
+
+    return U[center];
+}
+
+/**
+ * @brief Computes the Greeks of the option using finite differences applied to the PIDE pricer.
+ *
+ * The Greeks (Delta, Gamma, Vega, Theta, and Rho) are estimated by perturbing the input parameters
+ * and recalculating the option price. Vega is the sensitivity to the diffusion volatility, with
+ * the jump parameters held fixed.
+ *
+ * @param opt The option to evaluate.
+ * @return A Greeks structure containing the calculated values.
+ */
+Greeks JumpDiffusionPricer::computeGreeks(const Option& opt) const {
+    double h = 0.01 * opt.getUnderlying();
+    double volStep = 0.01;
+    double rStep = 0.001;
+    double timeStep = 1.0 / 365.0; // One day
+
+    double basePrice = price(opt);
+
+    // --- Delta ---
+    Option opt_up = opt;
+    Option opt_down = opt;
+    opt_up.setUnderlying(opt.getUnderlying() + h);
+    opt_down.setUnderlying(opt.getUnderlying() - h);
+    double price_up = price(opt_up);
+    double price_down = price(opt_down);
+    double delta = (price_up - price_down) / (2 * h);
+
+    // --- Gamma ---
+    double gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+
+    // --- Vega ---
+    Option opt_vol_up = opt;
+    Option opt_vol_down = opt;
+    opt_vol_up.setVolatility(opt.getVolatility() + volStep);
+    opt_vol_down.setVolatility(opt.getVolatility() - volStep);
+    double vega = (price(opt_vol_up) - price(opt_vol_down)) / (2 * volStep);
+
+    // --- Theta ---
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - timeStep);
+    double price_T_down = price(opt_T_down);
+    double theta = (price_T_down - basePrice) / (-timeStep);
+
+    // --- Rho ---
+    // The bumped pricers share the configuration and only shift the rates.
+    JumpDiffusionPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    JumpDiffusionPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
+    double rho = (pricer_r_up.price(opt) - pricer_r_down.price(opt)) / (2 * rStep);
+
+    Greeks greeks;
+    greeks.delta = delta;
+    greeks.gamma = gamma;
+    greeks.vega = vega;
+    greeks.theta = theta;
+    greeks.rho = rho;
+    return greeks;
+}
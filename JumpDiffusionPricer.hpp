@@ -0,0 +1,70 @@
+#ifndef JUMPDIFFUSIONPRICER_HPP
+#define JUMPDIFFUSIONPRICER_HPP
+
+/**
+ * @file JumpDiffusionPricer.hpp
+ * @brief Declaration of the JumpDiffusionPricer class.
+ *
+ * This class implements option pricing under the Merton and Kou jump-diffusion models by solving
+ * the partial integro-differential equation (PIDE) of the model on a log-spot grid. The jump
+ * integral is evaluated as a discrete convolution with the in-tree FFT and treated explicitly,
+ * while the diffusion part is treated implicitly (IMEX Crank-Nicolson / Adams-Bashforth scheme).
+ */
+
+#include "pch.h"
+#include "InterfaceOptionPricer.hpp"
+#include "PricingConfiguration.hpp"
+#include <memory>
+
+/**
+ * @brief Class that implements the jump-diffusion PIDE pricing model.
+ */
+class JumpDiffusionPricer : public IOptionPricer {
+public:
+    /**
+     * @brief Default constructor.
+     */
+    JumpDiffusionPricer();
+
+    /**
+     * @brief Constructor with pricing configuration.
+     * @param config A PricingConfiguration structure containing additional parameters,
+     *               such as the calculation date, maturity, grid sizes and jump parameters.
+     */
+    JumpDiffusionPricer(const PricingConfiguration& config);
+
+    /**
+     * @brief Constructor sharing a configuration, with an optional bump overlay.
+     *
+     * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+     *
+     * @param config The shared configuration (not null).
+     * @param bump The overlay applied on top of the configuration.
+     */
+    JumpDiffusionPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~JumpDiffusionPricer();
+
+    /**
+     * @brief Computes the price of the option by solving the jump-diffusion PIDE.
+     * @param opt The option to be priced.
+     * @return The computed option price.
+     */
+    virtual double price(const Option& opt) const override;
+
+    /**
+     * @brief Computes the Greeks of the option using finite differences applied to the PIDE pricer.
+     * @param opt The option to evaluate.
+     * @return A Greeks structure containing the calculated values.
+     */
+    virtual Greeks computeGreeks(const Option& opt) const override;
+
+private:
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the jump-diffusion model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
+};
+
+#endif // JUMPDIFFUSIONPRICER_HPP
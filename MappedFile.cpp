@@ -0,0 +1,153 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of the memory mapping shared by the portfolio files and the market-data snapshots.
+ */
+
+#include "pch.h"
+#include "MappedFile.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::uint64_t fnv1a(const unsigned char* data, size_t length) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile()
+    : file_(INVALID_HANDLE_VALUE),
+    mapping_(nullptr),
+    base_(nullptr),
+    size_(0)
+{
+}
+
+MappedFile::~MappedFile() {
+    if (base_) {
+        UnmapViewOfFile(base_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+    }
+}
+
+void MappedFile::openForReading(const std::string& path, size_t minimumSize, const std::string& kind) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open " + kind + " file: " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart < static_cast<LONGLONG>(minimumSize)) {
+        throw std::runtime_error("The " + kind + " file is too small: " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+    base_ = static_cast<unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!base_) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+}
+
+void MappedFile::createForWriting(const std::string& path, size_t size, const std::string& kind) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot create " + kind + " file: " + path);
+    }
+    // Mapping with an explicit size extends the file (with zeros) to that size.
+    size_ = size;
+    const std::uint64_t length = size;
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(length >> 32), static_cast<DWORD>(length & 0xFFFFFFFFu), nullptr);
+    if (!mapping_) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+    base_ = static_cast<unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, 0));
+    if (!base_) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+}
+
+void MappedFile::flush() {
+    if (!FlushViewOfFile(base_, 0)) {
+        throw std::runtime_error("Cannot flush mapped file.");
+    }
+}
+
+#else
+
+MappedFile::MappedFile()
+    : file_(-1),
+    base_(nullptr),
+    size_(0)
+{
+}
+
+MappedFile::~MappedFile() {
+    if (base_) {
+        munmap(base_, size_);
+    }
+    if (file_ >= 0) {
+        close(file_);
+    }
+}
+
+void MappedFile::openForReading(const std::string& path, size_t minimumSize, const std::string& kind) {
+    file_ = ::open(path.c_str(), O_RDONLY);
+    if (file_ < 0) {
+        throw std::runtime_error("Cannot open " + kind + " file: " + path);
+    }
+    struct stat status;
+    if (fstat(file_, &status) != 0 || status.st_size < static_cast<off_t>(minimumSize)) {
+        throw std::runtime_error("The " + kind + " file is too small: " + path);
+    }
+    size_ = static_cast<size_t>(status.st_size);
+
+    void* base = mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_, 0);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+    base_ = static_cast<unsigned char*>(base);
+}
+
+void MappedFile::createForWriting(const std::string& path, size_t size, const std::string& kind) {
+    file_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file_ < 0) {
+        throw std::runtime_error("Cannot create " + kind + " file: " + path);
+    }
+    size_ = size;
+    if (ftruncate(file_, static_cast<off_t>(size_)) != 0) {
+        throw std::runtime_error("Cannot extend " + kind + " file: " + path);
+    }
+    void* base = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + kind + " file: " + path);
+    }
+    base_ = static_cast<unsigned char*>(base);
+}
+
+void MappedFile::flush() {
+    if (msync(base_, size_, MS_SYNC) != 0) {
+        throw std::runtime_error("Cannot flush mapped file.");
+    }
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+/**
+ * @file MappedFile.hpp
+ * @brief Declaration of the memory mapping shared by the portfolio files and the market-data snapshots.
+ *
+ * Both formats start with a 64-byte header (magic, format version, directory size, file size and
+ * checksum) followed by a directory of fixed-size entries. MappedFile maps such a file, read-only
+ * or for writing, and checks the part of the header that does not depend on the format.
+ *
+ * Files are mapped with the Win32 file-mapping functions on Windows and with mmap elsewhere.
+ */
+
+#include "pch.h"
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash used as the checksum of mapped files.
+ */
+std::uint64_t fnv1a(const unsigned char* data, size_t length);
+
+/**
+ * @brief A file mapped into memory, read-only or for writing.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Creates an object that maps no file.
+     */
+    MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Unmaps and closes the file.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Maps an existing file read-only.
+     * @param path The path of the file.
+     * @param minimumSize The smallest valid size (the size of the header).
+     * @param kind The name of the format in error messages ("portfolio", "snapshot").
+     * @throw std::runtime_error if the file cannot be mapped or is smaller than minimumSize.
+     */
+    void openForReading(const std::string& path, size_t minimumSize, const std::string& kind);
+
+    /**
+     * @brief Creates (or truncates) a file of the given size and maps it for writing.
+     * @throw std::runtime_error if the file cannot be created or mapped.
+     */
+    void createForWriting(const std::string& path, size_t size, const std::string& kind);
+
+    /**
+     * @brief Writes the modified pages of a file mapped for writing to disk.
+     */
+    void flush();
+
+    unsigned char* data() const { return base_; }
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Checks the magic, the version, the size, the directory bounds and the checksum.
+     *
+     * Header is PortfolioHeader or SnapshotHeader: the checksum covers every byte after the header.
+     *
+     * @param magic The expected magic.
+     * @param formatVersion The supported format version.
+     * @param entryCount The number of directory entries given by the header.
+     * @param entrySize The size of a directory entry.
+     * @param kind The name of the format in error messages.
+     * @return The offset of the end of the directory.
+     * @throw std::runtime_error if one of the checks fails.
+     */
+    template <typename Header>
+    size_t checkHeader(const char (&magic)[8], std::uint32_t formatVersion, std::uint32_t entryCount,
+        size_t entrySize, const std::string& kind) const {
+        const Header* header = reinterpret_cast<const Header*>(base_);
+        if (std::memcmp(header->magic, magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a " + kind + " file.");
+        }
+        if (header->formatVersion != formatVersion) {
+            throw std::runtime_error("Unsupported " + kind + " format version.");
+        }
+        if (header->fileSize != size_) {
+            throw std::runtime_error("Truncated " + kind + " file.");
+        }
+        if (entryCount > (size_ - sizeof(Header)) / entrySize) {
+            throw std::runtime_error("The " + kind + " directory exceeds the file.");
+        }
+        if (fnv1a(base_ + sizeof(Header), size_ - sizeof(Header)) != header->checksum) {
+            throw std::runtime_error("Checksum mismatch in " + kind + " file.");
+        }
+        return sizeof(Header) + static_cast<size_t>(entryCount) * entrySize;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file_;
+    HANDLE mapping_;
+#else
+    int file_;
+#endif
+    unsigned char* base_;
+    size_t size_;
+};
+
+#endif // MAPPEDFILE_HPP
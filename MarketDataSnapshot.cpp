@@ -0,0 +1,209 @@
+/**
+ * @file MarketDataSnapshot.cpp
+ * @brief Implementation of the memory-mapped market-data snapshot reader and writer.
+ */
+
+#include "pch.h"
+#include "MarketDataSnapshot.hpp"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+static_assert(sizeof(SnapshotHeader) == 64, "Unexpected snapshot header size.");
+static_assert(sizeof(SectionEntry) == 72, "Unexpected section entry size.");
+static_assert(sizeof(RatePoint) == 2 * sizeof(double), "RatePoint must be two packed doubles.");
+
+namespace {
+
+    const char kMagic[8] = { 'M', 'M', 'O', 'P', 'S', 'N', 'A', 'P' };
+    const std::uint32_t kFormatVersion = 2;
+
+    /// Tells whether an interpolation method can be stored in a snapshot.
+    bool isStoredInterpolation(std::uint32_t method) {
+        return method == static_cast<std::uint32_t>(InterpolationMethod::Linear)
+            || method == static_cast<std::uint32_t>(InterpolationMethod::MonotoneCubic)
+            || method == static_cast<std::uint32_t>(InterpolationMethod::LogDiscount);
+    }
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// CurveView
+// ---------------------------------------------------------------------------
+
+CurveView::CurveView(std::shared_ptr<const MarketDataSnapshot> owner, const RatePoint* points, size_t count,
+    InterpolationMethod method)
+    : owner_(std::move(owner)),
+    points_(points),
+    count_(count),
+    method_(method),
+    uniform_(false),
+    invStep_(0.0)
+{
+    // Same uniform-spacing test as YieldCurve, so that both use the same lookup.
+    if (count_ >= 2) {
+        double step = points_[1].maturity - points_[0].maturity;
+        uniform_ = (step > 0.0);
+        for (size_t i = 2; i < count_ && uniform_; ++i) {
+            double expected = points_[0].maturity + static_cast<double>(i) * step;
+            uniform_ = std::abs(points_[i].maturity - expected) <= 1e-9 * std::max(1.0, std::abs(expected));
+        }
+        invStep_ = uniform_ ? 1.0 / step : 0.0;
+    }
+}
+
+double CurveView::getRate(double t) const {
+    if (t <= points_[0].maturity) {
+        return points_[0].rate;
+    }
+    if (t >= points_[count_ - 1].maturity) {
+        return points_[count_ - 1].rate;
+    }
+    size_t i = YieldCurve::findInterval(points_, count_, uniform_, invStep_, t);
+    return YieldCurve::interpolate(points_, count_, method_, i, t);
+}
+
+YieldCurve CurveView::toYieldCurve() const {
+    YieldCurve curve;
+    curve.setInterpolation(method_);
+    for (size_t i = 0; i < count_; ++i) {
+        curve.addRatePoint(points_[i].maturity, points_[i].rate);
+    }
+    return curve;
+}
+
+// ---------------------------------------------------------------------------
+// MarketDataSnapshot
+// ---------------------------------------------------------------------------
+
+MarketDataSnapshot::MarketDataSnapshot()
+{
+}
+
+std::shared_ptr<const MarketDataSnapshot> MarketDataSnapshot::open(const std::string& path) {
+    std::shared_ptr<MarketDataSnapshot> snapshot(new MarketDataSnapshot());
+    snapshot->file_.openForReading(path, sizeof(SnapshotHeader), "snapshot");
+    snapshot->validate();
+    return snapshot;
+}
+
+void MarketDataSnapshot::validate() const {
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(file_.data());
+    const size_t size = file_.size();
+    const size_t directoryEnd = file_.checkHeader<SnapshotHeader>(kMagic, kFormatVersion, header->sectionCount,
+        sizeof(SectionEntry), "snapshot");
+
+    const SectionEntry* entries = directory();
+    for (std::uint32_t s = 0; s < header->sectionCount; ++s) {
+        const SectionEntry& entry = entries[s];
+        if (std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr) {
+            throw std::runtime_error("Snapshot section name is not terminated.");
+        }
+        if (entry.offset % 8 != 0 || entry.offset < directoryEnd || entry.offset > size
+            || entry.length > size - entry.offset) {
+            throw std::runtime_error("Snapshot section exceeds the file: " + std::string(entry.name));
+        }
+        if (entry.kind == static_cast<std::uint32_t>(SectionKind::Curve)) {
+            if (entry.count == 0 || entry.length != static_cast<std::uint64_t>(entry.count) * sizeof(RatePoint)) {
+                throw std::runtime_error("Invalid curve section: " + std::string(entry.name));
+            }
+            if (!isStoredInterpolation(entry.interpolation)) {
+                throw std::runtime_error("Unknown curve interpolation method: " + std::string(entry.name));
+            }
+            const RatePoint* points = reinterpret_cast<const RatePoint*>(file_.data() + entry.offset);
+            for (std::uint32_t i = 1; i < entry.count; ++i) {
+                if (!(points[i].maturity > points[i - 1].maturity)) {
+                    throw std::runtime_error("Curve maturities are not increasing: " + std::string(entry.name));
+                }
+            }
+        }
+    }
+}
+
+const SectionEntry* MarketDataSnapshot::directory() const {
+    return reinterpret_cast<const SectionEntry*>(file_.data() + sizeof(SnapshotHeader));
+}
+
+std::uint64_t MarketDataSnapshot::snapshotVersion() const {
+    return reinterpret_cast<const SnapshotHeader*>(file_.data())->snapshotVersion;
+}
+
+std::vector<std::string> MarketDataSnapshot::curveNames() const {
+    std::vector<std::string> names;
+    const std::uint32_t count = reinterpret_cast<const SnapshotHeader*>(file_.data())->sectionCount;
+    for (std::uint32_t s = 0; s < count; ++s) {
+        if (directory()[s].kind == static_cast<std::uint32_t>(SectionKind::Curve)) {
+            names.push_back(directory()[s].name);
+        }
+    }
+    return names;
+}
+
+CurveView MarketDataSnapshot::curve(const std::string& name) const {
+    const std::uint32_t count = reinterpret_cast<const SnapshotHeader*>(file_.data())->sectionCount;
+    for (std::uint32_t s = 0; s < count; ++s) {
+        const SectionEntry& entry = directory()[s];
+        if (entry.kind == static_cast<std::uint32_t>(SectionKind::Curve) && name == entry.name) {
+            return CurveView(shared_from_this(), reinterpret_cast<const RatePoint*>(file_.data() + entry.offset), entry.count,
+                static_cast<InterpolationMethod>(entry.interpolation));
+        }
+    }
+    throw std::runtime_error("No curve section named " + name);
+}
+
+void MarketDataSnapshot::write(const std::string& path, const std::vector<std::pair<std::string, YieldCurve>>& curves,
+    std::uint64_t snapshotVersion) {
+    // Directory and section data are assembled in memory, then hashed and written after the header.
+    std::vector<unsigned char> body(curves.size() * sizeof(SectionEntry), 0);
+    std::uint64_t offset = sizeof(SnapshotHeader) + body.size();
+    for (size_t s = 0; s < curves.size(); ++s) {
+        const std::string& name = curves[s].first;
+        const std::vector<RatePoint>& points = curves[s].second.getData();
+        if (name.size() >= sizeof(SectionEntry::name)) {
+            throw std::runtime_error("Snapshot section name is too long: " + name);
+        }
+        if (points.empty()) {
+            throw std::runtime_error("Cannot write an empty curve: " + name);
+        }
+        const std::uint32_t interpolation = static_cast<std::uint32_t>(curves[s].second.getInterpolation());
+        if (!isStoredInterpolation(interpolation)) {
+            throw std::runtime_error("The snapshot format cannot store the interpolation of curve " + name);
+        }
+
+        SectionEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, name.c_str(), name.size());
+        entry.kind = static_cast<std::uint32_t>(SectionKind::Curve);
+        entry.count = static_cast<std::uint32_t>(points.size());
+        entry.offset = offset;
+        entry.length = points.size() * sizeof(RatePoint);
+        entry.interpolation = interpolation;
+        std::memcpy(body.data() + s * sizeof(SectionEntry), &entry, sizeof(entry));
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(points.data());
+        body.insert(body.end(), bytes, bytes + entry.length);
+        offset += entry.length;
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.formatVersion = kFormatVersion;
+    header.sectionCount = static_cast<std::uint32_t>(curves.size());
+    header.snapshotVersion = snapshotVersion;
+    header.fileSize = sizeof(SnapshotHeader) + body.size();
+    header.checksum = fnv1a(body.data(), body.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create snapshot file: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+    if (!out) {
+        throw std::runtime_error("Cannot write snapshot file: " + path);
+    }
+}
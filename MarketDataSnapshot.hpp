@@ -0,0 +1,184 @@
+#ifndef MARKETDATASNAPSHOT_HPP
+#define MARKETDATASNAPSHOT_HPP
+
+/**
+ * @file MarketDataSnapshot.hpp
+ * @brief Declaration of the binary market-data snapshot format and of its memory-mapped reader.
+ *
+ * A snapshot file holds named sections of market data (yield curves for now; the section kinds
+ * leave room for volatility surfaces) behind a header carrying a format version, a snapshot
+ * version and a checksum. The reader maps the file read-only and validates it once; the curves
+ * are then read in place through views, without parsing or copying, so that several processes
+ * can share one snapshot through the operating system's page cache.
+ *
+ * Layout (little-endian, every block aligned on 8 bytes):
+ *
+ *    header     SnapshotHeader (64 bytes)
+ *    directory  sectionCount x SectionEntry (72 bytes each)
+ *    sections   yield curve: count x RatePoint (maturity, rate), sorted by maturity
+ *
+ * The directory entry of a curve records its interpolation method, so that a curve read back
+ * interpolates as the YieldCurve it was written from.
+ *
+ * The checksum is the 64-bit FNV-1a hash of every byte after the header.
+ */
+
+#include "pch.h"
+#include "YieldCurve.hpp"
+#include "MappedFile.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @brief Kind of data stored in a section.
+ */
+enum class SectionKind : std::uint32_t {
+    Curve = 1,        ///< Yield curve: array of RatePoint sorted by maturity.
+    VolSurface = 2    ///< Reserved for volatility surfaces; ignored by this reader.
+};
+
+/**
+ * @brief Fixed-size header at the start of a snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];                   ///< "MMOPSNAP".
+    std::uint32_t formatVersion;     ///< Version of the layout (currently 2).
+    std::uint32_t sectionCount;      ///< Number of entries in the directory.
+    std::uint64_t snapshotVersion;   ///< Version of the market data, chosen by the writer.
+    std::uint64_t fileSize;          ///< Total size of the file in bytes.
+    std::uint64_t checksum;          ///< FNV-1a hash of the bytes following the header.
+    std::uint8_t reserved[24];       ///< Zero.
+};
+
+/**
+ * @brief Directory entry describing one section.
+ */
+struct SectionEntry {
+    char name[40];                   ///< Null-terminated section name.
+    std::uint32_t kind;              ///< SectionKind of the data.
+    std::uint32_t count;             ///< Number of records.
+    std::uint64_t offset;            ///< Offset of the data from the start of the file.
+    std::uint64_t length;            ///< Length of the data in bytes.
+    std::uint32_t interpolation;     ///< Curves: InterpolationMethod (0 = linear, 1 = monotone cubic, 2 = log-discount).
+    std::uint32_t reserved;          ///< Zero.
+};
+
+class MarketDataSnapshot;
+
+/**
+ * @brief Read-only view of a yield curve stored in a mapped snapshot.
+ *
+ * The view interpolates in place with the interpolation method stored in the snapshot, with the
+ * same lookup and arithmetic as YieldCurve::getRate, and keeps the snapshot mapped for as long as
+ * it exists.
+ */
+class CurveView {
+public:
+    /**
+     * @brief Returns the interpolated interest rate for a given maturity.
+     * @param t The desired maturity.
+     * @return The interpolated interest rate.
+     */
+    double getRate(double t) const;
+
+    /**
+     * @brief Returns the number of points of the curve.
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Returns the points of the curve (in the mapped memory).
+     */
+    const RatePoint* data() const { return points_; }
+
+    /**
+     * @brief Returns the interpolation method of the curve.
+     */
+    InterpolationMethod getInterpolation() const { return method_; }
+
+    /**
+     * @brief Copies the curve into a YieldCurve, for use in a PricingConfiguration.
+     */
+    YieldCurve toYieldCurve() const;
+
+private:
+    friend class MarketDataSnapshot;
+
+    CurveView(std::shared_ptr<const MarketDataSnapshot> owner, const RatePoint* points, size_t count,
+        InterpolationMethod method);
+
+    std::shared_ptr<const MarketDataSnapshot> owner_; ///< Keeps the mapping alive.
+    const RatePoint* points_;
+    size_t count_;
+    InterpolationMethod method_;
+    bool uniform_;
+    double invStep_;
+};
+
+/**
+ * @brief A memory-mapped, validated market-data snapshot file.
+ */
+class MarketDataSnapshot : public std::enable_shared_from_this<MarketDataSnapshot> {
+public:
+    /**
+     * @brief Maps a snapshot file read-only and validates it.
+     * @param path The path of the snapshot file.
+     * @return The snapshot.
+     * @throw std::runtime_error if the file cannot be mapped, or if its header, directory or
+     *        checksum is invalid.
+     */
+    static std::shared_ptr<const MarketDataSnapshot> open(const std::string& path);
+
+    /**
+     * @brief Writes a snapshot file containing yield curves.
+     *
+     * A mapped file cannot be replaced while other processes use it, so publishers should write
+     * each new version to a new file.
+     *
+     * @param path The path of the file to create.
+     * @param curves The curves and their section names (at most 39 characters).
+     * @param snapshotVersion The version number stored in the header.
+     * @throw std::runtime_error if the file cannot be written, a name is too long or the
+     *        interpolation method of a curve cannot be stored.
+     */
+    static void write(const std::string& path, const std::vector<std::pair<std::string, YieldCurve>>& curves,
+        std::uint64_t snapshotVersion);
+
+    MarketDataSnapshot(const MarketDataSnapshot&) = delete;
+    MarketDataSnapshot& operator=(const MarketDataSnapshot&) = delete;
+
+    /**
+     * @brief Returns the version number stored in the header.
+     */
+    std::uint64_t snapshotVersion() const;
+
+    /**
+     * @brief Returns the names of the yield curve sections.
+     */
+    std::vector<std::string> curveNames() const;
+
+    /**
+     * @brief Returns a view of a yield curve section.
+     * @param name The section name.
+     * @return The view.
+     * @throw std::runtime_error if there is no yield curve section with this name.
+     */
+    CurveView curve(const std::string& name) const;
+
+private:
+    MarketDataSnapshot();
+
+    /**
+     * @brief Checks the header, the directory and the checksum of the mapped file.
+     */
+    void validate() const;
+
+    const SectionEntry* directory() const;
+
+    MappedFile file_;
+};
+
+#endif // MARKETDATASNAPSHOT_HPP
@@ -15,7 +15,12 @@
 #include "pch.h"
 #include "MonteCarloPricer.hpp"
 #include "Option.hpp"
+#include "OptionBatch.hpp"
 #include "DateConverter.hpp"   // For date conversion functions
+#include "ParallelFor.hpp"
+#include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 #include <cmath>
 #include <random>
@@ -23,16 +28,42 @@
 #include <numeric>
 #include <stdexcept>
 
+namespace {
+
+    /// Largest number of normal draws shared by the options of a batch (16 MB); beyond it, every
+    /// simulation draws its own (identical) variates instead of holding them all in memory.
+    const size_t kMaxSharedNormals = size_t(1) << 21;
+
+    /// Draws taken by prepare(), per number of paths and of steps. They are released with the last
+    /// prepared pricer that uses them.
+    struct PreparedNormals {
+        std::mutex mutex;
+        std::map<std::pair<int, int>, std::weak_ptr<const std::vector<double>>> tables;
+    };
+
+    PreparedNormals& preparedNormals() {
+        static PreparedNormals normals;
+        return normals;
+    }
+
+} // namespace
+
  /// New constructor: initialize with a pricing configuration.
 MonteCarloPricer::MonteCarloPricer(const PricingConfiguration& config)
-    : config_(config)
+    : config_(std::make_shared<const PricingConfiguration>(config))
 {
     // The configuration parameters are now stored in config_
 }
 
+/// Constructor sharing a configuration, with a bump overlay.
+MonteCarloPricer::MonteCarloPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump)
+    : config_(std::move(config)), bump_(bump)
+{
+}
+
 /// Default constructor using the default configuration.
 MonteCarloPricer::MonteCarloPricer()
-    : config_() // Default configuration from PricingConfiguration's default constructor
+    : config_(std::make_shared<const PricingConfiguration>())
 {
     // No additional initialization is required.
 }
@@ -47,6 +78,10 @@ MonteCarloPricer::~MonteCarloPricer() {
  *
  * For European options, a standard simulation of geometric Brownian motion is used.
  * For American options, the Longstaff-Schwartz algorithm is applied to determine the optimal exercise.
+ * As in the original method, every path in the money at a date enters the regression of that date,
+ * including the paths already exercised at a later date: an earlier exercise then replaces the later
+ * one. Restricting the regression to the paths not yet exercised keeps late exercises that are not
+ * optimal and overprices the option (by about 0.6 on an at-the-money put against the binomial tree).
  *
  * The simulation parameters (maturity, risk-free rate, number of simulation paths, and number of time steps)
  * are obtained from the PricingConfiguration object. If a calculation date is provided,
@@ -54,7 +89,7 @@ MonteCarloPricer::~MonteCarloPricer() {
  *
  *    T_effective = T - offset,
  *
- * where offset is the number of years between config_.calculationDate and today.
+ * where offset is the number of years between config_->calculationDate and today.
  *
  * In the forward simulation, the local risk-free rate at each step is obtained by:
  *    r_local = (yieldCurve is available) ? yieldCurve.getRate(t_norm) : default riskFreeRate,
@@ -64,22 +99,56 @@ MonteCarloPricer::~MonteCarloPricer() {
  * @return The computed option price.
  */
 double MonteCarloPricer::price(const Option& opt) const {
-    // Retrieve option parameters.
-    double S0 = opt.getUnderlying();
-    double K = opt.getStrike();
-    double sigma = opt.getVolatility();
-    double q = opt.getDividend();
+    return simulate(opt, makeTimeGrid(*config_, bump_.rateShift, config_->maturityOf(opt)),
+        normals_ ? normals_->data() : nullptr, nullptr, nullptr);
+}
+
+/**
+ * @brief Takes the normal draws of the configuration.
+ *
+ * With the fixed seed, the draws depend only on the number of paths and of steps: the first pricer
+ * prepared with a given size draws them, and the others share the same table while it is in use.
+ */
+void MonteCarloPricer::prepare() {
+    const int paths = config_->mcNumPaths;
+    const int steps = config_->mcTimeStepsPerPath;
+    if (normals_ || paths <= 0 || steps <= 0 || static_cast<size_t>(paths) * steps > kMaxSharedNormals) {
+        return;
+    }
+    PreparedNormals& prepared = preparedNormals();
+    std::lock_guard<std::mutex> lock(prepared.mutex);
+    std::weak_ptr<const std::vector<double>>& table = prepared.tables[std::make_pair(paths, steps)];
+    normals_ = table.lock();
+    if (!normals_) {
+        normals_ = std::make_shared<const std::vector<double>>(drawNormals(paths, steps));
+        table = normals_;
+    }
+}
 
-    // Retrieve simulation parameters from configuration.
-    double T = config_.maturity;           // Configured maturity
-    double r_default = config_.riskFreeRate; // Default risk-free rate
-    const int NPaths = config_.mcNumPaths;   // Number of simulation paths
-    const int NSteps = config_.mcTimeStepsPerPath; // Number of time steps per path
+/**
+ * @brief Sets up the time grid of a simulation.
+ *
+ * If a calculation date is provided, the effective time to maturity is T_effective = T - offset.
+ * The local rates of the steps are read on the yield curve if it is loaded, and are the default
+ * risk-free rate otherwise.
+ *
+ * @param config The configuration (calculation date, rates, number of paths and of steps).
+ * @param rateShift Shift added to the local rates (see PricingBump).
+ * @param maturity The maturity T, from the calculation date.
+ * @return The time grid.
+ * @throw std::runtime_error if the effective maturity is negative.
+ */
+MonteCarloPricer::TimeGrid MonteCarloPricer::makeTimeGrid(const PricingConfiguration& config, double rateShift, double maturity) {
+    TimeGrid grid;
+    grid.paths = config.mcNumPaths;
+    grid.steps = config.mcTimeStepsPerPath;
+    const int NSteps = grid.steps;
 
     // Adjust effective time to maturity based on the calculation date.
+    double T = maturity;
     double T_effective = T;
-    if (!config_.calculationDate.empty()) {
-        auto calcDate = DateConverter::parseDate(config_.calculationDate);
+    if (!config.calculationDate.empty()) {
+        auto calcDate = DateConverter::parseDate(config.calculationDate);
         auto today = std::chrono::system_clock::now();
         double offset = DateConverter::yearsBetween(calcDate, today);
         if (offset >= T) {
@@ -88,31 +157,138 @@ double MonteCarloPricer::price(const Option& opt) const {
         T_effective = T - offset;
     }
     double dt = T_effective / NSteps;
+    grid.maturity = T_effective;
+    grid.dt = dt;
+
+    // The local rates depend only on the time step: they are interpolated once per pricing,
+    // at the forward times j dt and at the backward times T - k dt used for the discounting.
+    grid.forwardRates.assign(NSteps + 1, config.riskFreeRate + rateShift);
+    grid.backwardRates.assign(NSteps + 1, config.riskFreeRate + rateShift);
+    if (!config.yieldCurve.getData().empty()) {
+        std::vector<double> times(NSteps + 1);
+        for (int j = 0; j <= NSteps; j++) {
+            times[j] = (j * dt) / T_effective;
+        }
+        config.yieldCurve.getRates(times.data(), grid.forwardRates.data(), times.size());
+        for (int k = 0; k <= NSteps; k++) {
+            times[k] = (T_effective - k * dt) / T_effective;
+        }
+        config.yieldCurve.getRates(times.data(), grid.backwardRates.data(), times.size());
+        for (int k = 0; k <= NSteps; k++) {
+            grid.forwardRates[k] += rateShift;
+            grid.backwardRates[k] += rateShift;
+        }
+    }
+    return grid;
+}
+
+/**
+ * @brief Draws the normal variates of a simulation.
+ *
+ * simulate() draws NSteps variates per path, path after path, from a generator seeded with the
+ * same fixed seed for every option: the draws do not depend on the option and can be shared by
+ * all the simulations of a batch.
+ *
+ * @param paths The number of paths.
+ * @param steps The number of time steps per path.
+ * @return The paths * steps draws, in the order in which simulate() uses them.
+ */
+std::vector<double> MonteCarloPricer::drawNormals(int paths, int steps) {
+    std::mt19937 rng(42);
+    std::normal_distribution<double> norm(0.0, 1.0);
+    std::vector<double> normals(static_cast<size_t>(paths) * steps);
+    for (double& Z : normals) {
+        Z = norm(rng);
+    }
+    return normals;
+}
+
+/**
+ * @brief Runs the simulation for price(), optionally with the sensitivities to the local rates.
+ *
+ * The sensitivities are pathwise derivatives accumulated during the same simulation, with the
+ * exercise decisions of the Longstaff-Schwartz regression held fixed. A simulated price depends on
+ * the forward rates of the steps before the payment through the drift, and on the rates used to
+ * discount it; for a payoff paid at step tau,
+ *
+ *    d(payoff * disc) / d r_j = dt * disc * payoff'(S_tau) * S_tau    (drift, forward rates j < tau)
+ *    d(payoff * disc) / d r_k = -dt * disc * payoff                      (discounting rates k < tau)
+ *
+ * so the derivatives with respect to all the local rates are obtained from one pass over the paths,
+ * whatever the number of curve points.
+ *
+ * @param opt The option to be priced.
+ * @param grid The time grid (see makeTimeGrid()).
+ * @param normals If not null, the draws of drawNormals() for this grid; otherwise they are drawn here.
+ * @param rateTimes If not null, receives the normalized times at which the local rates are read:
+ *        the NSteps forward times, then the NSteps discounting times.
+ * @param rateSensitivities If not null, receives the derivative of the price with respect to each local rate.
+ * @return The computed option price.
+ */
+double MonteCarloPricer::simulate(const Option& opt, const TimeGrid& grid, const double* normals,
+    std::vector<double>* rateTimes, std::vector<double>* rateSensitivities) {
+    if (opt.getBarrierType() != Option::BarrierType::None || opt.getOptionStyle() == Option::OptionStyle::Bermudan) {
+        throw std::runtime_error("MonteCarloPricer supports only vanilla European and American options.");
+    }
+
+    // Retrieve option parameters.
+    double S0 = opt.getUnderlying();
+    double K = opt.getStrike();
+    double sigma = opt.getVolatility();
+    double q = opt.getDividend();
+
+    // Retrieve simulation parameters from the time grid.
+    const int NPaths = grid.paths;   // Number of simulation paths
+    const int NSteps = grid.steps;   // Number of time steps per path
+    const double T_effective = grid.maturity;
+    const double dt = grid.dt;
+    const std::vector<double>& forwardRates = grid.forwardRates;
+    const std::vector<double>& backwardRates = grid.backwardRates;
+    if (rateTimes) {
+        rateTimes->resize(2 * NSteps);
+        for (int j = 0; j < NSteps; j++) {
+            (*rateTimes)[j] = (j * dt) / T_effective;
+            (*rateTimes)[NSteps + j] = (T_effective - j * dt) / T_effective;
+        }
+    }
+    if (rateSensitivities) {
+        rateSensitivities->assign(2 * NSteps, 0.0);
+    }
 
     // Initialize random number generator with a fixed seed for reproducibility.
     std::mt19937 rng(42);
     std::normal_distribution<double> norm(0.0, 1.0);
+    auto nextNormal = [&]() {
+        return normals ? *normals++ : norm(rng);
+    };
 
     if (opt.getOptionStyle() == Option::OptionStyle::European) {
         // --- Standard Monte Carlo simulation for European options ---
         double sumPayoff = 0.0;
+        double sumRateDerivative = 0.0; // Common derivative with respect to every forward rate.
         for (int i = 0; i < NPaths; i++) {
             double S = S0;
             double disc = 1.0;
             // Simulate one price path using GBM with variable interest rate.
             for (int j = 0; j < NSteps; j++) {
-                double t_current = j * dt;
-                double normTime = t_current / T_effective; // normalized time in [0,1]
-                double r_local = (config_.yieldCurve.getData().empty()) ? r_default : config_.yieldCurve.getRate(normTime);
-                double Z = norm(rng);
+                double r_local = forwardRates[j];
+                double Z = nextNormal();
                 S *= std::exp((r_local - q - 0.5 * sigma * sigma) * dt + sigma * std::sqrt(dt) * Z);
                 disc *= std::exp(-r_local * dt);
             }
             double payoff = (opt.getOptionType() == Option::OptionType::Call) ? std::max(S - K, 0.0)
                 : std::max(K - S, 0.0);
             sumPayoff += payoff * disc; // Already discounted along the path
+            if (rateSensitivities) {
+                double slope = (opt.getOptionType() == Option::OptionType::Call) ? (S > K ? 1.0 : 0.0)
+                    : (S < K ? -1.0 : 0.0);
+                sumRateDerivative += dt * disc * (slope * S - payoff);
+            }
         }
         double priceMC = sumPayoff / NPaths;
+        if (rateSensitivities) {
+            std::fill(rateSensitivities->begin(), rateSensitivities->begin() + NSteps, sumRateDerivative / NPaths);
+        }
         return priceMC;
     }
     else {
@@ -122,10 +298,8 @@ double MonteCarloPricer::price(const Option& opt) const {
         for (int i = 0; i < NPaths; i++) {
             paths[i][0] = S0;
             for (int j = 1; j <= NSteps; j++) {
-                double t_current = (j - 1) * dt;
-                double normTime = t_current / T_effective;
-                double r_local = (config_.yieldCurve.getData().empty()) ? r_default : config_.yieldCurve.getRate(normTime);
-                double Z = norm(rng);
+                double r_local = forwardRates[j - 1];
+                double Z = nextNormal();
                 paths[i][j] = paths[i][j - 1] * std::exp((r_local - q - 0.5 * sigma * sigma) * dt + sigma * std::sqrt(dt) * Z);
             }
         }
@@ -148,14 +322,14 @@ double MonteCarloPricer::price(const Option& opt) const {
                 double intrinsic = (opt.getOptionType() == Option::OptionType::Call) ?
                     std::max(paths[i][t] - K, 0.0) :
                     std::max(K - paths[i][t], 0.0);
-                if (intrinsic > 0.0 && exerciseTime[i] == NSteps) {
+                // Every in-the-money path is tested, so an earlier exercise replaces a later one (see price()).
+                if (intrinsic > 0.0) {
                     inTheMoneyIndices.push_back(i);
                     X.push_back(paths[i][t]);
                     // Compute discount factor from t to exerciseTime using variable rates.
                     double disc = 1.0;
                     for (int k = t; k < exerciseTime[i]; k++) {
-                        double normTime_k = ((T_effective - k * dt) / T_effective);
-                        double r_local = (config_.yieldCurve.getData().empty()) ? r_default : config_.yieldCurve.getRate(normTime_k);
+                        double r_local = backwardRates[k];
                         disc *= std::exp(-r_local * dt);
                     }
                     Y.push_back(cashFlow[i] * disc);
@@ -211,16 +385,180 @@ double MonteCarloPricer::price(const Option& opt) const {
         for (int i = 0; i < NPaths; i++) {
             double disc = 1.0;
             for (int k = 0; k < exerciseTime[i]; k++) {
-                double normTime_k = (T_effective - k * dt) / T_effective;
-                double r_local = (config_.yieldCurve.getData().empty()) ? r_default : config_.yieldCurve.getRate(normTime_k);
+                double r_local = backwardRates[k];
                 disc *= std::exp(-r_local * dt);
             }
             sumPayoffs += cashFlow[i] * disc;
         }
+        if (rateSensitivities) {
+            // Derivatives of the payments made at each step, summed afterwards over the steps before it.
+            std::vector<double> driftTerm(NSteps + 1, 0.0);
+            std::vector<double> discountTerm(NSteps + 1, 0.0);
+            for (int i = 0; i < NPaths; i++) {
+                int tau = exerciseTime[i];
+                if (cashFlow[i] <= 0.0) {
+                    continue;
+                }
+                double disc = 1.0;
+                for (int k = 0; k < tau; k++) {
+                    disc *= std::exp(-backwardRates[k] * dt);
+                }
+                double S = paths[i][tau];
+                double slope = (opt.getOptionType() == Option::OptionType::Call) ? 1.0 : -1.0;
+                driftTerm[tau] += dt * disc * slope * S;
+                discountTerm[tau] -= dt * disc * cashFlow[i];
+            }
+            double driftSum = 0.0;
+            double discountSum = 0.0;
+            for (int j = NSteps - 1; j >= 0; j--) {
+                driftSum += driftTerm[j + 1];
+                discountSum += discountTerm[j + 1];
+                (*rateSensitivities)[j] = driftSum / NPaths;
+                (*rateSensitivities)[NSteps + j] = discountSum / NPaths;
+            }
+        }
         return sumPayoffs / NPaths;
     }
 }
 
+/**
+ * @brief Computes the prices of a batch of options using Monte Carlo simulation.
+ *
+ * The time grid is set up once per distinct maturity of the batch and, with the fixed seed, every
+ * simulation uses the same normal draws, which are generated once. The options are then simulated independently, so they are
+ * distributed over the threads one at a time.
+ *
+ * @param options The options to be priced.
+ * @param prices Receives options.size() prices.
+ */
+void MonteCarloPricer::priceBatch(const OptionBatchView& options, double* prices) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    std::map<double, TimeGrid> grids;
+    for (size_t i = 0; i < count; ++i) {
+        double T = options.maturity(i);
+        if (grids.find(T) == grids.end()) {
+            grids.emplace(T, makeTimeGrid(*config_, bump_.rateShift, T));
+        }
+    }
+    const TimeGrid& first = grids.begin()->second;
+    std::vector<double> normals;
+    if (!normals_ && static_cast<size_t>(first.paths) * first.steps <= kMaxSharedNormals) {
+        normals = drawNormals(first.paths, first.steps);
+    }
+    const double* shared = normals_ ? normals_->data() : (normals.empty() ? nullptr : normals.data());
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 1);
+    parallelFor(count, 1, threads, [&](int, size_t begin, size_t end) {
+        Option opt;
+        for (size_t i = begin; i < end; ++i) {
+            options.load(i, opt);
+            prices[i] = simulate(opt, grids.at(options.maturity(i)), shared, nullptr, nullptr);
+        }
+    });
+}
+
+/**
+ * @brief Computes the Greeks of a batch of options with the finite differences of computeGreeks().
+ *
+ * The four time grids of computeGreeks() (base, maturity shifted by one day, rates shifted up and
+ * down) are set up once per distinct maturity, and the eight simulations of every option share the same normal draws.
+ *
+ * @param options The options to evaluate.
+ * @param greeks Receives options.size() Greeks structures.
+ */
+void MonteCarloPricer::computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const {
+    const size_t count = options.size();
+    if (count == 0) {
+        return;
+    }
+    const double volStep = 0.01;
+    const double rStep = 0.001;
+    const double timeStep = 1.0 / 365.0; // One day
+
+    struct GreekGrids {
+        TimeGrid base, timeDown, rateUp, rateDown;
+    };
+    std::map<double, GreekGrids> grids;
+    for (size_t i = 0; i < count; ++i) {
+        double T = options.maturity(i);
+        if (grids.find(T) == grids.end()) {
+            grids.emplace(T, GreekGrids{ makeTimeGrid(*config_, bump_.rateShift, T),
+                makeTimeGrid(*config_, bump_.rateShift, T - timeStep),
+                makeTimeGrid(*config_, bump_.rateShift + rStep, T), makeTimeGrid(*config_, bump_.rateShift - rStep, T) });
+        }
+    }
+    const TimeGrid& first = grids.begin()->second.base;
+    std::vector<double> normals;
+    if (!normals_ && static_cast<size_t>(first.paths) * first.steps <= kMaxSharedNormals) {
+        normals = drawNormals(first.paths, first.steps);
+    }
+    const double* shared = normals_ ? normals_->data() : (normals.empty() ? nullptr : normals.data());
+
+    const int threads = parallelThreadCount(config_->batchThreads, count, 1);
+    parallelFor(count, 1, threads, [&](int, size_t begin, size_t end) {
+        Option opt;
+        Option bumped;
+        for (size_t i = begin; i < end; ++i) {
+            options.load(i, opt);
+            const GreekGrids& grid = grids.at(options.maturity(i));
+            const TimeGrid& base = grid.base;
+            double h = 0.01 * opt.getUnderlying();
+            double basePrice = simulate(opt, base, shared, nullptr, nullptr);
+
+            bumped = opt;
+            bumped.setUnderlying(opt.getUnderlying() + h);
+            double price_up = simulate(bumped, base, shared, nullptr, nullptr);
+            bumped.setUnderlying(opt.getUnderlying() - h);
+            double price_down = simulate(bumped, base, shared, nullptr, nullptr);
+
+            bumped = opt;
+            bumped.setVolatility(opt.getVolatility() + volStep);
+            double price_vol_up = simulate(bumped, base, shared, nullptr, nullptr);
+            bumped.setVolatility(opt.getVolatility() - volStep);
+            double price_vol_down = simulate(bumped, base, shared, nullptr, nullptr);
+
+            double price_T_down = simulate(opt, grid.timeDown, shared, nullptr, nullptr);
+            double price_r_up = simulate(opt, grid.rateUp, shared, nullptr, nullptr);
+            double price_r_down = simulate(opt, grid.rateDown, shared, nullptr, nullptr);
+
+            Greeks& g = greeks[i];
+            g.delta = (price_up - price_down) / (2 * h);
+            g.gamma = (price_up - 2 * basePrice + price_down) / (h * h);
+            g.vega = (price_vol_up - price_vol_down) / (2 * volStep);
+            g.theta = (price_T_down - basePrice) / (-timeStep);
+            g.rho = (price_r_up - price_r_down) / (2 * rStep);
+        }
+    });
+}
+
+/**
+ * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+ *
+ * The pathwise derivatives with respect to the local rates come from a single simulation (see
+ * simulate()) and are mapped onto the curve points with the interpolation weights. Their sum is the
+ * parallel-shift rho of the curve.
+ *
+ * @param opt The option to evaluate.
+ * @return The derivative of the price with respect to the rate of each curve point (empty if the
+ *         yield curve is empty).
+ */
+std::vector<double> MonteCarloPricer::computeKeyRateRho(const Option& opt) const {
+    std::vector<double> keyRateRho(config_->yieldCurve.getData().size(), 0.0);
+    if (keyRateRho.empty()) {
+        return keyRateRho;
+    }
+    std::vector<double> rateTimes;
+    std::vector<double> rateSensitivities;
+    simulate(opt, makeTimeGrid(*config_, bump_.rateShift, config_->maturityOf(opt)), normals_ ? normals_->data() : nullptr,
+        &rateTimes, &rateSensitivities);
+    config_->yieldCurve.addPointSensitivities(rateTimes.data(), rateSensitivities.data(), rateTimes.size(),
+        keyRateRho.data());
+    return keyRateRho;
+}
+
 /**
  * @brief Computes the Greeks of the option using finite differences applied to the Monte Carlo pricer.
  *
@@ -258,13 +596,10 @@ Greeks MonteCarloPricer::computeGreeks(const Option& opt) const {
     double vega = (price(opt_vol_up) - price(opt_vol_down)) / (2 * volStep);
 
     // --- Theta ---
-    // Cration d'une nouvelle configuration avec une maturit lgrement rduite
-    PricingConfiguration config_T_down = config_;
-    config_T_down.maturity = config_.maturity - timeStep;
-
-    // Cration d'un nouveau pricer avec cette configuration
-    MonteCarloPricer pricer_T_down(config_T_down);
-    double price_T_down = pricer_T_down.price(opt);
+    // Mme option avec une maturit lgrement rduite
+    Option opt_T_down = opt;
+    opt_T_down.setMaturity(config_->maturityOf(opt) - timeStep);
+    double price_T_down = price(opt_T_down);
 
     // Approximation par diffrences finies avec un dcalage ngatif
     double theta = (price_T_down - basePrice) / (-timeStep);  // On divise par -timeStep car Theta est gnralement ngatif
@@ -272,24 +607,11 @@ Greeks MonteCarloPricer::computeGreeks(const Option& opt) const {
 
 
     // --- Rho ---
-    PricingConfiguration config_r_up = config_;
-    PricingConfiguration config_r_down = config_;
-    if (!config_.yieldCurve.getData().empty()) {
-        YieldCurve yc_up;
-        YieldCurve yc_down;
-        for (const auto& pt : config_.yieldCurve.getData()) {
-            yc_up.addRatePoint(pt.maturity, pt.rate + rStep);
-            yc_down.addRatePoint(pt.maturity, pt.rate - rStep);
-        }
-        config_r_up.yieldCurve = yc_up;
-        config_r_down.yieldCurve = yc_down;
-    }
-    else {
-        config_r_up.riskFreeRate = config_.riskFreeRate + rStep;
-        config_r_down.riskFreeRate = config_.riskFreeRate - rStep;
-    }
-    MonteCarloPricer pricer_r_up(config_r_up);
-    MonteCarloPricer pricer_r_down(config_r_down);
+    // The bumped pricers share the configuration (and the prepared draws) and only shift the rates.
+    MonteCarloPricer pricer_r_up(config_, PricingBump(bump_.rateShift + rStep));
+    MonteCarloPricer pricer_r_down(config_, PricingBump(bump_.rateShift - rStep));
+    pricer_r_up.normals_ = normals_;
+    pricer_r_down.normals_ = normals_;
     double price_r_up = pricer_r_up.price(opt);
     double price_r_down = pricer_r_down.price(opt);
     double rho = (price_r_up - price_r_down) / (2 * rStep);
@@ -14,6 +14,8 @@
 #include "pch.h"
 #include "InterfaceOptionPricer.hpp"
 #include "PricingConfiguration.hpp"
+#include <memory>
+#include <vector>
 
 
  /**
@@ -45,6 +47,52 @@ public:
      */
     virtual Greeks computeGreeks(const Option& opt) const override;
 
+    /**
+     * @brief Computes the key-rate (bucketed) rho of the option, one value per yield curve point.
+     *
+     * The sensitivities to the local rates are pathwise derivatives gathered during a single
+     * simulation, so the cost does not depend on the number of curve points.
+     *
+     * @param opt The option to evaluate.
+     * @return The derivative of the price with respect to the rate of each curve point (empty if
+     *         the yield curve is empty).
+     */
+    std::vector<double> computeKeyRateRho(const Option& opt) const;
+
+    /**
+     * @brief Computes the prices of a batch of options.
+     *
+     * Each option is priced at its maturity in the batch. The time grid and its local rates are
+     * computed once per distinct maturity (the calculation date is parsed once per grid, not once
+     * per option), the normal draws, which are the same for every option (fixed seed), are generated
+     * once and shared, and the options are distributed over config.batchThreads threads. The prices
+     * are identical to those of price().
+     *
+     * @param options The options to be priced.
+     * @param prices Receives options.size() prices.
+     */
+    virtual void priceBatch(const OptionBatchView& options, double* prices) const override;
+
+    /**
+     * @brief Computes the Greeks of a batch of options, with the finite differences of computeGreeks().
+     *
+     * The time grids of the shifted maturity and of the shifted rates are set up once per distinct
+     * maturity, and all the simulations share the same normal draws.
+     *
+     * @param options The options to evaluate.
+     * @param greeks Receives options.size() Greeks structures.
+     */
+    virtual void computeGreeksBatch(const OptionBatchView& options, Greeks* greeks) const override;
+
+    /**
+     * @brief Takes the normal draws of the configuration (number of paths and of steps), so that the
+     *        following simulations do not draw them again.
+     *
+     * The draws are shared by all the prepared pricers with the same number of paths and of steps.
+     * Beyond 2^21 draws (16 MB), nothing is prepared and every simulation draws its own variates.
+     */
+    virtual void prepare() override;
+
     /**
     * @brief Constructor with pricing configuration.
     * @param config A PricingConfiguration structure containing additional parameters,
@@ -53,8 +101,56 @@ public:
     */
     MonteCarloPricer(const PricingConfiguration& config);
 
+    /**
+    * @brief Constructor sharing a configuration, with an optional bump overlay.
+    *
+    * The configuration is not copied, so that the bumped pricers of computeGreeks() allocate no memory.
+    *
+    * @param config The shared configuration (not null).
+    * @param bump The overlay applied on top of the configuration.
+    */
+    MonteCarloPricer(std::shared_ptr<const PricingConfiguration> config, const PricingBump& bump = PricingBump());
+
 private:
-    PricingConfiguration config_; ///< Additional configuration parameters for the Monte Carlo model.
+    /**
+     * @brief Time grid of a simulation: it depends on the configuration only.
+     */
+    struct TimeGrid {
+        int paths;                          ///< Number of simulation paths.
+        int steps;                          ///< Number of time steps per path.
+        double maturity;                    ///< Effective time to maturity.
+        double dt;                          ///< Time step.
+        std::vector<double> forwardRates;   ///< Local rates at the forward times j dt.
+        std::vector<double> backwardRates;  ///< Local rates at the discounting times T - k dt.
+    };
+
+    /**
+     * @brief Sets up the time grid of a configuration for one maturity (effective maturity and local rates).
+     * @throw std::runtime_error if the effective maturity is negative.
+     */
+    static TimeGrid makeTimeGrid(const PricingConfiguration& config, double rateShift, double maturity);
+
+    /**
+     * @brief Draws the normal variates of a simulation, in the order in which simulate() uses them.
+     */
+    static std::vector<double> drawNormals(int paths, int steps);
+
+    /**
+     * @brief Runs the simulation, optionally returning the sensitivities to the local rates.
+     *
+     * @param opt The option to be priced.
+     * @param grid The time grid.
+     * @param normals If not null, the draws of drawNormals(), used instead of drawing them again.
+     * @param rateTimes If not null, receives the normalized times at which the local rates are read.
+     * @param rateSensitivities If not null, receives the derivative of the price with respect to each local rate.
+     * @return The computed option price.
+     */
+    static double simulate(const Option& opt, const TimeGrid& grid, const double* normals,
+        std::vector<double>* rateTimes, std::vector<double>* rateSensitivities);
+
+    std::shared_ptr<const PricingConfiguration> config_; ///< Additional configuration parameters for the Monte Carlo model (shared).
+    PricingBump bump_;                                   ///< Overlay applied on top of config_.
+    std::shared_ptr<const std::vector<double>> normals_; ///< Draws of drawNormals() taken by prepare() (null if not prepared).
 
 };
 
@@ -1,12 +1,17 @@
 #include "pch.h"
 #include "MonteCarloPricerDLL.hpp"
 #include "MonteCarloPricer.hpp"   // Ce header doit contenir la dclaration de la classe MonteCarloPricer
+#include "PricerFactory.hpp"
 #include "Option.hpp"
 #include "PricingConfiguration.hpp"
+#include "BatchPricing.hpp"
 #include "DateConverter.hpp"
+#include "YieldCurveCache.hpp"
 #include <stdexcept>
 #include <cstring>
 #include <cmath>
+#include <vector>
+#include <memory>
 
 extern "C" {
 
@@ -23,22 +28,23 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
-            // Recharger la yield curve  chaque appel (adapter le chemin si ncessaire)
-            config.yieldCurve.loadFromFile("C:\\Users\\shaki\\OneDrive\\Bureau\\YieldCurveData.txt");
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
 
             // Paramtres spcifiques au modle Monte Carlo.
             config.mcNumPaths = mcNumPaths;
             config.mcTimeStepsPerPath = mcTimeStepsPerPath;
 
-            MonteCarloPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::MonteCarlo, config);
 
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            // La maturit est donne  l'option : les appels qui ne diffrent que par la maturit partagent un moteur du pool.
+            opt.setMaturity(T);
 
-            double price = pricer.price(opt);
+            double price = pricer->price(opt);
             return price;
         }
         catch (const std::exception& ex) {
@@ -59,21 +65,21 @@ extern "C" {
             else
                 config.calculationDate = calculationDate;
 
-            config.maturity = T;
             config.riskFreeRate = r;
-            // Recharge la yield curve  chaque appel (adapter le chemin si ncessaire)
-            config.yieldCurve.loadFromFile("C:\\Users\\shaki\\OneDrive\\Bureau\\YieldCurveData.txt");
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
 
             config.mcNumPaths = mcNumPaths;
             config.mcTimeStepsPerPath = mcTimeStepsPerPath;
 
-            MonteCarloPricer pricer(config);
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::MonteCarlo, config);
 
             Option opt(S, K, sigma, q,
                 (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
                 (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            opt.setMaturity(T);
 
-            Greeks g = pricer.computeGreeks(opt);
+            Greeks g = pricer->computeGreeks(opt);
             if (delta) *delta = g.delta;
             if (gamma) *gamma = g.gamma;
             if (vega)  *vega = g.vega;
@@ -89,4 +95,74 @@ extern "C" {
         }
     }
 
+    int __stdcall ComputeOptionKeyRateRhoMonteCarlo(
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* keyRateRho, int capacity)
+    {
+        try {
+            PricingConfiguration config;
+            if (calculationDate == nullptr || strlen(calculationDate) == 0)
+                config.calculationDate = DateConverter::getTodayDate();
+            else
+                config.calculationDate = calculationDate;
+
+            config.riskFreeRate = r;
+            // Courbe des taux partage par le processus (recharge en arrire-plan si le fichier change).
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+
+            config.mcNumPaths = mcNumPaths;
+            config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+
+            PooledPricer pricer = PricerFactory::acquirePricer(PricerType::MonteCarlo, config);
+
+            Option opt(S, K, sigma, q,
+                (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
+                (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            opt.setMaturity(T);
+
+            std::vector<double> rho = static_cast<const MonteCarloPricer&>(*pricer).computeKeyRateRho(opt);
+            for (int i = 0; i < capacity && i < static_cast<int>(rho.size()); ++i) {
+                keyRateRho[i] = rho[i];
+            }
+            return static_cast<int>(rho.size());
+        }
+        catch (const std::exception& ex) {
+            return -1;
+        }
+    }
+
+    int __stdcall PriceOptionMonteCarloBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* prices)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        // Champs propres au modle : courbe des taux partage par le processus et discrtisation.
+        return priceBatchExport(PricerType::MonteCarlo, inputs, [mcNumPaths, mcTimeStepsPerPath](PricingConfiguration& config) {
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.mcNumPaths = mcNumPaths;
+            config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+        }, prices);
+    }
+
+    int __stdcall ComputeOptionGreeksMonteCarloBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        BatchExportInputs inputs = { count, S, K, T, r, sigma, q, optionType, optionStyle, calculationDate };
+        // Champs propres au modle : courbe des taux partage par le processus et discrtisation.
+        return computeGreeksBatchExport(PricerType::MonteCarlo, inputs, [mcNumPaths, mcTimeStepsPerPath](PricingConfiguration& config) {
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.mcNumPaths = mcNumPaths;
+            config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+        }, delta, gamma, vega, theta, rho);
+    }
+
 } // extern "C"
@@ -39,6 +39,39 @@ extern "C" {
         int mcNumPaths, int mcTimeStepsPerPath,
         double* delta, double* gamma, double* vega, double* theta, double* rho);
 
+    // Fonction pour calculer le rho par point de courbe (key-rate rho)  l'aide du modle Monte Carlo.
+    // Les sensibilits du prix au taux de chaque point de la courbe des taux sont crites dans
+    // keyRateRho (au plus capacity valeurs). Renvoie le nombre de points de la courbe, ou -1 en cas d'erreur.
+    MONTE_CARLO_PRICER_API int __stdcall ComputeOptionKeyRateRhoMonteCarlo(
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* keyRateRho, int capacity);
+
+    // Version par lot de PriceOptionMonteCarlo, pour valuer une plage entire en un seul appel.
+    // Les entres S  optionStyle sont des tableaux de count valeurs (une par option) ; la date
+    // de calcul et les paramtres du modle sont communs  toutes les options. Le prix de l'option i
+    // est crit dans prices[i] (-1 en cas d'erreur sur cette option). Renvoie le nombre d'options
+    // values sans erreur, ou -1 si les arguments sont invalides.
+    // Chaque option est value avec son propre taux r[i], exactement comme par PriceOptionMonteCarlo avec les mmes arguments.
+    MONTE_CARLO_PRICER_API int __stdcall PriceOptionMonteCarloBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* prices);
+
+    // Version par lot de ComputeOptionGreeksMonteCarlo. Les Greeks de l'option i sont crits  l'indice i
+    // des tableaux fournis (un tableau nul est ignor ; NAN en cas d'erreur sur cette option).
+    // Renvoie le nombre d'options calcules sans erreur, ou -1 si les arguments sont invalides.
+    // Les taux sont traits comme dans PriceOptionMonteCarloBatch.
+    MONTE_CARLO_PRICER_API int __stdcall ComputeOptionGreeksMonteCarloBatch(
+        int count,
+        const double* S, const double* K, const double* T, const double* r, const double* sigma, const double* q,
+        const int* optionType, const int* optionStyle, const char* calculationDate,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* delta, double* gamma, double* vega, double* theta, double* rho);
+
 #ifdef __cplusplus
 }
 #endif
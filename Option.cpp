@@ -9,6 +9,7 @@
 
 #include "pch.h"
 #include "Option.hpp"
+#include "DateConverter.hpp"
 
  /**
   * @brief Constructeur par dfaut.
@@ -23,7 +24,9 @@
   */
 Option::Option()
     : underlying_(0.0), strike_(0.0), volatility_(0.0), dividend_(0.0),
-    type_(OptionType::Call), style_(OptionStyle::European)
+    type_(OptionType::Call), style_(OptionStyle::European),
+    barrierType_(BarrierType::None), barrier_(0.0),
+    maturityKind_(MaturityKind::Configuration), maturity_(0.0)
 {
     // Constructeur par dfaut : aucune action supplmentaire requise.
 }
@@ -43,7 +46,9 @@ Option::Option()
 Option::Option(double underlying, double strike, double volatility, double dividend,
     OptionType optionType, OptionStyle optionStyle)
     : underlying_(underlying), strike_(strike), volatility_(volatility), dividend_(dividend),
-    type_(optionType), style_(optionStyle)
+    type_(optionType), style_(optionStyle),
+    barrierType_(BarrierType::None), barrier_(0.0),
+    maturityKind_(MaturityKind::Configuration), maturity_(0.0)
 {
     // Initialisation avec les paramtres fournis.
 }
@@ -106,6 +111,30 @@ Option::OptionStyle Option::getOptionStyle() const {
     return style_;
 }
 
+/**
+ * @brief Obtient le type de barrire.
+ * @return Le type de barrire.
+ */
+Option::BarrierType Option::getBarrierType() const {
+    return barrierType_;
+}
+
+/**
+ * @brief Obtient le niveau de la barrire.
+ * @return Le niveau de la barrire.
+ */
+double Option::getBarrier() const {
+    return barrier_;
+}
+
+/**
+ * @brief Obtient les dates d'exercice d'une option bermudenne.
+ * @return Les dates d'exercice en annes.
+ */
+const std::vector<double>& Option::getExerciseTimes() const {
+    return exerciseTimes_;
+}
+
 /**
  * @brief Modifie le prix du sous-jacent.
  * @param underlying Nouveau prix du sous-jacent.
@@ -153,3 +182,83 @@ void Option::setOptionType(OptionType optionType) {
 void Option::setOptionStyle(OptionStyle optionStyle) {
     style_ = optionStyle;
 }
+
+/**
+ * @brief Modifie la barrire de l'option.
+ * @param barrierType Nouveau type de barrire.
+ * @param barrier Nouveau niveau de la barrire.
+ */
+void Option::setBarrier(BarrierType barrierType, double barrier) {
+    barrierType_ = barrierType;
+    barrier_ = barrier;
+}
+
+/**
+ * @brief Modifie les dates d'exercice d'une option bermudenne.
+ * @param exerciseTimes Nouvelles dates d'exercice en annes.
+ */
+void Option::setExerciseTimes(const std::vector<double>& exerciseTimes) {
+    exerciseTimes_ = exerciseTimes;
+}
+
+/**
+ * @brief Indique si l'option a sa propre maturit en annes.
+ * @return true si setMaturity() a t appele.
+ */
+bool Option::hasMaturity() const {
+    return maturityKind_ == MaturityKind::Years;
+}
+
+/**
+ * @brief Indique si l'option a sa propre date d'chance.
+ * @return true si setExpiryDate() a t appele.
+ */
+bool Option::hasExpiryDate() const {
+    return maturityKind_ == MaturityKind::ExpiryDate;
+}
+
+/**
+ * @brief Obtient la maturit propre de l'option.
+ * @return La maturit en annes (0 si l'option n'en a pas).
+ */
+double Option::getMaturity() const {
+    return hasMaturity() ? maturity_ : 0.0;
+}
+
+/**
+ * @brief Obtient la date d'chance propre de l'option.
+ * @return La date d'chance.
+ */
+std::chrono::system_clock::time_point Option::getExpiryDate() const {
+    return expiryDate_;
+}
+
+/**
+ * @brief Donne  l'option sa propre maturit.
+ * @param maturity Maturit en annes.
+ */
+void Option::setMaturity(double maturity) {
+    maturityKind_ = MaturityKind::Years;
+    maturity_ = maturity;
+}
+
+/**
+ * @brief Donne  l'option sa propre date d'chance.
+ *
+ * La date est convertie une fois pour toutes ici, et non  chaque valuation.
+ *
+ * @param expiryDate Date d'chance au format ISO 8601.
+ */
+void Option::setExpiryDate(const std::string& expiryDate) {
+    expiryDate_ = DateConverter::parseDate(expiryDate);
+    maturityKind_ = MaturityKind::ExpiryDate;
+    maturity_ = 0.0;
+}
+
+/**
+ * @brief Retire la maturit ou la date d'chance propre de l'option.
+ */
+void Option::clearMaturity() {
+    maturityKind_ = MaturityKind::Configuration;
+    maturity_ = 0.0;
+}
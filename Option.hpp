@@ -7,7 +7,9 @@
  */
 
 #include "pch.h"
+#include <chrono>
 #include <string>
+#include <vector>
 
  /**
   * @brief Structure regroupant les greeks d'une option.
@@ -42,7 +44,24 @@ public:
      */
     enum class OptionStyle {
         European, /**< Option europenne. */
-        American  /**< Option amricaine. */
+        American, /**< Option amricaine. */
+        Bermudan  /**< Option bermudenne (exercice aux dates de getExerciseTimes()). */
+    };
+
+    /**
+     * @brief Enumration pour le type de barrire.
+     *
+     * Seuls les moteurs binomial et de Crank-Nicolson valuent les barrires. L'arbre binomial
+     * surveille la barrire de faon discrte,  chaque pas de temps. Le moteur de Crank-Nicolson
+     * (schmas CN et HOC) la surveille de faon continue : elle est une condition de Dirichlet de
+     * chaque rsolution implicite. Les autres moteurs rejettent les options  barrire.
+     */
+    enum class BarrierType {
+        None,       /**< Pas de barrire (option vanille). */
+        UpAndOut,   /**< Dsactive si le sous-jacent atteint la barrire par le haut. */
+        DownAndOut, /**< Dsactive si le sous-jacent atteint la barrire par le bas. */
+        UpAndIn,    /**< Active si le sous-jacent atteint la barrire par le haut. */
+        DownAndIn   /**< Active si le sous-jacent atteint la barrire par le bas. */
     };
 
     /**
@@ -103,6 +122,46 @@ public:
      */
     OptionStyle getOptionStyle() const;
 
+    /**
+     * @brief Obtient le type de barrire.
+     * @return Le type de barrire (None pour une option vanille).
+     */
+    BarrierType getBarrierType() const;
+
+    /**
+     * @brief Obtient le niveau de la barrire.
+     * @return Le niveau de la barrire (ignor si le type est None).
+     */
+    double getBarrier() const;
+
+    /**
+     * @brief Obtient les dates d'exercice d'une option bermudenne.
+     * @return Les dates d'exercice en annes, sur la mme base que la maturit de la configuration.
+     */
+    const std::vector<double>& getExerciseTimes() const;
+
+    /**
+     * @brief Indique si l'option a sa propre maturit en annes (voir setMaturity()).
+     */
+    bool hasMaturity() const;
+
+    /**
+     * @brief Indique si l'option a sa propre date d'chance (voir setExpiryDate()).
+     */
+    bool hasExpiryDate() const;
+
+    /**
+     * @brief Obtient la maturit propre de l'option.
+     * @return La maturit en annes (0 si l'option n'en a pas).
+     */
+    double getMaturity() const;
+
+    /**
+     * @brief Obtient la date d'chance propre de l'option.
+     * @return La date d'chance (valeur par dfaut si l'option n'en a pas).
+     */
+    std::chrono::system_clock::time_point getExpiryDate() const;
+
     /**
      * @brief Modifie le prix du sous-jacent.
      * @param underlying Nouveau prix du sous-jacent.
@@ -139,13 +198,63 @@ public:
      */
     void setOptionStyle(OptionStyle optionStyle);
 
+    /**
+     * @brief Modifie la barrire.
+     * @param barrierType Nouveau type de barrire.
+     * @param barrier Nouveau niveau de la barrire.
+     */
+    void setBarrier(BarrierType barrierType, double barrier);
+
+    /**
+     * @brief Modifie les dates d'exercice d'une option bermudenne.
+     * @param exerciseTimes Dates d'exercice en annes (la maturit est toujours une date d'exercice).
+     */
+    void setExerciseTimes(const std::vector<double>& exerciseTimes);
+
+    /**
+     * @brief Donne  l'option sa propre maturit, utilise par les moteurs  la place de celle de la
+     *        configuration (un mme moteur peut alors valuer des options de maturits diffrentes).
+     * @param maturity Maturit en annes, sur la mme base que la maturit de la configuration
+     *        ( partir de la date de calcul).
+     */
+    void setMaturity(double maturity);
+
+    /**
+     * @brief Donne  l'option sa propre date d'chance ; les moteurs en dduisent la maturit  partir
+     *        de la date de calcul de leur configuration (aujourd'hui si elle est vide).
+     * @param expiryDate Date d'chance au format ISO 8601 (par exemple "2026-06-19").
+     * @throw std::runtime_error si la date n'est pas valide.
+     */
+    void setExpiryDate(const std::string& expiryDate);
+
+    /**
+     * @brief Retire la maturit ou la date d'chance propre de l'option (les moteurs utilisent alors
+     *        la maturit de leur configuration).
+     */
+    void clearMaturity();
+
 private:
     double underlying_;   /**< Prix du sous-jacent. */
     double strike_;       /**< Prix d'exercice de l'option. */
     double volatility_;   /**< Volatilit du sous-jacent. */
     double dividend_;     /**< Dividende ventuel. */
     OptionType type_;     /**< Type de l'option (Call/Put). */
-    OptionStyle style_;   /**< Style de l'option (Europenne/Americaine). */
+    OptionStyle style_;   /**< Style de l'option (Europenne/Americaine/Bermudenne). */
+    BarrierType barrierType_;          /**< Type de barrire. */
+    double barrier_;                   /**< Niveau de la barrire. */
+    std::vector<double> exerciseTimes_; /**< Dates d'exercice (options bermudennes). */
+
+    /**
+     * @brief Origine de la maturit de l'option.
+     */
+    enum class MaturityKind {
+        Configuration, /**< Maturit de la configuration du moteur. */
+        Years,         /**< Maturit propre, en annes (maturity_). */
+        ExpiryDate     /**< Date d'chance propre (expiryDate_). */
+    };
+    MaturityKind maturityKind_;                      /**< Origine de la maturit. */
+    double maturity_;                                /**< Maturit propre en annes. */
+    std::chrono::system_clock::time_point expiryDate_; /**< Date d'chance propre. */
 };
 
 #endif // OPTION_HPP
@@ -0,0 +1,173 @@
+/**
+ * @file OptionBatch.cpp
+ * @brief Implementation of the OptionBatch container and of OptionBatchView.
+ */
+
+#include "pch.h"
+#include "OptionBatch.hpp"
+#include <stdexcept>
+
+// ---------------------------------------------------------------------------
+// OptionBatchView
+// ---------------------------------------------------------------------------
+
+OptionBatchView::OptionBatchView()
+    : spot_(nullptr),
+    strike_(nullptr),
+    volatility_(nullptr),
+    dividend_(nullptr),
+    maturity_(nullptr),
+    putBits_(nullptr),
+    americanBits_(nullptr),
+    bitOffset_(0),
+    size_(0)
+{
+}
+
+bool OptionBatchView::allEuropean() const {
+    for (size_t i = 0; i < size_; ++i) {
+        if (isAmerican(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void OptionBatchView::load(size_t i, Option& option) const {
+    option.setUnderlying(spot_[i]);
+    option.setStrike(strike_[i]);
+    option.setVolatility(volatility_[i]);
+    option.setDividend(dividend_[i]);
+    option.setOptionType(optionType(i));
+    option.setOptionStyle(optionStyle(i));
+    option.setMaturity(maturity_[i]);
+}
+
+OptionBatchView OptionBatchView::slice(size_t begin, size_t count) const {
+    if (begin > size_ || count > size_ - begin) {
+        throw std::out_of_range("Option batch slice exceeds the batch.");
+    }
+    OptionBatchView view(*this);
+    if (count == 0) {
+        view.size_ = 0;
+        return view;
+    }
+    view.spot_ += begin;
+    view.strike_ += begin;
+    view.volatility_ += begin;
+    view.dividend_ += begin;
+    view.maturity_ += begin;
+    size_t position = bitOffset_ + begin;
+    view.putBits_ += position >> 6;
+    view.americanBits_ += position >> 6;
+    view.bitOffset_ = position & 63;
+    view.size_ = count;
+    return view;
+}
+
+OptionBatchView OptionBatchView::withMaturities(const double* maturities) const {
+    OptionBatchView view(*this);
+    view.maturity_ = maturities;
+    return view;
+}
+
+// ---------------------------------------------------------------------------
+// OptionBatch
+// ---------------------------------------------------------------------------
+
+OptionBatch::OptionBatch() {
+}
+
+OptionBatch::OptionBatch(const std::vector<Option>& options, double maturity) {
+    reserve(options.size());
+    for (const Option& option : options) {
+        add(option, maturity);
+    }
+}
+
+OptionBatch::OptionBatch(const std::vector<Option>& options, const std::vector<double>& maturities) {
+    if (options.size() != maturities.size()) {
+        throw std::invalid_argument("One maturity per option is required.");
+    }
+    reserve(options.size());
+    for (size_t i = 0; i < options.size(); ++i) {
+        add(options[i], maturities[i]);
+    }
+}
+
+void OptionBatch::reserve(size_t count) {
+    spot_.reserve(count);
+    strike_.reserve(count);
+    volatility_.reserve(count);
+    dividend_.reserve(count);
+    maturity_.reserve(count);
+    putBits_.reserve((count + 63) / 64);
+    americanBits_.reserve((count + 63) / 64);
+}
+
+void OptionBatch::clear() {
+    spot_.clear();
+    strike_.clear();
+    volatility_.clear();
+    dividend_.clear();
+    maturity_.clear();
+    putBits_.clear();
+    americanBits_.clear();
+}
+
+void OptionBatch::add(double spot, double strike, double volatility, double dividend, double maturity,
+    Option::OptionType optionType, Option::OptionStyle optionStyle) {
+    if (optionStyle == Option::OptionStyle::Bermudan) {
+        throw std::invalid_argument("Option batches hold European and American options only.");
+    }
+    size_t i = spot_.size();
+    spot_.push_back(spot);
+    strike_.push_back(strike);
+    volatility_.push_back(volatility);
+    dividend_.push_back(dividend);
+    maturity_.push_back(maturity);
+    setBit(putBits_, i, optionType == Option::OptionType::Put);
+    setBit(americanBits_, i, optionStyle == Option::OptionStyle::American);
+}
+
+void OptionBatch::add(const Option& option, double maturity) {
+    if (option.getBarrierType() != Option::BarrierType::None) {
+        throw std::invalid_argument("Option batches hold vanilla options only.");
+    }
+    add(option.getUnderlying(), option.getStrike(), option.getVolatility(), option.getDividend(), maturity,
+        option.getOptionType(), option.getOptionStyle());
+}
+
+void OptionBatch::add(const Option& option) {
+    if (!option.hasMaturity()) {
+        throw std::invalid_argument("The option has no maturity in years; pass its maturity explicitly.");
+    }
+    add(option, option.getMaturity());
+}
+
+void OptionBatch::setBit(std::vector<std::uint64_t>& bits, size_t i, bool value) {
+    if ((i & 63) == 0) {
+        bits.push_back(0);
+    }
+    if (value) {
+        bits[i >> 6] |= std::uint64_t(1) << (i & 63);
+    }
+}
+
+OptionBatchView OptionBatch::view() const {
+    OptionBatchView view;
+    view.spot_ = spot_.data();
+    view.strike_ = strike_.data();
+    view.volatility_ = volatility_.data();
+    view.dividend_ = dividend_.data();
+    view.maturity_ = maturity_.data();
+    view.putBits_ = putBits_.data();
+    view.americanBits_ = americanBits_.data();
+    view.bitOffset_ = 0;
+    view.size_ = spot_.size();
+    return view;
+}
+
+OptionBatchView OptionBatch::slice(size_t begin, size_t count) const {
+    return view().slice(begin, count);
+}
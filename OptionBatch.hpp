@@ -0,0 +1,253 @@
+#ifndef OPTIONBATCH_HPP
+#define OPTIONBATCH_HPP
+
+/**
+ * @file OptionBatch.hpp
+ * @brief Declaration of the OptionBatch container and of its non-owning OptionBatchView.
+ *
+ * An OptionBatch stores vanilla options as a structure of arrays: one 64-byte aligned column per
+ * parameter (spot, strike, volatility, dividend, maturity) and one bit per option for the type and
+ * for the style. Loops over a batch read contiguous doubles that the compiler can vectorize, instead
+ * of one polymorphic Option object (with its vptr, barrier and exercise dates) at a time.
+ *
+ * OptionBatchView is the span-like type taken by the batch engines: a few pointers and a size,
+ * cheap to copy and to slice into sub-ranges (for instance one range per thread).
+ */
+
+#include "pch.h"
+#include "Option.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Allocator returning memory aligned on Alignment bytes (for the batch columns).
+ */
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+#ifdef _WIN32
+        void* memory = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, Alignment, n * sizeof(T)) != 0) {
+            memory = nullptr;
+        }
+#endif
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/**
+ * @brief Non-owning view of a range of options of an OptionBatch.
+ *
+ * A view is invalidated when options are added to its batch or the batch is destroyed.
+ */
+class OptionBatchView {
+public:
+    /**
+     * @brief Creates an empty view.
+     */
+    OptionBatchView();
+
+    /**
+     * @brief Returns the number of options.
+     */
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    /** @name Columns (size() values each, contiguous). */
+    ///@{
+    const double* spots() const { return spot_; }
+    const double* strikes() const { return strike_; }
+    const double* volatilities() const { return volatility_; }
+    const double* dividends() const { return dividend_; }
+    const double* maturities() const { return maturity_; }
+    ///@}
+
+    /** @name Values of the option i. */
+    ///@{
+    double spot(size_t i) const { return spot_[i]; }
+    double strike(size_t i) const { return strike_[i]; }
+    double volatility(size_t i) const { return volatility_[i]; }
+    double dividend(size_t i) const { return dividend_[i]; }
+    double maturity(size_t i) const { return maturity_[i]; }
+    bool isPut(size_t i) const { return bit(putBits_, i); }
+    bool isAmerican(size_t i) const { return bit(americanBits_, i); }
+    Option::OptionType optionType(size_t i) const { return isPut(i) ? Option::OptionType::Put : Option::OptionType::Call; }
+    Option::OptionStyle optionStyle(size_t i) const { return isAmerican(i) ? Option::OptionStyle::American : Option::OptionStyle::European; }
+    ///@}
+
+    /**
+     * @brief Returns true if all the options are European.
+     */
+    bool allEuropean() const;
+
+    /**
+     * @brief Sets the parameters of an existing Option to those of the option i, its maturity included
+     *        (so that a loop can reuse one Option instead of constructing one per row).
+     */
+    void load(size_t i, Option& option) const;
+
+    /**
+     * @brief Returns the options [begin, begin + count) of this view.
+     * @throw std::out_of_range if the range exceeds the view.
+     */
+    OptionBatchView slice(size_t begin, size_t count) const;
+
+    /**
+     * @brief Returns the same options with other maturities (for instance from another date).
+     * @param maturities size() maturities, which must outlive the returned view.
+     */
+    OptionBatchView withMaturities(const double* maturities) const;
+
+private:
+    friend class OptionBatch;
+
+    bool bit(const std::uint64_t* bits, size_t i) const {
+        size_t position = bitOffset_ + i;
+        return ((bits[position >> 6] >> (position & 63)) & 1u) != 0;
+    }
+
+    const double* spot_;
+    const double* strike_;
+    const double* volatility_;
+    const double* dividend_;
+    const double* maturity_;
+    const std::uint64_t* putBits_;       ///< Bit set: put (1) or call (0).
+    const std::uint64_t* americanBits_;  ///< Bit set: American (1) or European (0).
+    size_t bitOffset_;                   ///< Bit of the first option in the first word of the bit sets.
+    size_t size_;
+};
+
+/**
+ * @brief Structure-of-arrays container of vanilla (European or American) options.
+ */
+class OptionBatch {
+public:
+    /// Alignment of the columns, in bytes (a cache line, and enough for any vector width).
+    static const size_t kAlignment = 64;
+
+    typedef std::vector<double, AlignedAllocator<double, kAlignment>> Column;
+
+    /**
+     * @brief Creates an empty batch.
+     */
+    OptionBatch();
+
+    /**
+     * @brief Converts options sharing one maturity.
+     * @throw std::invalid_argument if an option has a barrier or a Bermudan style.
+     */
+    OptionBatch(const std::vector<Option>& options, double maturity);
+
+    /**
+     * @brief Converts options with their maturities (one per option).
+     * @throw std::invalid_argument if the sizes differ, or if an option has a barrier or a Bermudan style.
+     */
+    OptionBatch(const std::vector<Option>& options, const std::vector<double>& maturities);
+
+    /**
+     * @brief Reserves memory for count options.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Removes all the options (keeping the memory).
+     */
+    void clear();
+
+    /**
+     * @brief Appends an option.
+     * @throw std::invalid_argument if the style is Bermudan.
+     */
+    void add(double spot, double strike, double volatility, double dividend, double maturity,
+        Option::OptionType optionType, Option::OptionStyle optionStyle);
+
+    /**
+     * @brief Appends an option with its maturity.
+     * @throw std::invalid_argument if the option has a barrier or a Bermudan style.
+     */
+    void add(const Option& option, double maturity);
+
+    /**
+     * @brief Appends an option with its own maturity (see Option::setMaturity()).
+     * @throw std::invalid_argument if the option has no maturity in years (an expiry date is resolved
+     *        by an engine configuration: use PricingConfiguration::maturityOf() and the overload above),
+     *        a barrier or a Bermudan style.
+     */
+    void add(const Option& option);
+
+    /**
+     * @brief Returns the number of options.
+     */
+    size_t size() const { return spot_.size(); }
+
+    bool empty() const { return spot_.empty(); }
+
+    /**
+     * @brief Returns a view of all the options.
+     */
+    OptionBatchView view() const;
+
+    /**
+     * @brief Returns a view of the options [begin, begin + count).
+     * @throw std::out_of_range if the range exceeds the batch.
+     */
+    OptionBatchView slice(size_t begin, size_t count) const;
+
+    /** @name Mutable columns, to update values in place (for instance the spot of every option). */
+    ///@{
+    double* spots() { return spot_.data(); }
+    double* strikes() { return strike_.data(); }
+    double* volatilities() { return volatility_.data(); }
+    double* dividends() { return dividend_.data(); }
+    double* maturities() { return maturity_.data(); }
+    ///@}
+
+private:
+    static void setBit(std::vector<std::uint64_t>& bits, size_t i, bool value);
+
+    Column spot_;
+    Column strike_;
+    Column volatility_;
+    Column dividend_;
+    Column maturity_;
+    std::vector<std::uint64_t> putBits_;
+    std::vector<std::uint64_t> americanBits_;
+};
+
+#endif // OPTIONBATCH_HPP
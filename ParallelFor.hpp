@@ -0,0 +1,82 @@
+#ifndef PARALLELFOR_HPP
+#define PARALLELFOR_HPP
+
+/**
+ * @file ParallelFor.hpp
+ * @brief Splitting of a range of independent items (typically the options of a batch) across threads.
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Returns the number of threads to use for count items taken grain at a time.
+ * @param requested Requested number of threads (0 or less = hardware concurrency).
+ * @return A thread count between 1 and the number of blocks of grain items.
+ */
+inline int parallelThreadCount(int requested, size_t count, size_t grain) {
+    int threads = requested;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    size_t blocks = (count + grain - 1) / grain;
+    return static_cast<int>(std::max<size_t>(1, std::min(static_cast<size_t>(std::max(threads, 1)), blocks)));
+}
+
+/**
+ * @brief Calls body(thread, begin, end) on blocks of grain items of [0, count).
+ *
+ * The blocks are taken dynamically, so that threads finishing early take more of them; the calling
+ * thread is thread 0. thread is the index of the thread running the block, in [0, threads), so that
+ * the body can use per-thread storage allocated beforehand. If the body throws, the remaining blocks
+ * are skipped and the first exception is rethrown once all the threads have stopped.
+ *
+ * @param threads Number of threads (see parallelThreadCount()).
+ */
+template <typename Body>
+void parallelFor(size_t count, size_t grain, int threads, const Body& body) {
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&](int thread) {
+        for (;;) {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= count || failed) {
+                return;
+            }
+            try {
+                body(thread, begin, std::min(begin + grain, count));
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads > 1 ? threads - 1 : 0);
+    for (int thread = 1; thread < threads; ++thread) {
+        pool.emplace_back(work, thread);
+    }
+    work(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif // PARALLELFOR_HPP
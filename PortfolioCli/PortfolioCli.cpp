@@ -0,0 +1,872 @@
+/**
+ * @file PortfolioCli.cpp
+ * @brief Command-line tool that prices a CSV portfolio through a parse / price / write pipeline.
+ *
+ * Usage:
+ *
+ *    price-portfolio <input.csv> <output.csv> [options]
+ *
+ *    --greeks                 Also compute delta, gamma, vega, theta and rho.
+ *    --threads N              Number of pricing threads (default: one per hardware thread).
+ *    --batch N                Number of rows per batch (default: 4096).
+ *    --rate R                 Risk-free rate of the rows, when the input has no rate column (default: 0).
+ *    --curve FILE             Yield curve file of the curve-aware engines (default: flat at --rate).
+ *    --date YYYY-MM-DD        Calculation date (default: none, maturities are from now).
+ *    --binomial-steps N, --crank-time-steps N, --crank-spot-steps N, --mc-paths N, --mc-steps N
+ *                             Engine parameters (default: those of PricingConfiguration).
+ *
+ * The input starts with a header naming its columns: spot, strike, volatility, dividend, maturity,
+ * type (0/call, 1/put), style (0/european, 1/american) and engine (PricerType: 0 = Black-Scholes,
+ * 1 = Binomial, ...), in any order, optionally with rate and id; other columns are ignored. Fields
+ * are separated by commas and are not quoted. The output has one line per input row, in the same
+ * order: id (or the row number), price, the Greeks if requested, and status (0 = priced, -1 = error).
+ *
+ * The rate column overrides --rate row by row for every engine: Black-Scholes, COS and Carr-Madan
+ * price at the row rate, and the curve-aware engines (binomial, Crank-Nicolson, Monte Carlo, ADI and
+ * jump-diffusion) price on the curve shifted in parallel by rate - R. Without --curve the curve is
+ * flat at R, so the shifted curve is flat at the row rate.
+ * A throughput report is printed on the standard error at the end.
+ *
+ * One thread reads and parses the input into batches of columns, a pool of threads prices the
+ * batches with PortfolioPricer (which selects the engine of each row with PricerFactory) and formats
+ * their output lines, and the main thread writes the batches back in input order. The stages are
+ * connected by bounded queues, so that the memory used does not depend on the size of the portfolio.
+ *
+ * Build on Linux, from this directory:
+ *
+ *    g++ -std=c++14 -O2 -pthread -I.. PortfolioCli.cpp ../PortfolioPricer.cpp ../PortfolioFile.cpp \
+ *        ../MappedFile.cpp ../PricerFactory.cpp ../BlackScholesPricer.cpp ../BinomialPricer.cpp \
+ *        ../CrankNicolsonPricer.cpp ../MonteCarloPricer.cpp ../AdiPricer.cpp ../JumpDiffusionPricer.cpp \
+ *        ../CosPricer.cpp ../CarrMadanPricer.cpp ../CharacteristicFunction.cpp ../FourierTransform.cpp \
+ *        ../TridiagonalSolver.cpp ../Option.cpp ../OptionBatch.cpp ../InterfaceOptionPricer.cpp \
+ *        ../YieldCurve.cpp ../DateConverter.cpp -o price-portfolio
+ */
+
+#include "pch.h"
+#include "PortfolioPricer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PORTFOLIO_CLI_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+    // ---------------------------------------------------------------------------
+    // Pipeline plumbing
+    // ---------------------------------------------------------------------------
+
+    /**
+     * @brief Queue between two stages: push blocks while the queue is full, pop blocks while it is
+     *        empty and returns false once it is closed and drained.
+     */
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)), closed_(false) {}
+
+        void push(T item) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notFull_.wait(lock, [&] { return items_.size() < capacity_ || closed_; });
+            items_.push_back(std::move(item));
+            notEmpty_.notify_one();
+        }
+
+        bool pop(T& item) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [&] { return !items_.empty() || closed_; });
+            if (items_.empty()) {
+                return false;
+            }
+            item = std::move(items_.front());
+            items_.pop_front();
+            notFull_.notify_one();
+            return true;
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            notEmpty_.notify_all();
+            notFull_.notify_all();
+        }
+
+    private:
+        size_t capacity_;
+        bool closed_;
+        std::deque<T> items_;
+        std::mutex mutex_;
+        std::condition_variable notEmpty_;
+        std::condition_variable notFull_;
+    };
+
+    /**
+     * @brief A batch of consecutive rows, stored as columns, and then their results.
+     */
+    struct Batch {
+        size_t sequence;                        ///< Position of the batch in the input.
+        size_t firstRow;                        ///< Row number (1-based) of the first row.
+        std::vector<double> spot, strike, volatility, dividend, maturity, rate;
+        std::vector<std::int32_t> optionType, optionStyle, engine;
+        std::string ids;                        ///< Identifiers of the rows, concatenated.
+        std::vector<std::uint32_t> idEnds;      ///< End offset of the identifier of each row in ids.
+        std::vector<double> price, delta, gamma, vega, theta, rho;
+        std::vector<std::int32_t> status;
+        std::string text;                       ///< Output lines.
+        size_t failed;                          ///< Number of rows that could not be priced.
+
+        size_t rows() const { return spot.size(); }
+    };
+
+    /// Nanoseconds spent by a stage doing actual work (queue waits excluded).
+    class BusyTime {
+    public:
+        BusyTime() : nanoseconds_(0) {}
+        void add(std::chrono::steady_clock::duration elapsed) {
+            nanoseconds_ += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        }
+        double seconds() const { return static_cast<double>(nanoseconds_.load()) * 1e-9; }
+    private:
+        std::atomic<long long> nanoseconds_;
+    };
+
+    // ---------------------------------------------------------------------------
+    // Parsing
+    // ---------------------------------------------------------------------------
+
+    struct Field {
+        const char* begin;
+        const char* end;
+    };
+
+    /// Roles of the input columns, and the number of required ones.
+    enum Role { Spot, Strike, Volatility, Dividend, Maturity, Type, Style, Engine, RequiredRoles, Rate = RequiredRoles, Id, RoleCount };
+
+    const char* const kRoleNames[RoleCount] = {
+        PortfolioColumnNames::Spot, PortfolioColumnNames::Strike, PortfolioColumnNames::Volatility,
+        PortfolioColumnNames::Dividend, PortfolioColumnNames::Maturity, PortfolioColumnNames::OptionType,
+        PortfolioColumnNames::OptionStyle, PortfolioColumnNames::Engine, PortfolioColumnNames::Rate, "id"
+    };
+
+    inline unsigned countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    /**
+     * @brief Appends the positions of all the commas and line feeds of a chunk to positions.
+     *        With SSE2, 16 bytes are compared at a time and the matches are read from a bit mask,
+     *        so that the parser then jumps from field to field instead of testing every character.
+     */
+    void indexDelimiters(const char* data, size_t length, std::vector<std::uint32_t>& positions) {
+        positions.clear();
+        size_t i = 0;
+#ifdef PORTFOLIO_CLI_SSE2
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline))));
+            while (mask != 0) {
+                positions.push_back(static_cast<std::uint32_t>(i + countTrailingZeros(mask)));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            if (data[i] == ',' || data[i] == '\n') {
+                positions.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+    }
+
+    Field trim(Field field) {
+        while (field.begin < field.end && (*field.begin == ' ' || *field.begin == '\t')) {
+            ++field.begin;
+        }
+        while (field.end > field.begin && (field.end[-1] == ' ' || field.end[-1] == '\t' || field.end[-1] == '\r')) {
+            --field.end;
+        }
+        return field;
+    }
+
+    /**
+     * @brief Parses a decimal number. Plain decimals of up to 15 digits are converted exactly
+     *        with integer arithmetic; anything else (exponents, inf, ...) goes through strtod.
+     */
+    bool parseDouble(Field field, double& value) {
+        static const double kPowersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        field = trim(field);
+        const char* p = field.begin;
+        if (p == field.end) {
+            return false;
+        }
+        bool negative = (*p == '-');
+        if (*p == '-' || *p == '+') {
+            ++p;
+        }
+        std::uint64_t mantissa = 0;
+        int digits = 0;
+        int decimals = 0;
+        bool point = false;
+        for (; p < field.end; ++p) {
+            if (*p >= '0' && *p <= '9') {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                ++digits;
+                decimals += point ? 1 : 0;
+            }
+            else if (*p == '.' && !point) {
+                point = true;
+            }
+            else {
+                break;
+            }
+        }
+        // Exact when the mantissa fits in a double and the power of ten is exact.
+        if (p == field.end && digits > 0 && digits <= 15 && decimals <= 22) {
+            double result = static_cast<double>(mantissa) / kPowersOf10[decimals];
+            value = negative ? -result : result;
+            return true;
+        }
+        std::string text(field.begin, field.end);
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end != text.c_str() && *end == '\0';
+    }
+
+    bool equalsIgnoreCase(Field field, const char* word) {
+        size_t length = std::strlen(word);
+        if (static_cast<size_t>(field.end - field.begin) != length) {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            char c = field.begin[i];
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            if (c != word[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Parses an integer, or one of the two words meaning 0 and 1.
+    bool parseInt(Field field, std::int32_t& value, const char* zeroWord = nullptr, const char* oneWord = nullptr) {
+        field = trim(field);
+        if (zeroWord && equalsIgnoreCase(field, zeroWord)) {
+            value = 0;
+            return true;
+        }
+        if (oneWord && equalsIgnoreCase(field, oneWord)) {
+            value = 1;
+            return true;
+        }
+        const char* p = field.begin;
+        bool negative = (p < field.end && *p == '-');
+        if (negative || (p < field.end && *p == '+')) {
+            ++p;
+        }
+        if (p == field.end || field.end - p > 9) {
+            return false;
+        }
+        std::int32_t result = 0;
+        for (; p < field.end; ++p) {
+            if (*p < '0' || *p > '9') {
+                return false;
+            }
+            result = result * 10 + (*p - '0');
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    /**
+     * @brief Reads the input, parses it into batches and pushes them to the pricing stage.
+     */
+    class Parser {
+    public:
+        Parser(std::FILE* input, const std::vector<int>& roleOfColumn, size_t batchRows)
+            : input_(input), roleOfColumn_(roleOfColumn), batchRows_(batchRows), rows_(0), bytes_(0), sequence_(0),
+            output_(nullptr), busy_(nullptr) {
+            for (int role = 0; role < RoleCount; ++role) {
+                columnOfRole_[role] = -1;
+            }
+            for (size_t c = 0; c < roleOfColumn_.size(); ++c) {
+                if (roleOfColumn_[c] >= 0) {
+                    columnOfRole_[roleOfColumn_[c]] = static_cast<int>(c);
+                }
+            }
+            fields_.resize(roleOfColumn_.size());
+        }
+
+        void run(BoundedQueue<Batch>& output, BusyTime& busy) {
+            const size_t kChunkBytes = 4 << 20;
+            std::vector<char> buffer(kChunkBytes);
+            size_t carried = 0;
+            bool eof = false;
+            output_ = &output;
+            busy_ = &busy;
+            startBatch();
+            while (!eof) {
+                resumed_ = std::chrono::steady_clock::now();
+                if (carried == buffer.size()) {
+                    buffer.resize(buffer.size() * 2); // A line longer than the buffer.
+                }
+                size_t read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, input_);
+                bytes_ += read;
+                size_t length = carried + read;
+                if (read == 0) {
+                    if (std::ferror(input_)) {
+                        throw std::runtime_error("Cannot read the input file.");
+                    }
+                    eof = true;
+                    if (length > 0 && buffer[length - 1] != '\n') {
+                        if (length == buffer.size()) {
+                            buffer.push_back('\n');
+                        }
+                        else {
+                            buffer[length] = '\n';
+                        }
+                        ++length; // Last line without a line feed.
+                    }
+                }
+                // Only complete lines are parsed; the rest is carried over to the next chunk.
+                size_t complete = length;
+                while (complete > 0 && buffer[complete - 1] != '\n') {
+                    --complete;
+                }
+                parseLines(buffer.data(), complete);
+                carried = length - complete;
+                std::memmove(buffer.data(), buffer.data() + complete, carried);
+                busy.add(std::chrono::steady_clock::now() - resumed_);
+            }
+            if (batch_.rows() > 0) {
+                output.push(std::move(batch_));
+            }
+        }
+
+        size_t rows() const { return rows_; }
+        size_t bytes() const { return bytes_; }
+
+    private:
+        void startBatch() {
+            batch_ = Batch();
+            batch_.sequence = sequence_++;
+            batch_.firstRow = rows_ + 1;
+            for (std::vector<double>* column : { &batch_.spot, &batch_.strike, &batch_.volatility, &batch_.dividend, &batch_.maturity }) {
+                column->reserve(batchRows_);
+            }
+            for (std::vector<std::int32_t>* column : { &batch_.optionType, &batch_.optionStyle, &batch_.engine }) {
+                column->reserve(batchRows_);
+            }
+            if (columnOfRole_[Rate] >= 0) {
+                batch_.rate.reserve(batchRows_);
+            }
+            if (columnOfRole_[Id] >= 0) {
+                batch_.idEnds.reserve(batchRows_);
+            }
+        }
+
+        /// Pushes the current batch; the time blocked on a full queue is not counted as busy.
+        void emitBatch() {
+            auto now = std::chrono::steady_clock::now();
+            busy_->add(now - resumed_);
+            output_->push(std::move(batch_));
+            resumed_ = std::chrono::steady_clock::now();
+            startBatch();
+        }
+
+        void parseLines(const char* data, size_t length) {
+            indexDelimiters(data, length, delimiters_);
+            size_t field = 0;
+            const char* fieldBegin = data;
+            for (std::uint32_t position : delimiters_) {
+                const char* fieldEnd = data + position;
+                if (field < fields_.size()) {
+                    fields_[field] = Field{ fieldBegin, fieldEnd };
+                }
+                ++field;
+                fieldBegin = fieldEnd + 1;
+                if (*fieldEnd == '\n') {
+                    // Blank lines are skipped.
+                    if (field > 1 || trim(fields_[0]).begin != trim(fields_[0]).end) {
+                        addRow(field);
+                        if (batch_.rows() == batchRows_) {
+                            emitBatch();
+                        }
+                    }
+                    field = 0;
+                }
+            }
+        }
+
+        Field fieldOf(int role) const {
+            return fields_[static_cast<size_t>(columnOfRole_[role])];
+        }
+
+        void addRow(size_t fieldCount) {
+            ++rows_;
+            double spot = 0.0, strike = 0.0, volatility = 0.0, dividend = 0.0, maturity = 0.0, rate = 0.0;
+            std::int32_t type = 0, style = 0, engine = 0;
+            bool valid = (fieldCount == fields_.size())
+                && parseDouble(fieldOf(Spot), spot)
+                && parseDouble(fieldOf(Strike), strike)
+                && parseDouble(fieldOf(Volatility), volatility)
+                && parseDouble(fieldOf(Dividend), dividend)
+                && parseDouble(fieldOf(Maturity), maturity)
+                && parseInt(fieldOf(Type), type, "call", "put")
+                && parseInt(fieldOf(Style), style, "european", "american")
+                && parseInt(fieldOf(Engine), engine)
+                && (columnOfRole_[Rate] < 0 || parseDouble(fieldOf(Rate), rate));
+            // A malformed row keeps its place in the output: an unknown engine makes it fail pricing.
+            batch_.spot.push_back(spot);
+            batch_.strike.push_back(strike);
+            batch_.volatility.push_back(volatility);
+            batch_.dividend.push_back(dividend);
+            batch_.maturity.push_back(maturity);
+            batch_.optionType.push_back(type);
+            batch_.optionStyle.push_back(style);
+            batch_.engine.push_back(valid ? engine : -1);
+            if (columnOfRole_[Rate] >= 0) {
+                batch_.rate.push_back(rate);
+            }
+            if (columnOfRole_[Id] >= 0) {
+                if (fieldCount == fields_.size()) {
+                    Field id = trim(fieldOf(Id));
+                    batch_.ids.append(id.begin, id.end);
+                }
+                batch_.idEnds.push_back(static_cast<std::uint32_t>(batch_.ids.size()));
+            }
+        }
+
+        std::FILE* input_;
+        std::vector<int> roleOfColumn_;
+        int columnOfRole_[RoleCount];
+        size_t batchRows_;
+        size_t rows_;
+        size_t bytes_;
+        size_t sequence_;
+        Batch batch_;
+        BoundedQueue<Batch>* output_;
+        BusyTime* busy_;
+        std::chrono::steady_clock::time_point resumed_;
+        std::vector<Field> fields_;
+        std::vector<std::uint32_t> delimiters_;
+    };
+
+    /// Splits the header line and maps each column to its role (-1 for ignored columns).
+    std::vector<int> parseHeader(const std::string& line) {
+        std::vector<int> roles;
+        size_t begin = 0;
+        for (;;) {
+            size_t end = line.find(',', begin);
+            Field name = trim(Field{ line.data() + begin, line.data() + (end == std::string::npos ? line.size() : end) });
+            int role = -1;
+            for (int r = 0; r < RoleCount; ++r) {
+                if (equalsIgnoreCase(name, kRoleNames[r])) {
+                    role = r;
+                }
+            }
+            if (role >= 0 && std::find(roles.begin(), roles.end(), role) != roles.end()) {
+                throw std::runtime_error("Duplicate column in the header: " + std::string(kRoleNames[role]));
+            }
+            roles.push_back(role);
+            if (end == std::string::npos) {
+                break;
+            }
+            begin = end + 1;
+        }
+        for (int r = 0; r < RequiredRoles; ++r) {
+            if (std::find(roles.begin(), roles.end(), r) == roles.end()) {
+                throw std::runtime_error("Missing column in the header: " + std::string(kRoleNames[r]));
+            }
+        }
+        return roles;
+    }
+
+    // ---------------------------------------------------------------------------
+    // Pricing and writing
+    // ---------------------------------------------------------------------------
+
+    void priceBatch(const PortfolioPricer& pricer, Batch& batch, bool computeGreeks) {
+        size_t rows = batch.rows();
+        batch.price.resize(rows);
+        batch.status.resize(rows);
+        PortfolioResultColumns results = {};
+        results.price = batch.price.data();
+        results.status = batch.status.data();
+        if (computeGreeks) {
+            for (std::vector<double>* column : { &batch.delta, &batch.gamma, &batch.vega, &batch.theta, &batch.rho }) {
+                column->resize(rows);
+            }
+            results.delta = batch.delta.data();
+            results.gamma = batch.gamma.data();
+            results.vega = batch.vega.data();
+            results.theta = batch.theta.data();
+            results.rho = batch.rho.data();
+        }
+        PortfolioColumns positions = { rows, batch.spot.data(), batch.strike.data(), batch.volatility.data(),
+            batch.dividend.data(), batch.maturity.data(), batch.rate.empty() ? nullptr : batch.rate.data(),
+            batch.optionType.data(), batch.optionStyle.data(), batch.engine.data() };
+        pricer.price(positions, results);
+    }
+
+    /**
+     * @brief Appends the same text as printf("%.12g"), without printf for the usual magnitudes.
+     *        The value is scaled by an exact power of ten and rounded to 12 digits; the scaling error
+     *        is below 1e-4 of the last digit, so the rounding matches printf unless the value is that
+     *        close to a tie, in which case (and for very large or small values) printf is used.
+     */
+    void appendNumber(std::string& out, double value) {
+        static const double kPowersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15 };
+        const double magnitude = std::abs(value);
+        if (magnitude >= 1e-4 && magnitude < 1e12) {
+            int exponent = static_cast<int>(std::floor(std::log10(magnitude)));
+            for (int attempt = 0; attempt < 3 && exponent >= -4 && exponent <= 11; ++attempt) {
+                double scaled = magnitude * kPowersOf10[11 - exponent];
+                double rounded = std::floor(scaled + 0.5);
+                if (rounded >= 1e12) {
+                    ++exponent; // log10 rounded down, or the rounding carried to a new digit.
+                    continue;
+                }
+                if (rounded < 1e11) {
+                    --exponent;
+                    continue;
+                }
+                if (std::abs(scaled - std::floor(scaled) - 0.5) < 1e-3) {
+                    break;
+                }
+                char digits[12];
+                std::uint64_t mantissa = static_cast<std::uint64_t>(rounded);
+                for (int i = 11; i >= 0; --i) {
+                    digits[i] = static_cast<char>('0' + mantissa % 10);
+                    mantissa /= 10;
+                }
+                int last = 11;
+                while (last > exponent && last > 0 && digits[last] == '0') {
+                    --last; // Trailing zeros of the fraction are dropped, as with %g.
+                }
+                if (value < 0.0) {
+                    out += '-';
+                }
+                if (exponent >= 0) {
+                    out.append(digits, static_cast<size_t>(exponent + 1));
+                    if (last > exponent) {
+                        out += '.';
+                        out.append(digits + exponent + 1, static_cast<size_t>(last - exponent));
+                    }
+                }
+                else {
+                    out += "0.";
+                    out.append(static_cast<size_t>(-exponent - 1), '0');
+                    out.append(digits, static_cast<size_t>(last + 1));
+                }
+                return;
+            }
+        }
+        char text[32];
+        int length = std::snprintf(text, sizeof(text), "%.12g", value);
+        out.append(text, static_cast<size_t>(length));
+    }
+
+    /// Formats the output lines of a batch (in the pricing threads, as it costs more than the writing).
+    void formatBatch(Batch& batch, bool computeGreeks) {
+        std::string& line = batch.text;
+        size_t failed = 0;
+        line.clear();
+        line.reserve(batch.rows() * (computeGreeks ? 128 : 40));
+        for (size_t i = 0; i < batch.rows(); ++i) {
+            if (batch.idEnds.empty()) {
+                line += std::to_string(batch.firstRow + i);
+            }
+            else {
+                size_t begin = (i == 0) ? 0 : batch.idEnds[i - 1];
+                line.append(batch.ids, begin, batch.idEnds[i] - begin);
+            }
+            line += ',';
+            appendNumber(line, batch.price[i]);
+            if (computeGreeks) {
+                for (const std::vector<double>* column : { &batch.delta, &batch.gamma, &batch.vega, &batch.theta, &batch.rho }) {
+                    line += ',';
+                    appendNumber(line, (*column)[i]);
+                }
+            }
+            line += (batch.status[i] == 0) ? ",0\n" : ",-1\n";
+            failed += (batch.status[i] == 0) ? 0 : 1;
+        }
+        batch.failed = failed;
+    }
+
+    // ---------------------------------------------------------------------------
+    // Command line
+    // ---------------------------------------------------------------------------
+
+    struct Options {
+        std::string inputPath;
+        std::string outputPath;
+        bool computeGreeks = false;
+        int threads = 0;
+        size_t batchRows = 4096;
+        std::string curvePath;
+        PricingConfiguration config;
+    };
+
+    void printUsage() {
+        std::fprintf(stderr,
+            "Usage: price-portfolio <input.csv> <output.csv> [--greeks] [--threads N] [--batch N]\n"
+            "       [--rate R] [--curve FILE] [--date YYYY-MM-DD] [--binomial-steps N]\n"
+            "       [--crank-time-steps N] [--crank-spot-steps N] [--mc-paths N] [--mc-steps N]\n");
+    }
+
+    Options parseArguments(int argc, char** argv) {
+        Options options;
+        options.config.riskFreeRate = 0.0;
+        std::vector<std::string> paths;
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing value after " + argument);
+                }
+                return argv[++i];
+            };
+            if (argument == "--greeks") {
+                options.computeGreeks = true;
+            }
+            else if (argument == "--threads") {
+                options.threads = std::stoi(value());
+            }
+            else if (argument == "--batch") {
+                options.batchRows = static_cast<size_t>(std::max(1, std::stoi(value())));
+            }
+            else if (argument == "--rate") {
+                options.config.riskFreeRate = std::stod(value());
+            }
+            else if (argument == "--curve") {
+                options.curvePath = value();
+            }
+            else if (argument == "--date") {
+                options.config.calculationDate = value();
+            }
+            else if (argument == "--binomial-steps") {
+                options.config.binomialSteps = std::stoi(value());
+            }
+            else if (argument == "--crank-time-steps") {
+                options.config.crankTimeSteps = std::stoi(value());
+            }
+            else if (argument == "--crank-spot-steps") {
+                options.config.crankSpotSteps = std::stoi(value());
+            }
+            else if (argument == "--mc-paths") {
+                options.config.mcNumPaths = std::stoi(value());
+            }
+            else if (argument == "--mc-steps") {
+                options.config.mcTimeStepsPerPath = std::stoi(value());
+            }
+            else if (!argument.empty() && argument[0] == '-') {
+                throw std::invalid_argument("Unknown option " + argument);
+            }
+            else {
+                paths.push_back(argument);
+            }
+        }
+        if (paths.size() != 2) {
+            throw std::invalid_argument("Expected an input and an output file.");
+        }
+        options.inputPath = paths[0];
+        options.outputPath = paths[1];
+        if (!options.curvePath.empty()) {
+            options.config.yieldCurve.loadFromFile(options.curvePath);
+        }
+        else {
+            // The curve-aware engines need a curve: a single point makes it flat at --rate, and the
+            // rate column of a row shifts it to the row rate (see PortfolioColumns::rate).
+            options.config.yieldCurve.addRatePoint(1.0, options.config.riskFreeRate);
+        }
+        return options;
+    }
+
+    /// Reads the header line.
+    std::string readLine(std::FILE* input) {
+        std::string line;
+        int c;
+        while ((c = std::fgetc(input)) != EOF && c != '\n') {
+            line += static_cast<char>(c);
+        }
+        return line;
+    }
+
+    void run(const Options& options) {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> input(std::fopen(options.inputPath.c_str(), "rb"), &std::fclose);
+        if (!input) {
+            throw std::runtime_error("Cannot open the input file: " + options.inputPath);
+        }
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> output(std::fopen(options.outputPath.c_str(), "wb"), &std::fclose);
+        if (!output) {
+            throw std::runtime_error("Cannot create the output file: " + options.outputPath);
+        }
+
+        std::string header = readLine(input.get());
+        std::vector<int> roles = parseHeader(header);
+        bool hasId = std::find(roles.begin(), roles.end(), static_cast<int>(Id)) != roles.end();
+        std::string outputHeader = hasId ? "id,price" : "row,price";
+        if (options.computeGreeks) {
+            outputHeader += ",delta,gamma,vega,theta,rho";
+        }
+        outputHeader += ",status\n";
+        std::fputs(outputHeader.c_str(), output.get());
+
+        // Each pricing thread prices one batch at a time on its own.
+        const PortfolioPricer pricer(options.config, 1);
+        const int threads = (options.threads > 0) ? options.threads
+            : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+        BoundedQueue<Batch> parsed(2 * static_cast<size_t>(threads));
+        BoundedQueue<Batch> priced(2 * static_cast<size_t>(threads));
+        BusyTime parseTime, priceTime, formatTime, writeTime;
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+        auto fail = [&](std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = error;
+            }
+            parsed.close();
+            priced.close();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+
+        Parser parser(input.get(), roles, options.batchRows);
+        std::thread parserThread([&] {
+            try {
+                parser.run(parsed, parseTime);
+            }
+            catch (...) {
+                fail(std::current_exception());
+            }
+            parsed.close();
+        });
+
+        std::atomic<int> pricing(threads);
+        std::vector<std::thread> pricers;
+        for (int t = 0; t < threads; ++t) {
+            pricers.emplace_back([&] {
+                try {
+                    Batch batch;
+                    while (parsed.pop(batch)) {
+                        auto begin = std::chrono::steady_clock::now();
+                        priceBatch(pricer, batch, options.computeGreeks);
+                        auto pricedAt = std::chrono::steady_clock::now();
+                        priceTime.add(pricedAt - begin);
+                        formatBatch(batch, options.computeGreeks);
+                        formatTime.add(std::chrono::steady_clock::now() - pricedAt);
+                        priced.push(std::move(batch));
+                    }
+                }
+                catch (...) {
+                    fail(std::current_exception());
+                }
+                if (--pricing == 0) {
+                    priced.close();
+                }
+            });
+        }
+
+        // The batches complete out of order: they are held until all the previous ones are written.
+        size_t written = 0;
+        size_t failed = 0;
+        size_t nextSequence = 0;
+        std::map<size_t, Batch> waiting;
+        Batch batch;
+        try {
+            while (priced.pop(batch)) {
+                waiting.emplace(batch.sequence, std::move(batch));
+                for (auto next = waiting.find(nextSequence); next != waiting.end(); next = waiting.find(nextSequence)) {
+                    auto begin = std::chrono::steady_clock::now();
+                    const std::string& text = next->second.text;
+                    if (std::fwrite(text.data(), 1, text.size(), output.get()) != text.size()) {
+                        throw std::runtime_error("Cannot write the output file.");
+                    }
+                    failed += next->second.failed;
+                    written += next->second.rows();
+                    writeTime.add(std::chrono::steady_clock::now() - begin);
+                    waiting.erase(next);
+                    ++nextSequence;
+                }
+            }
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+
+        parserThread.join();
+        for (auto& thread : pricers) {
+            thread.join();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        if (std::fflush(output.get()) != 0) {
+            throw std::runtime_error("Cannot write the output file.");
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double megabytes = static_cast<double>(parser.bytes()) / (1024.0 * 1024.0);
+        std::fprintf(stderr, "Rows:      %zu (%zu priced, %zu failed)\n", written, written - failed, failed);
+        std::fprintf(stderr, "Input:     %.1f MB\n", megabytes);
+        std::fprintf(stderr, "Elapsed:   %.3f s (%.0f rows/s, %.1f MB/s)\n", elapsed,
+            elapsed > 0.0 ? static_cast<double>(written) / elapsed : 0.0, elapsed > 0.0 ? megabytes / elapsed : 0.0);
+        std::fprintf(stderr, "Busy time: parse %.3f s, price %.3f s and format %.3f s on %d threads, write %.3f s\n",
+            parseTime.seconds(), priceTime.seconds(), formatTime.seconds(), threads, writeTime.seconds());
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseArguments(argc, argv);
+    }
+    catch (const std::exception& ex) {
+        std::fprintf(stderr, "Error: %s\n", ex.what());
+        printUsage();
+        return 2;
+    }
+    try {
+        run(options);
+    }
+    catch (const std::exception& ex) {
+        std::fprintf(stderr, "Error: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file PortfolioFile.cpp
+ * @brief Implementation of the memory-mapped columnar portfolio file.
+ */
+
+#include "pch.h"
+#include "PortfolioFile.hpp"
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(PortfolioHeader) == 64, "Unexpected portfolio header size.");
+static_assert(sizeof(ColumnEntry) == 64, "Unexpected column entry size.");
+
+namespace {
+
+    const char kMagic[8] = { 'M', 'M', 'O', 'P', 'P', 'O', 'R', 'T' };
+    const std::uint32_t kFormatVersion = 1;
+
+    size_t valueSize(std::uint32_t type) {
+        switch (static_cast<ColumnType>(type)) {
+        case ColumnType::Float64: return sizeof(double);
+        case ColumnType::Int32: return sizeof(std::int32_t);
+        default: return 0;
+        }
+    }
+
+    std::uint64_t padded(std::uint64_t length) {
+        return (length + 7) & ~static_cast<std::uint64_t>(7);
+    }
+
+} // namespace
+
+PortfolioFile::PortfolioFile()
+    : writable_(false)
+{
+}
+
+std::shared_ptr<const PortfolioFile> PortfolioFile::open(const std::string& path) {
+    std::shared_ptr<PortfolioFile> portfolio(new PortfolioFile());
+    portfolio->file_.openForReading(path, sizeof(PortfolioHeader), "portfolio");
+    portfolio->validate();
+    return portfolio;
+}
+
+std::shared_ptr<PortfolioFile> PortfolioFile::create(const std::string& path, size_t rowCount,
+    const std::vector<ColumnSpec>& columns) {
+    // The whole layout is known in advance, so the file is created at its final size.
+    std::vector<ColumnEntry> entries(columns.size());
+    std::uint64_t offset = sizeof(PortfolioHeader) + columns.size() * sizeof(ColumnEntry);
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const ColumnSpec& spec = columns[c];
+        if (spec.name.empty() || spec.name.size() >= sizeof(ColumnEntry::name)) {
+            throw std::runtime_error("Invalid portfolio column name: " + spec.name);
+        }
+        ColumnEntry& entry = entries[c];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, spec.name.c_str(), spec.name.size());
+        entry.type = static_cast<std::uint32_t>(spec.type);
+        if (valueSize(entry.type) == 0) {
+            throw std::runtime_error("Invalid portfolio column type: " + spec.name);
+        }
+        entry.offset = offset;
+        entry.length = static_cast<std::uint64_t>(rowCount) * valueSize(entry.type);
+        offset += padded(entry.length);
+    }
+
+    std::shared_ptr<PortfolioFile> portfolio(new PortfolioFile());
+    portfolio->writable_ = true;
+    portfolio->file_.createForWriting(path, static_cast<size_t>(offset), "portfolio");
+
+    PortfolioHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.formatVersion = kFormatVersion;
+    header.columnCount = static_cast<std::uint32_t>(columns.size());
+    header.rowCount = rowCount;
+    header.fileSize = offset;
+    std::memcpy(portfolio->file_.data(), &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(portfolio->file_.data() + sizeof(PortfolioHeader), entries.data(), entries.size() * sizeof(ColumnEntry));
+    }
+    return portfolio;
+}
+
+void PortfolioFile::write(const std::string& path, size_t rowCount, const std::vector<ColumnSpec>& columns) {
+    std::shared_ptr<PortfolioFile> portfolio = create(path, rowCount, columns);
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const ColumnEntry& entry = portfolio->directory()[c];
+        if (entry.length > 0) {
+            if (!columns[c].data) {
+                throw std::runtime_error("Missing values for portfolio column: " + columns[c].name);
+            }
+            std::memcpy(portfolio->file_.data() + entry.offset, columns[c].data, static_cast<size_t>(entry.length));
+        }
+    }
+    portfolio->commit();
+}
+
+void PortfolioFile::commit() {
+    if (!writable_) {
+        throw std::runtime_error("Portfolio file is read-only.");
+    }
+    PortfolioHeader* header = reinterpret_cast<PortfolioHeader*>(file_.data());
+    header->checksum = fnv1a(file_.data() + sizeof(PortfolioHeader), file_.size() - sizeof(PortfolioHeader));
+    file_.flush();
+}
+
+void PortfolioFile::validate() const {
+    const PortfolioHeader* header = reinterpret_cast<const PortfolioHeader*>(file_.data());
+    const size_t size = file_.size();
+    const size_t directoryEnd = file_.checkHeader<PortfolioHeader>(kMagic, kFormatVersion, header->columnCount,
+        sizeof(ColumnEntry), "portfolio");
+
+    const ColumnEntry* entries = directory();
+    for (std::uint32_t c = 0; c < header->columnCount; ++c) {
+        const ColumnEntry& entry = entries[c];
+        if (std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr) {
+            throw std::runtime_error("Portfolio column name is not terminated.");
+        }
+        size_t width = valueSize(entry.type);
+        if (width == 0) {
+            throw std::runtime_error("Unknown type of portfolio column: " + std::string(entry.name));
+        }
+        if (entry.offset % 8 != 0 || entry.offset < directoryEnd || entry.offset > size
+            || entry.length > size - entry.offset) {
+            throw std::runtime_error("Portfolio column exceeds the file: " + std::string(entry.name));
+        }
+        if (entry.length != header->rowCount * width) {
+            throw std::runtime_error("Portfolio column has the wrong length: " + std::string(entry.name));
+        }
+    }
+}
+
+const ColumnEntry* PortfolioFile::directory() const {
+    return reinterpret_cast<const ColumnEntry*>(file_.data() + sizeof(PortfolioHeader));
+}
+
+const ColumnEntry& PortfolioFile::column(const std::string& name, ColumnType type) const {
+    const std::uint32_t count = reinterpret_cast<const PortfolioHeader*>(file_.data())->columnCount;
+    for (std::uint32_t c = 0; c < count; ++c) {
+        const ColumnEntry& entry = directory()[c];
+        if (name == entry.name) {
+            if (entry.type != static_cast<std::uint32_t>(type)) {
+                throw std::runtime_error("Portfolio column has the wrong type: " + name);
+            }
+            return entry;
+        }
+    }
+    throw std::runtime_error("No portfolio column named " + name);
+}
+
+size_t PortfolioFile::rowCount() const {
+    return static_cast<size_t>(reinterpret_cast<const PortfolioHeader*>(file_.data())->rowCount);
+}
+
+bool PortfolioFile::hasColumn(const std::string& name) const {
+    const std::uint32_t count = reinterpret_cast<const PortfolioHeader*>(file_.data())->columnCount;
+    for (std::uint32_t c = 0; c < count; ++c) {
+        if (name == directory()[c].name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const double* PortfolioFile::float64Column(const std::string& name) const {
+    return reinterpret_cast<const double*>(file_.data() + column(name, ColumnType::Float64).offset);
+}
+
+const std::int32_t* PortfolioFile::int32Column(const std::string& name) const {
+    return reinterpret_cast<const std::int32_t*>(file_.data() + column(name, ColumnType::Int32).offset);
+}
+
+double* PortfolioFile::mutableFloat64Column(const std::string& name) {
+    if (!writable_) {
+        throw std::runtime_error("Portfolio file is read-only.");
+    }
+    return reinterpret_cast<double*>(file_.data() + column(name, ColumnType::Float64).offset);
+}
+
+std::int32_t* PortfolioFile::mutableInt32Column(const std::string& name) {
+    if (!writable_) {
+        throw std::runtime_error("Portfolio file is read-only.");
+    }
+    return reinterpret_cast<std::int32_t*>(file_.data() + column(name, ColumnType::Int32).offset);
+}
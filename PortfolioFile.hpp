@@ -0,0 +1,158 @@
+#ifndef PORTFOLIOFILE_HPP
+#define PORTFOLIOFILE_HPP
+
+/**
+ * @file PortfolioFile.hpp
+ * @brief Declaration of the memory-mapped columnar portfolio file.
+ *
+ * A portfolio file stores one column per field (spot, strike, ...) for all the positions, behind
+ * a header and a column directory, in the same way as the market-data snapshots. Input files are
+ * mapped read-only and their columns are read in place; result files are created at their final
+ * size, mapped for writing, and filled directly by the pricing threads, so that no row is copied
+ * or converted on the way in or out.
+ *
+ * Layout (little-endian, every block aligned on 8 bytes):
+ *
+ *    header     PortfolioHeader (64 bytes)
+ *    directory  columnCount x ColumnEntry (64 bytes each)
+ *    columns    rowCount values each (8-byte doubles or 4-byte integers, padded to 8 bytes)
+ *
+ * The checksum is the 64-bit FNV-1a hash of every byte after the header.
+ *
+ * Files are mapped by MappedFile (Win32 file mapping on Windows, mmap elsewhere), so that the same
+ * files can be priced by the DLL and by the command-line tools on Linux.
+ */
+
+#include "pch.h"
+#include "MappedFile.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/**
+ * @brief Type of the values of a column.
+ */
+enum class ColumnType : std::uint32_t {
+    Float64 = 1, ///< double
+    Int32 = 2    ///< std::int32_t
+};
+
+/**
+ * @brief Fixed-size header at the start of a portfolio file.
+ */
+struct PortfolioHeader {
+    char magic[8];                   ///< "MMOPPORT".
+    std::uint32_t formatVersion;     ///< Version of the layout (currently 1).
+    std::uint32_t columnCount;       ///< Number of entries in the directory.
+    std::uint64_t rowCount;          ///< Number of values of every column.
+    std::uint64_t fileSize;          ///< Total size of the file in bytes.
+    std::uint64_t checksum;          ///< FNV-1a hash of the bytes following the header.
+    std::uint8_t reserved[24];       ///< Zero.
+};
+
+/**
+ * @brief Directory entry describing one column.
+ */
+struct ColumnEntry {
+    char name[40];                   ///< Null-terminated column name.
+    std::uint32_t type;              ///< ColumnType of the values.
+    std::uint32_t reserved;          ///< Zero.
+    std::uint64_t offset;            ///< Offset of the values from the start of the file.
+    std::uint64_t length;            ///< Length of the values in bytes (without padding).
+};
+
+/**
+ * @brief Name and type of a column, and its values when writing a whole file at once.
+ */
+struct ColumnSpec {
+    std::string name;          ///< Column name (at most 39 characters).
+    ColumnType type;           ///< Type of the values.
+    const void* data;          ///< rowCount values for write(); ignored by create().
+};
+
+/**
+ * @brief A memory-mapped portfolio file, read-only (open) or being written (create).
+ */
+class PortfolioFile {
+public:
+    /**
+     * @brief Maps a portfolio file read-only and validates it.
+     * @param path The path of the file.
+     * @return The file.
+     * @throw std::runtime_error if the file cannot be mapped, or if its header, directory or
+     *        checksum is invalid.
+     */
+    static std::shared_ptr<const PortfolioFile> open(const std::string& path);
+
+    /**
+     * @brief Creates a file with the given columns, maps it for writing and returns it.
+     *        The columns are filled through the mutable accessors, then commit() is called.
+     * @param path The path of the file to create.
+     * @param rowCount The number of values of every column.
+     * @param columns The names and types of the columns.
+     * @throw std::runtime_error if the file cannot be created or a name is invalid.
+     */
+    static std::shared_ptr<PortfolioFile> create(const std::string& path, size_t rowCount,
+        const std::vector<ColumnSpec>& columns);
+
+    /**
+     * @brief Writes a whole file from columns held in memory.
+     * @throw std::runtime_error if the file cannot be written or a name is invalid.
+     */
+    static void write(const std::string& path, size_t rowCount, const std::vector<ColumnSpec>& columns);
+
+    PortfolioFile(const PortfolioFile&) = delete;
+    PortfolioFile& operator=(const PortfolioFile&) = delete;
+
+    /**
+     * @brief Returns the number of rows.
+     */
+    size_t rowCount() const;
+
+    /**
+     * @brief Returns true if the file has a column with this name (of any type).
+     */
+    bool hasColumn(const std::string& name) const;
+
+    /**
+     * @brief Returns the values of a column of doubles, in the mapped memory.
+     * @throw std::runtime_error if there is no such column of doubles.
+     */
+    const double* float64Column(const std::string& name) const;
+
+    /**
+     * @brief Returns the values of a column of integers, in the mapped memory.
+     * @throw std::runtime_error if there is no such column of integers.
+     */
+    const std::int32_t* int32Column(const std::string& name) const;
+
+    /**
+     * @brief Returns the values of a column of doubles of a file being written.
+     * @throw std::runtime_error if the file is read-only or there is no such column.
+     */
+    double* mutableFloat64Column(const std::string& name);
+
+    /**
+     * @brief Returns the values of a column of integers of a file being written.
+     * @throw std::runtime_error if the file is read-only or there is no such column.
+     */
+    std::int32_t* mutableInt32Column(const std::string& name);
+
+    /**
+     * @brief Computes the checksum of a file being written and flushes it to disk.
+     */
+    void commit();
+
+private:
+    PortfolioFile();
+
+    void validate() const;
+    const ColumnEntry* directory() const;
+    const ColumnEntry& column(const std::string& name, ColumnType type) const;
+
+    MappedFile file_;
+    bool writable_;
+};
+
+#endif // PORTFOLIOFILE_HPP
@@ -0,0 +1,321 @@
+/**
+ * @file PortfolioPricer.cpp
+ * @brief Implementation of the PortfolioPricer class.
+ */
+
+#include "pch.h"
+#include "PortfolioPricer.hpp"
+#include "PortfolioFile.hpp"
+#include "PricerFactory.hpp"
+#include "BatchPricing.hpp"
+#include "DateConverter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// Rows taken at a time by a worker: small enough to balance slow engines, large enough to
+    /// keep the output columns of different workers on different cache lines.
+    const size_t kBlockRows = 256;
+
+    const int kEngineCount = static_cast<int>(PricerType::CarrMadan) + 1;
+
+    // Engines whose effective maturity is T minus the time elapsed since the calculation date.
+    // The binomial engine uses T as given.
+    bool appliesCalculationDate(PricerType type) {
+        return type != PricerType::Binomial;
+    }
+
+    /// Maturity at which an engine prices an option of maturity T; NAN if the calculation date
+    /// is already past T.
+    double effectiveMaturity(PricerType type, double T, double dateOffset) {
+        if (!appliesCalculationDate(type)) {
+            return T;
+        }
+        return dateOffset < T ? T - dateOffset : NAN;
+    }
+
+    /// Rows of PortfolioColumns.
+    class ColumnRows {
+    public:
+        ColumnRows(const PortfolioColumns& positions, double dateOffset) : positions_(positions), dateOffset_(dateOffset) {}
+        size_t size() const { return positions_.rows; }
+        int engine(size_t i) const { return positions_.engine[i]; }
+        double rate(size_t i, double defaultRate) const { return positions_.rate ? positions_.rate[i] : defaultRate; }
+        /// Effective maturity of a row with a valid engine.
+        double maturity(size_t i) const {
+            return effectiveMaturity(static_cast<PricerType>(positions_.engine[i]), positions_.maturity[i], dateOffset_);
+        }
+        /// Copies the rows [begin, end) into batch, with their effective maturities.
+        OptionBatchView range(size_t begin, size_t end, OptionBatch& batch) const {
+            batch.clear();
+            for (size_t i = begin; i < end; ++i) {
+                batch.add(positions_.spot[i], positions_.strike[i], positions_.volatility[i], positions_.dividend[i],
+                    maturity(i), positions_.optionType[i] == 0 ? Option::OptionType::Call : Option::OptionType::Put,
+                    positions_.optionStyle[i] == 0 ? Option::OptionStyle::European : Option::OptionStyle::American);
+            }
+            return batch.view();
+        }
+        void load(size_t i, Option& option) const {
+            option.setUnderlying(positions_.spot[i]);
+            option.setStrike(positions_.strike[i]);
+            option.setVolatility(positions_.volatility[i]);
+            option.setDividend(positions_.dividend[i]);
+            option.setOptionType(positions_.optionType[i] == 0 ? Option::OptionType::Call : Option::OptionType::Put);
+            option.setOptionStyle(positions_.optionStyle[i] == 0 ? Option::OptionStyle::European : Option::OptionStyle::American);
+            option.setMaturity(maturity(i));
+        }
+
+    private:
+        const PortfolioColumns& positions_;
+        double dateOffset_;
+    };
+
+    /// Rows of an OptionBatchView, all priced with one engine at the configuration's rate. The
+    /// effective maturities are computed once, and the rows are passed to the engine in place.
+    class BatchRows {
+    public:
+        BatchRows(const OptionBatchView& batch, PricerType engine, double dateOffset)
+            : maturities_(batch.size()),
+            engine_(static_cast<int>(engine))
+        {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                maturities_[i] = effectiveMaturity(engine, batch.maturity(i), dateOffset);
+            }
+            batch_ = batch.withMaturities(maturities_.data());
+        }
+        BatchRows(const BatchRows&) = delete;
+        BatchRows& operator=(const BatchRows&) = delete;
+
+        size_t size() const { return batch_.size(); }
+        int engine(size_t) const { return engine_; }
+        double rate(size_t, double defaultRate) const { return defaultRate; }
+        double maturity(size_t i) const { return maturities_[i]; }
+        OptionBatchView range(size_t begin, size_t end, OptionBatch&) const { return batch_.slice(begin, end - begin); }
+        void load(size_t i, Option& option) const { batch_.load(i, option); }
+
+    private:
+        std::vector<double> maturities_;
+        OptionBatchView batch_;
+        int engine_;
+    };
+
+    /// Marks the row i as failed: price -1, NAN Greeks and status -1.
+    void setFailed(const PortfolioResultColumns& results, size_t i) {
+        results.price[i] = -1.0;
+        if (results.delta) {
+            results.delta[i] = results.gamma[i] = results.vega[i] = results.theta[i] = results.rho[i] = NAN;
+        }
+        if (results.status) {
+            results.status[i] = -1;
+        }
+    }
+
+    /// Writes the Greeks (if requested) and the status of the priced row i.
+    void setPriced(const PortfolioResultColumns& results, size_t i, const Greeks* greeks) {
+        if (results.delta) {
+            results.delta[i] = greeks->delta;
+            results.gamma[i] = greeks->gamma;
+            results.vega[i] = greeks->vega;
+            results.theta[i] = greeks->theta;
+            results.rho[i] = greeks->rho;
+        }
+        if (results.status) {
+            results.status[i] = 0;
+        }
+    }
+
+    template <typename Rows>
+    void priceRows(const std::shared_ptr<const PricingConfiguration>& config, const Rows& positions,
+        const PortfolioResultColumns& results, std::atomic<size_t>& nextRow, std::atomic<size_t>& succeeded) {
+        Option option;
+        OptionBatch batch;
+        std::vector<Greeks> greeks;
+        std::unique_ptr<IOptionPricer> pricers[kEngineCount];
+        double pricerShift[kEngineCount] = {};
+        const bool computeGreeks = (results.delta != nullptr);
+        const size_t rows = positions.size();
+        size_t priced = 0;
+
+        for (;;) {
+            size_t begin = nextRow.fetch_add(kBlockRows);
+            if (begin >= rows) {
+                break;
+            }
+            size_t end = std::min(begin + kBlockRows, rows);
+            size_t i = begin;
+            while (i < end) {
+                int engine = positions.engine(i);
+                if (engine < 0 || engine >= kEngineCount || std::isnan(positions.maturity(i))) {
+                    // Unknown engine, or calculation date after the maturity.
+                    setFailed(results, i);
+                    ++i;
+                    continue;
+                }
+                // The following rows with the same engine and rate are priced by one batch call.
+                double rate = positions.rate(i, config->riskFreeRate);
+                size_t runEnd = i + 1;
+                while (runEnd < end && positions.engine(runEnd) == engine && positions.rate(runEnd, config->riskFreeRate) == rate
+                    && !std::isnan(positions.maturity(runEnd))) {
+                    ++runEnd;
+                }
+                const size_t count = runEnd - i;
+
+                priced += priceRunWithFallback(i, runEnd,
+                    [&]() {
+                        // One pricer per engine serves every maturity; another one is built on the shared
+                        // configuration, with the shift of the rate, only when the rate changes.
+                        double shift = rate - config->riskFreeRate;
+                        if (!pricers[engine] || pricerShift[engine] != shift) {
+                            pricers[engine] = PricerFactory::createPricer(static_cast<PricerType>(engine), config, PricingBump(shift));
+                            pricers[engine]->prepare();
+                            pricerShift[engine] = shift;
+                        }
+                        OptionBatchView run = positions.range(i, runEnd, batch);
+                        pricers[engine]->priceBatch(run, results.price + i);
+                        if (computeGreeks) {
+                            greeks.resize(count);
+                            pricers[engine]->computeGreeksBatch(run, greeks.data());
+                        }
+                        for (size_t k = 0; k < count; ++k) {
+                            setPriced(results, i + k, computeGreeks ? &greeks[k] : nullptr);
+                        }
+                    },
+                    [&](size_t k) {
+                        if (!pricers[engine]) {
+                            throw std::runtime_error("No pricer.");
+                        }
+                        positions.load(k, option);
+                        double price = pricers[engine]->price(option);
+                        Greeks rowGreeks = {};
+                        if (computeGreeks) {
+                            rowGreeks = pricers[engine]->computeGreeks(option);
+                        }
+                        results.price[k] = price;
+                        setPriced(results, k, &rowGreeks);
+                    },
+                    [&](size_t k, const std::exception&) {
+                        setFailed(results, k);
+                    });
+                i = runEnd;
+            }
+        }
+        succeeded += priced;
+    }
+
+    void checkResultColumns(const PortfolioResultColumns& results) {
+        if (!results.price) {
+            throw std::invalid_argument("Missing price column.");
+        }
+        if (results.delta && (!results.gamma || !results.vega || !results.theta || !results.rho)) {
+            throw std::invalid_argument("Missing Greek column.");
+        }
+    }
+
+    template <typename Rows>
+    size_t priceInParallel(const std::shared_ptr<const PricingConfiguration>& config, int threadCount,
+        const Rows& positions, const PortfolioResultColumns& results) {
+        std::atomic<size_t> nextRow(0);
+        std::atomic<size_t> succeeded(0);
+        size_t blocks = (positions.size() + kBlockRows - 1) / kBlockRows;
+        size_t workers = std::min(static_cast<size_t>(threadCount), blocks);
+
+        // The calling thread is one of the workers.
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(priceRows<Rows>, std::cref(config), std::cref(positions), std::cref(results),
+                std::ref(nextRow), std::ref(succeeded));
+        }
+        priceRows(config, positions, results, nextRow, succeeded);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return succeeded;
+    }
+
+} // namespace
+
+PortfolioPricer::PortfolioPricer(const PricingConfiguration& config, int threads)
+    : dateOffset_(0.0),
+    threads_(threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+{
+    // Resolved once: the engines would otherwise parse the date on every call.
+    auto shared = std::make_shared<PricingConfiguration>(config);
+    // The workers already share the rows: the batch calls of each worker stay on its thread.
+    shared->batchThreads = 1;
+    if (!shared->calculationDate.empty()) {
+        dateOffset_ = DateConverter::yearsBetween(DateConverter::parseDate(shared->calculationDate), std::chrono::system_clock::now());
+        shared->calculationDate.clear();
+    }
+    config_ = shared;
+}
+
+size_t PortfolioPricer::price(const PortfolioColumns& positions, const PortfolioResultColumns& results) const {
+    if (positions.rows == 0) {
+        return 0;
+    }
+    if (!positions.spot || !positions.strike || !positions.volatility || !positions.dividend || !positions.maturity
+        || !positions.optionType || !positions.optionStyle || !positions.engine) {
+        throw std::invalid_argument("Missing portfolio column.");
+    }
+    checkResultColumns(results);
+    return priceInParallel(config_, threads_, ColumnRows(positions, dateOffset_), results);
+}
+
+size_t PortfolioPricer::price(const OptionBatchView& batch, PricerType engine, const PortfolioResultColumns& results) const {
+    if (batch.empty()) {
+        return 0;
+    }
+    checkResultColumns(results);
+    return priceInParallel(config_, threads_, BatchRows(batch, engine, dateOffset_), results);
+}
+
+size_t PortfolioPricer::priceFile(const std::string& inputPath, const std::string& outputPath, bool computeGreeks) const {
+    namespace Names = PortfolioColumnNames;
+    std::shared_ptr<const PortfolioFile> input = PortfolioFile::open(inputPath);
+
+    PortfolioColumns positions;
+    positions.rows = input->rowCount();
+    positions.spot = input->float64Column(Names::Spot);
+    positions.strike = input->float64Column(Names::Strike);
+    positions.volatility = input->float64Column(Names::Volatility);
+    positions.dividend = input->float64Column(Names::Dividend);
+    positions.maturity = input->float64Column(Names::Maturity);
+    positions.rate = input->hasColumn(Names::Rate) ? input->float64Column(Names::Rate) : nullptr;
+    positions.optionType = input->int32Column(Names::OptionType);
+    positions.optionStyle = input->int32Column(Names::OptionStyle);
+    positions.engine = input->int32Column(Names::Engine);
+
+    std::vector<ColumnSpec> columns = {
+        { Names::Price, ColumnType::Float64, nullptr },
+        { Names::Status, ColumnType::Int32, nullptr }
+    };
+    if (computeGreeks) {
+        for (const char* name : { Names::Delta, Names::Gamma, Names::Vega, Names::Theta, Names::Rho }) {
+            columns.push_back({ name, ColumnType::Float64, nullptr });
+        }
+    }
+    std::shared_ptr<PortfolioFile> output = PortfolioFile::create(outputPath, positions.rows, columns);
+
+    PortfolioResultColumns results = {};
+    results.price = output->mutableFloat64Column(Names::Price);
+    results.status = output->mutableInt32Column(Names::Status);
+    if (computeGreeks) {
+        results.delta = output->mutableFloat64Column(Names::Delta);
+        results.gamma = output->mutableFloat64Column(Names::Gamma);
+        results.vega = output->mutableFloat64Column(Names::Vega);
+        results.theta = output->mutableFloat64Column(Names::Theta);
+        results.rho = output->mutableFloat64Column(Names::Rho);
+    }
+
+    size_t priced = price(positions, results);
+    output->commit();
+    return priced;
+}
@@ -0,0 +1,127 @@
+#ifndef PORTFOLIOPRICER_HPP
+#define PORTFOLIOPRICER_HPP
+
+/**
+ * @file PortfolioPricer.hpp
+ * @brief Declaration of the PortfolioPricer class, which prices columnar portfolios in parallel.
+ *
+ * Positions are read directly from their columns (typically those of a mapped PortfolioFile) and
+ * results are written directly into result columns (typically those of a PortfolioFile being
+ * created), so that a portfolio of millions of options is never converted to a vector of objects.
+ * Each worker thread keeps one engine per pricer type, which prices every maturity, and passes each run
+ * of consecutive rows with the same engine and rate to it as one OptionBatchView (priceBatch() and
+ * computeGreeksBatch()): the rows of an OptionBatch are passed in place, those of PortfolioColumns are
+ * copied into a batch reused by the worker. If a batch call fails, its rows are priced one by one, so
+ * that only the failing rows are marked. All the engines share one copy of the configuration; the rate
+ * of a row is given to the engine as a parallel shift (PricingBump) from the configuration's rate, so
+ * that it moves the yield curve of the curve engines as well as the rate of the others, and an engine
+ * is built again only when the rate differs from the previous run priced with it.
+ */
+
+#include "pch.h"
+#include "PricingConfiguration.hpp"
+#include "OptionBatch.hpp"
+#include "PricerFactory.hpp"
+#include <string>
+#include <memory>
+#include <cstdint>
+
+/// Names of the columns of portfolio files (positions) and of result files.
+namespace PortfolioColumnNames {
+    const char* const Spot = "spot";               ///< double: underlying price.
+    const char* const Strike = "strike";           ///< double: strike.
+    const char* const Volatility = "volatility";   ///< double: volatility.
+    const char* const Dividend = "dividend";       ///< double: continuous dividend yield.
+    const char* const Maturity = "maturity";       ///< double: maturity in years.
+    const char* const Rate = "rate";               ///< double, optional: risk-free rate (default: the configuration's; see PortfolioColumns::rate).
+    const char* const OptionType = "type";         ///< int32: 0 = Call, 1 = Put.
+    const char* const OptionStyle = "style";       ///< int32: 0 = European, 1 = American.
+    const char* const Engine = "engine";           ///< int32: PricerType (0 = Black-Scholes, 1 = Binomial, ...).
+
+    const char* const Price = "price";             ///< double: price (-1 on error).
+    const char* const Delta = "delta";             ///< double: Greeks (NAN on error), if requested.
+    const char* const Gamma = "gamma";
+    const char* const Vega = "vega";
+    const char* const Theta = "theta";
+    const char* const Rho = "rho";
+    const char* const Status = "status";           ///< int32: 0 on success, -1 on error.
+}
+
+/**
+ * @brief Input columns of a portfolio: rows values each.
+ */
+struct PortfolioColumns {
+    size_t rows;
+    const double* spot;
+    const double* strike;
+    const double* volatility;
+    const double* dividend;
+    const double* maturity;
+    /// Optional (null: the configuration's riskFreeRate). The engines without a curve use it as their rate;
+    /// the curve engines price on the configuration's curve shifted in parallel by rate - riskFreeRate,
+    /// which is the curve flat at this rate when the configuration's curve is flat at riskFreeRate.
+    const double* rate;
+    const std::int32_t* optionType;
+    const std::int32_t* optionStyle;
+    const std::int32_t* engine;
+};
+
+/**
+ * @brief Output columns of a portfolio: rows values each.
+ */
+struct PortfolioResultColumns {
+    double* price;
+    double* delta;                    ///< The five Greek columns are either all set or all null (price only).
+    double* gamma;
+    double* vega;
+    double* theta;
+    double* rho;
+    std::int32_t* status;             ///< Optional.
+};
+
+/**
+ * @brief Prices columnar portfolios on several threads.
+ */
+class PortfolioPricer {
+public:
+    /**
+     * @brief Constructor.
+     * @param config The configuration shared by all the positions (calculation date, rate, yield curve,
+     *        engine parameters); the rate of each row shifts its rate and curve (see PortfolioColumns::rate),
+     *        and each row is priced at its own maturity. Its batchThreads is not used: each batch call
+     *        runs on the worker thread that makes it.
+     * @param threads Number of worker threads (0 = one per hardware thread).
+     */
+    explicit PortfolioPricer(const PricingConfiguration& config, int threads = 0);
+
+    /**
+     * @brief Prices the rows of the input columns into the output columns.
+     *        An invalid or failing row gets price -1, NAN Greeks and status -1; the others are priced.
+     * @return The number of rows priced successfully.
+     * @throw std::invalid_argument if a required column is null.
+     */
+    size_t price(const PortfolioColumns& positions, const PortfolioResultColumns& results) const;
+
+    /**
+     * @brief Prices the options of a batch with one engine, each at its own maturity and at the
+     *        configuration's rate; results are indexed like the batch.
+     * @return The number of options priced successfully.
+     * @throw std::invalid_argument if the price column is null.
+     */
+    size_t price(const OptionBatchView& batch, PricerType engine, const PortfolioResultColumns& results) const;
+
+    /**
+     * @brief Maps a portfolio file, prices it and writes the results to a new portfolio file with the
+     *        columns price, status and, if requested, delta, gamma, vega, theta and rho.
+     * @return The number of rows priced successfully.
+     * @throw std::runtime_error if a file cannot be read or written or a column is missing.
+     */
+    size_t priceFile(const std::string& inputPath, const std::string& outputPath, bool computeGreeks) const;
+
+private:
+    std::shared_ptr<const PricingConfiguration> config_; ///< Without the calculation date, which is folded into the maturities.
+    double dateOffset_;             ///< Years from the calculation date to now.
+    int threads_;
+};
+
+#endif // PORTFOLIOPRICER_HPP
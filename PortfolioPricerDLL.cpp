@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "PortfolioPricerDLL.hpp"
+#include "PortfolioPricer.hpp"
+#include "PricingConfiguration.hpp"
+#include "DateConverter.hpp"
+#include "YieldCurveCache.hpp"
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+
+    int __stdcall PricePortfolioFile(
+        const char* inputPath, const char* outputPath, int computeGreeks, double r, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath, int threads)
+    {
+        try {
+            if (inputPath == nullptr || outputPath == nullptr)
+                throw std::invalid_argument("Null path.");
+            PricingConfiguration config;
+            std::string dateStr = (calculationDate != nullptr) ? calculationDate : "";
+            if (dateStr.empty())
+                dateStr = DateConverter::getTodayDate();
+            config.calculationDate = dateStr;
+            config.riskFreeRate = r;
+            // The Black-Scholes engine ignores the curve, so it can be set for all the rows.
+            config.yieldCurve = *YieldCurveCache::defaultCurve();
+            config.binomialSteps = binomialSteps;
+            config.crankTimeSteps = crankTimeSteps;
+            config.crankSpotSteps = crankSpotSteps;
+            config.S_max = S_max;
+            config.mcNumPaths = mcNumPaths;
+            config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+
+            PortfolioPricer pricer(config, threads);
+            return static_cast<int>(pricer.priceFile(inputPath, outputPath, computeGreeks != 0));
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+} // extern "C"
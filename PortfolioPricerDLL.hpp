@@ -0,0 +1,42 @@
+#ifndef PORTFOLIO_PRICER_DLL_HPP
+#define PORTFOLIO_PRICER_DLL_HPP
+
+#ifdef PORTFOLIO_PRICER_DLL_EXPORTS
+#define PORTFOLIO_PRICER_API __declspec(dllexport)
+#else
+#define PORTFOLIO_PRICER_API __declspec(dllimport)
+#endif
+
+#include "pch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Function to price a whole portfolio file in parallel and write the results to a new file.
+    // The input is a columnar portfolio file (see PortfolioFile.hpp) with the columns spot, strike,
+    // volatility, dividend, maturity, type, style, engine and, optionally, rate; it is memory-mapped
+    // and read in place. The output file has the columns price and status and, if computeGreeks is
+    // non-zero, delta, gamma, vega, theta and rho; the results are written directly into its mapping.
+    // Parameters:
+    //  inputPath, outputPath: Null-terminated paths of the portfolio and result files
+    //  computeGreeks: 0 = prices only, 1 = prices and Greeks
+    //  r: Risk-free interest rate of the rows, if the file has no rate column. With a rate column, the
+    //      engines without a curve use the rate of the row, and the curve engines the shared yield curve
+    //      shifted in parallel by the rate of the row minus r.
+    //  calculationDate: A null-terminated string in "YYYY-MM-DD"; if empty, today's date is used.
+    //  binomialSteps, crankTimeSteps, crankSpotSteps, S_max, mcNumPaths, mcTimeStepsPerPath:
+    //      Engine parameters, as in CreatePricingSession
+    //  threads: Number of worker threads (0 = one per hardware thread)
+    // Returns the number of options priced successfully (failed rows have price -1 and status -1),
+    // or -1 if a file cannot be read or written.
+    PORTFOLIO_PRICER_API int __stdcall PricePortfolioFile(
+        const char* inputPath, const char* outputPath, int computeGreeks, double r, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PORTFOLIO_PRICER_DLL_HPP
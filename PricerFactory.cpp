@@ -4,7 +4,8 @@
  *
  * Ce fichier contient l'implmentation complte de la classe PricerFactory qui fournit
  * une mthode statique pour crer dynamiquement une instance de moteur de pricing en fonction
- * du type spcifi (Black-Scholes, Binomial, Crank-Nicolson, ou Monte Carlo).
+ * du type spcifi (Black-Scholes, Binomial, Crank-Nicolson, ou Monte Carlo), ainsi que le pool
+ * des moteurs prpars de acquirePricer().
  */
 
 #include "pch.h"
@@ -13,8 +14,225 @@
 #include "BinomialPricer.hpp"
 #include "CrankNicolsonPricer.hpp"
 #include "MonteCarloPricer.hpp"
+#include "AdiPricer.hpp"
+#include "JumpDiffusionPricer.hpp"
+#include "CosPricer.hpp"
+#include "CarrMadanPricer.hpp"
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Moteurs prpars d'une configuration.
+ *
+ * Les moteurs partagent la configuration de l'entre ; ceux qui ne sont pas prts attendent dans idle.
+ */
+struct PricerPoolEntry {
+    PricerType type;                                      ///< Type des moteurs.
+    std::shared_ptr<const PricingConfiguration> config;   ///< Configuration partage par les moteurs.
+    std::mutex mutex;                                     ///< Protge idle.
+    std::vector<std::unique_ptr<IOptionPricer>> idle;     ///< Moteurs prpars libres.
+    std::uint64_t lastUse = 0;                            ///< Dernire demande (protg par le verrou du pool).
+};
+
+namespace {
+
+    /// Nombre maximal de configurations gardes par le pool.
+    const size_t kMaxPooledConfigurations = 32;
+
+    /// Nombre maximal de moteurs libres gards par configuration.
+    const size_t kMaxIdlePricers = 64;
+
+    /**
+     * @brief Appelle visit(a.rglage, b.rglage) pour chaque rglage qui change les prix.
+     *
+     * Les nombres de threads (adiThreads, batchThreads) ne changent que la dure des calculs : ils ne
+     * font pas partie de la cl, et un moteur prt garde ceux de la premire configuration de sa cl.
+     */
+    template <typename Visitor>
+    void visitSettings(const PricingConfiguration& a, const PricingConfiguration& b, Visitor& visit) {
+        visit(a.calculationDate, b.calculationDate);
+        visit(a.maturity, b.maturity);
+        visit(a.riskFreeRate, b.riskFreeRate);
+        visit(a.yieldCurve.getInterpolation(), b.yieldCurve.getInterpolation());
+        visit(a.yieldCurve.getData(), b.yieldCurve.getData());
+        visit(a.binomialSteps, b.binomialSteps);
+        visit(a.crankTimeSteps, b.crankTimeSteps);
+        visit(a.crankSpotSteps, b.crankSpotSteps);
+        visit(a.S_max, b.S_max);
+        visit(a.crankHighOrder, b.crankHighOrder);
+        visit(a.adiModel, b.adiModel);
+        visit(a.adiTimeSteps, b.adiTimeSteps);
+        visit(a.adiSpotSteps, b.adiSpotSteps);
+        visit(a.adiFactorSteps, b.adiFactorSteps);
+        visit(a.adiUniformGrid, b.adiUniformGrid);
+        visit(a.hestonKappa, b.hestonKappa);
+        visit(a.hestonTheta, b.hestonTheta);
+        visit(a.hestonXi, b.hestonXi);
+        visit(a.hestonRho, b.hestonRho);
+        visit(a.rateKappa, b.rateKappa);
+        visit(a.rateVolatility, b.rateVolatility);
+        visit(a.rateCorrelation, b.rateCorrelation);
+        visit(a.jumpModel, b.jumpModel);
+        visit(a.jumpIntensity, b.jumpIntensity);
+        visit(a.mertonJumpMean, b.mertonJumpMean);
+        visit(a.mertonJumpVolatility, b.mertonJumpVolatility);
+        visit(a.kouUpProbability, b.kouUpProbability);
+        visit(a.kouUpRate, b.kouUpRate);
+        visit(a.kouDownRate, b.kouDownRate);
+        visit(a.fourierModel, b.fourierModel);
+        visit(a.vgTheta, b.vgTheta);
+        visit(a.vgNu, b.vgNu);
+        visit(a.cosTerms, b.cosTerms);
+        visit(a.cosTruncation, b.cosTruncation);
+        visit(a.carrMadanPoints, b.carrMadanPoints);
+        visit(a.carrMadanSpacing, b.carrMadanSpacing);
+        visit(a.carrMadanDamping, b.carrMadanDamping);
+        visit(a.mcNumPaths, b.mcNumPaths);
+        visit(a.mcTimeStepsPerPath, b.mcTimeStepsPerPath);
+    }
+
+    /**
+     * @brief Hache la reprsentation binaire des rglages, sans allocation.
+     *
+     * Les octets sont mlangs par mots de 64 bits (multiplication de FNV-1a), ce qui suffit pour
+     * rpartir les cls : les rglages des entres de mme cl sont de toute faon compars en entier.
+     */
+    struct SettingHasher {
+        std::uint64_t hash = 14695981039346656037ULL;
+
+        void append(const void* data, size_t length) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (; length >= sizeof(std::uint64_t); length -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t)) {
+                std::uint64_t word;
+                std::memcpy(&word, bytes, sizeof(word));
+                mix(word);
+            }
+            if (length > 0) {
+                std::uint64_t word = 0;
+                std::memcpy(&word, bytes, length);
+                mix(word);
+            }
+        }
+        void mix(std::uint64_t word) {
+            hash = (hash ^ word) * 1099511628211ULL;
+            hash ^= hash >> 32;
+        }
+        template <typename T>
+        void operator()(const T& value, const T&) {
+            static_assert(std::is_trivially_copyable<T>::value, "Setting must be trivially copyable.");
+            append(&value, sizeof(value));
+        }
+        void operator()(const std::string& value, const std::string&) {
+            mix(value.size());
+            append(value.data(), value.size());
+        }
+        void operator()(const std::vector<RatePoint>& value, const std::vector<RatePoint>&) {
+            mix(value.size());
+            append(value.data(), value.size() * sizeof(RatePoint));
+        }
+    };
+
+    /// Compare octet par octet les rglages de deux configurations, comme SettingHasher les hache.
+    struct SettingComparer {
+        bool equal = true;
+
+        template <typename T>
+        void operator()(const T& a, const T& b) {
+            equal = equal && std::memcmp(&a, &b, sizeof(T)) == 0;
+        }
+        void operator()(const std::string& a, const std::string& b) {
+            equal = equal && a == b;
+        }
+        void operator()(const std::vector<RatePoint>& a, const std::vector<RatePoint>& b) {
+            equal = equal && a.size() == b.size()
+                && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(RatePoint)) == 0);
+        }
+    };
+
+    /// Calcule la cl d'un moteur : le hachage de son type et des rglages de sa configuration.
+    std::uint64_t poolKey(PricerType type, const PricingConfiguration& config) {
+        SettingHasher hasher;
+        hasher(type, type);
+        visitSettings(config, config, hasher);
+        return hasher.hash;
+    }
+
+    /// Indique si deux configurations ont les mmes rglages (aux nombres de threads prs).
+    bool sameSettings(const PricingConfiguration& a, const PricingConfiguration& b) {
+        SettingComparer comparer;
+        visitSettings(a, b, comparer);
+        return comparer.equal;
+    }
+
+    /**
+     * @brief Pool des moteurs prpars : une entre par type et par rglages.
+     *
+     * Les entres sont ranges par cl ; deux entres de mme cl (collision) se distinguent en
+     * comparant leurs rglages en entier.
+     */
+    struct PricerPool {
+        std::mutex mutex;
+        std::unordered_multimap<std::uint64_t, std::shared_ptr<PricerPoolEntry>> entries;
+        std::uint64_t uses = 0;
+
+        /// Retourne l'entre de la configuration, en la crant si besoin.
+        std::shared_ptr<PricerPoolEntry> entryFor(PricerType type, const PricingConfiguration& config) {
+            const std::uint64_t key = poolKey(type, config);
+            std::lock_guard<std::mutex> lock(mutex);
+            auto range = entries.equal_range(key);
+            auto found = range.first;
+            while (found != range.second && (found->second->type != type || !sameSettings(*found->second->config, config))) {
+                ++found;
+            }
+            if (found == range.second) {
+                if (entries.size() >= kMaxPooledConfigurations) {
+                    // Oublie la configuration la moins rcemment demande ; ses moteurs prts
+                    // seront dtruits  leur restitution.
+                    auto oldest = entries.begin();
+                    for (auto it = entries.begin(); it != entries.end(); ++it) {
+                        if (it->second->lastUse < oldest->second->lastUse) {
+                            oldest = it;
+                        }
+                    }
+                    entries.erase(oldest);
+                }
+                auto entry = std::make_shared<PricerPoolEntry>();
+                entry->type = type;
+                entry->config = std::make_shared<const PricingConfiguration>(config);
+                found = entries.emplace(key, std::move(entry));
+            }
+            found->second->lastUse = ++uses;
+            return found->second;
+        }
+    };
+
+    PricerPool& pricerPool() {
+        static PricerPool pool;
+        return pool;
+    }
+
+    bool isKnownType(PricerType type) {
+        return type >= PricerType::BlackScholes && type <= PricerType::CarrMadan;
+    }
+
+} // namespace
+
+void PricerRecycler::operator()(IOptionPricer* pricer) const {
+    std::unique_ptr<IOptionPricer> owned(pricer);
+    if (entry_) {
+        std::lock_guard<std::mutex> lock(entry_->mutex);
+        if (entry_->idle.size() < kMaxIdlePricers) {
+            entry_->idle.push_back(std::move(owned));
+        }
+    }
+}
 
  /**
   * @brief Cre un moteur de pricing selon le type spcifi.
@@ -22,7 +240,7 @@
   * En fonction de l'numration passe en paramtre, cette mthode retourne un pointeur
   * unique vers une instance concrte d'IOptionPricer.
   *
-  * @param type Le type de pricer  crer (BlackScholes, Binomial, CrankNicolson, MonteCarlo).
+  * @param type Le type de pricer  crer (BlackScholes, Binomial, CrankNicolson, MonteCarlo, Adi, JumpDiffusion, Cos, CarrMadan).
   * @return Un std::unique_ptr<IOptionPricer> pointant vers l'instance cre.
   * @throw std::invalid_argument Si le type de pricer n'est pas reconnu.
   */
@@ -36,6 +254,14 @@ std::unique_ptr<IOptionPricer> PricerFactory::createPricer(PricerType type) {
         return std::make_unique<CrankNicolsonPricer>();
     case PricerType::MonteCarlo:
         return std::make_unique<MonteCarloPricer>();
+    case PricerType::Adi:
+        return std::make_unique<AdiPricer>();
+    case PricerType::JumpDiffusion:
+        return std::make_unique<JumpDiffusionPricer>();
+    case PricerType::Cos:
+        return std::make_unique<CosPricer>();
+    case PricerType::CarrMadan:
+        return std::make_unique<CarrMadanPricer>();
     default:
         throw std::invalid_argument("Type de pricer inconnu.");
     }
@@ -51,8 +277,72 @@ std::unique_ptr<IOptionPricer> PricerFactory::createPricer(PricerType type, cons
         return std::make_unique<CrankNicolsonPricer>(config);
     case PricerType::MonteCarlo:
         return std::make_unique<MonteCarloPricer>(config);
+    case PricerType::Adi:
+        return std::make_unique<AdiPricer>(config);
+    case PricerType::JumpDiffusion:
+        return std::make_unique<JumpDiffusionPricer>(config);
+    case PricerType::Cos:
+        return std::make_unique<CosPricer>(config);
+    case PricerType::CarrMadan:
+        return std::make_unique<CarrMadanPricer>(config);
+    default:
+        throw std::invalid_argument("Unknown pricer type.");
+    }
+}
+
+std::unique_ptr<IOptionPricer> PricerFactory::createPricer(PricerType type, std::shared_ptr<const PricingConfiguration> config,
+    const PricingBump& bump) {
+    switch (type) {
+    case PricerType::BlackScholes:
+        return std::make_unique<BlackScholesPricer>(std::move(config), bump);
+    case PricerType::Binomial:
+        return std::make_unique<BinomialPricer>(std::move(config), bump);
+    case PricerType::CrankNicolson:
+        return std::make_unique<CrankNicolsonPricer>(std::move(config), bump);
+    case PricerType::MonteCarlo:
+        return std::make_unique<MonteCarloPricer>(std::move(config), bump);
+    case PricerType::Adi:
+        return std::make_unique<AdiPricer>(std::move(config), bump);
+    case PricerType::JumpDiffusion:
+        return std::make_unique<JumpDiffusionPricer>(std::move(config), bump);
+    case PricerType::Cos:
+        return std::make_unique<CosPricer>(std::move(config), bump);
+    case PricerType::CarrMadan:
+        return std::make_unique<CarrMadanPricer>(std::move(config), bump);
     default:
         throw std::invalid_argument("Unknown pricer type.");
     }
 }
 
+/**
+ * @brief Prte un moteur prpar pour le type et la configuration donns.
+ *
+ * Un moteur libre de l'entre est repris s'il y en a un ; sinon un moteur est cr sur la
+ * configuration partage de l'entre et prpar, hors des verrous.
+ */
+PooledPricer PricerFactory::acquirePricer(PricerType type, const PricingConfiguration& config) {
+    if (!isKnownType(type)) {
+        throw std::invalid_argument("Unknown pricer type.");
+    }
+    std::shared_ptr<PricerPoolEntry> entry = pricerPool().entryFor(type, config);
+    std::unique_ptr<IOptionPricer> pricer;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (!entry->idle.empty()) {
+            pricer = std::move(entry->idle.back());
+            entry->idle.pop_back();
+        }
+    }
+    if (!pricer) {
+        pricer = createPricer(type, entry->config);
+        pricer->prepare();
+    }
+    return PooledPricer(pricer.release(), PricerRecycler(std::move(entry)));
+}
+
+void PricerFactory::clearPricerPool() {
+    PricerPool& pool = pricerPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.entries.clear();
+}
+
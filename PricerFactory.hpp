@@ -4,6 +4,10 @@
 /**
  * @file PricerFactory.hpp
  * @brief Dclaration de la factory pour crer des moteurs de pricing.
+ *
+ * En plus de la cration d'un moteur  chaque appel, la factory met en commun des moteurs prpars
+ * (voir PricerFactory::acquirePricer()) : les appels rpts avec les mmes rglages, qui sont la
+ * rgle depuis le classeur, reprennent un moteur dj prt au lieu d'en construire un.
  */
 
 #include "pch.h"
@@ -19,9 +23,47 @@ enum class PricerType {
     BlackScholes, /**< Pricer utilisant la formule de Black-Scholes. */
     Binomial,     /**< Pricer bas sur la mthode binomiale. */
     CrankNicolson,/**< Pricer utilisant la mthode des diffrences finies de Crank-Nicolson. */
-    MonteCarlo    /**< Pricer bas sur la simulation par Monte Carlo. */
+    MonteCarlo,   /**< Pricer bas sur la simulation par Monte Carlo. */
+    Adi,          /**< Pricer utilisant le schma ADI sur une EDP  deux facteurs (Heston ou taux stochastique). */
+    JumpDiffusion,/**< Pricer rsolvant l'EDPI des modles  sauts de Merton ou de Kou. */
+    Cos,          /**< Pricer utilisant la mthode COS (Fourier) pour les options europennes. */
+    CarrMadan     /**< Pricer utilisant la mthode FFT de Carr-Madan pour les options europennes. */
+};
+
+/// Moteurs prpars d'une configuration, mis en commun par PricerFactory::acquirePricer() (dfini dans PricerFactory.cpp).
+struct PricerPoolEntry;
+
+/**
+ * @brief Suppresseur des moteurs obtenus par PricerFactory::acquirePricer() : il rend le moteur
+ *         l'entre du pool dont il provient, au lieu de le dtruire.
+ *
+ * Un suppresseur construit par dfaut dtruit le moteur.
+ */
+class PricerRecycler {
+public:
+    PricerRecycler() = default;
+
+    /**
+     * @brief Construit un suppresseur qui rend les moteurs  une entre du pool.
+     * @param entry L'entre du pool (un moteur est dtruit si elle est nulle).
+     */
+    explicit PricerRecycler(std::shared_ptr<PricerPoolEntry> entry) : entry_(std::move(entry)) {}
+
+    /**
+     * @brief Rend le moteur au pool, ou le dtruit si l'entre garde dj assez de moteurs libres.
+     * @param pricer Le moteur  rendre.
+     */
+    void operator()(IOptionPricer* pricer) const;
+
+private:
+    std::shared_ptr<PricerPoolEntry> entry_; ///< Entre d'origine du moteur (garde en vie tant que le moteur est utilis).
 };
 
+/**
+ * @brief Moteur prt par PricerFactory::acquirePricer(), rendu au pool  sa destruction.
+ */
+typedef std::unique_ptr<IOptionPricer, PricerRecycler> PooledPricer;
+
 /**
  * @brief Factory pour crer des instances de moteurs de pricing.
  *
@@ -43,13 +85,60 @@ public:
     * (such as maturity, risk-free rate, discretization settings, etc.) via a
     * PricingConfiguration object.
     *
-    * @param type The type of pricer to create (BlackScholes, Binomial, CrankNicolson, MonteCarlo).
+    * @param type The type of pricer to create (BlackScholes, Binomial, CrankNicolson, MonteCarlo, Adi, JumpDiffusion, Cos, CarrMadan).
     * @param config A PricingConfiguration object containing additional parameters.
     * @return A std::unique_ptr<IOptionPricer> pointing to the created instance.
     * @throw std::invalid_argument if the pricer type is unknown.
     */
     static std::unique_ptr<IOptionPricer> createPricer(PricerType type, const PricingConfiguration& config);
 
+    /**
+     * @brief Cre un moteur de pricing qui partage une configuration, sans la copier.
+     *
+     * La cration ne cote qu'une copie du pointeur partag : un moteur par taux peut tre cr
+     * sur une mme configuration en donnant l'cart de taux dans bump.
+     *
+     * @param type Le type de pricer  crer.
+     * @param config La configuration partage (non nulle).
+     * @param bump Le dcalage ajout au taux sans risque et  la courbe des taux.
+     * @return Un pointeur unique vers une instance de IOptionPricer.
+     * @throw std::invalid_argument Si le type de pricer n'est pas reconnu.
+     */
+    static std::unique_ptr<IOptionPricer> createPricer(PricerType type, std::shared_ptr<const PricingConfiguration> config,
+        const PricingBump& bump = PricingBump());
+
+    /**
+     * @brief Prte un moteur prpar pour le type et la configuration donns.
+     *
+     * Les moteurs sont mis en commun par type et par configuration, avec pour cl le hachage de tous
+     * les rglages (date de calcul, maturit, taux, points et interpolation de la courbe, paramtres
+     * des modles et des discrtisations) sauf les nombres de threads (adiThreads, batchThreads), qui
+     * ne changent pas les prix : un moteur prt garde ceux de la premire configuration de sa cl.
+     * Le hachage est calcul hors du verrou du pool. Pour une cl dj vue, le moteur est repris
+     * parmi les moteurs libres, sans copie de la configuration ni prparation ; sinon il est cr sur
+     * la configuration partage de la cl, puis prpar (IOptionPricer::prepare(), qui ne prcalcule
+     * des tables que pour le moteur de Monte Carlo). Le moteur est rendu au pool  la destruction du
+     * PooledPricer. Les rsultats sont ceux de createPricer(type, config).
+     *
+     * Chaque moteur prt n'est utilis que par son dtenteur. Pour que les appels de maturits
+     * diffrentes partagent une cl, la maturit se donne sur l'option (Option::setMaturity()) plutt
+     * que dans la configuration. Le pool garde au plus 32 configurations (les moins rcemment
+     * demandes sont oublies) et 64 moteurs libres par configuration. Cette mthode peut tre
+     * appele depuis plusieurs threads.
+     *
+     * @param type Le type de pricer  prter.
+     * @param config La configuration du moteur.
+     * @return Le moteur prt.
+     * @throw std::invalid_argument Si le type de pricer n'est pas reconnu.
+     */
+    static PooledPricer acquirePricer(PricerType type, const PricingConfiguration& config);
+
+    /**
+     * @brief Vide le pool des moteurs prpars.
+     *
+     * Les moteurs prts restent valides ; ils sont dtruits, au lieu d'tre rendus,  leur restitution.
+     */
+    static void clearPricerPool();
 };
 
 #endif // PRICERFACTORY_HPP
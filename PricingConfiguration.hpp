@@ -11,8 +11,37 @@
  */
 
 #include "pch.h"
+#include <memory>
 #include <string>
 #include "YieldCurve.hpp"  // Include the yield curve header
+#include "Option.hpp"
+#include "DateConverter.hpp"
+
+/**
+ * @brief Second factor of the two-dimensional ADI model.
+ */
+enum class TwoFactorModel {
+    Heston,        ///< Spot x variance (Heston stochastic volatility).
+    StochasticRate ///< Spot x short rate (mean-reverting Hull-White/Vasicek short rate).
+};
+
+/**
+ * @brief Jump size distribution of the jump-diffusion models.
+ */
+enum class JumpModel {
+    Merton, ///< Normally distributed log-jumps.
+    Kou     ///< Asymmetric double-exponential log-jumps.
+};
+
+/**
+ * @brief Model whose characteristic function is used by the Fourier engines.
+ */
+enum class FourierModel {
+    BlackScholes,  ///< Geometric Brownian motion.
+    Heston,        ///< Heston stochastic volatility (Heston parameters of the ADI section).
+    JumpDiffusion, ///< Merton or Kou jump-diffusion (jump-diffusion parameters).
+    VarianceGamma  ///< Variance-Gamma pure-jump process.
+};
 
  /**
   * @brief Structure holding pricing configuration parameters.
@@ -32,6 +61,8 @@ struct PricingConfiguration {
 
     // Yield curve for variable interest rates.
     // If loaded with data, it is used to interpolate the risk-free rate; otherwise, riskFreeRate is used.
+    // The curve is a handle to shared immutable points (see YieldCurveRegistry for named curves),
+    // so copying the configuration does not copy the curve data.
     YieldCurve yieldCurve;
 
     // Black-Scholes parameters:
@@ -49,6 +80,66 @@ struct PricingConfiguration {
     // Upper limit for the underlying asset price (S_max).
     // If set to 0.0, it can be computed from the underlying or strike.
     double S_max;
+    // Use the fourth-order compact (HOC) scheme on a log-spot grid instead of the
+    // second-order scheme on a uniform spot grid.
+    bool crankHighOrder;
+
+    // ADI (two-factor PDE) model parameters:
+    // Second factor of the model (variance or short rate).
+    TwoFactorModel adiModel;
+    // Number of time steps.
+    int adiTimeSteps;
+    // Number of spatial steps along the spot axis.
+    int adiSpotSteps;
+    // Number of spatial steps along the second axis (variance or short rate).
+    int adiFactorSteps;
+    // Use uniform grids along both axes instead of the grids clustered around the strike (spot) and
+    // around v = 0 (Heston variance).
+    bool adiUniformGrid;
+    // Number of threads used for the line solves (0 = hardware concurrency).
+    int adiThreads;
+    // Heston parameters. The initial variance is the square of the option volatility.
+    double hestonKappa; ///< Mean-reversion speed of the variance.
+    double hestonTheta; ///< Long-term variance.
+    double hestonXi;    ///< Volatility of the variance.
+    double hestonRho;   ///< Correlation between spot and variance.
+    // Short-rate parameters. The short rate starts at, and reverts to, riskFreeRate.
+    double rateKappa;       ///< Mean-reversion speed of the short rate.
+    double rateVolatility;  ///< Volatility of the short rate.
+    double rateCorrelation; ///< Correlation between spot and short rate.
+
+    // Jump-diffusion model parameters (the PIDE engine uses the Crank-Nicolson grid settings):
+    // Jump size distribution.
+    JumpModel jumpModel;
+    // Jump intensity (expected number of jumps per year).
+    double jumpIntensity;
+    // Merton parameters: mean and standard deviation of the log-jump size.
+    double mertonJumpMean;
+    double mertonJumpVolatility;
+    // Kou parameters: probability of an upward jump and rates of the upward (> 1) and downward
+    // exponential log-jump sizes.
+    double kouUpProbability;
+    double kouUpRate;
+    double kouDownRate;
+
+    // Fourier (COS and Carr-Madan) model parameters. The option volatility is the diffusion volatility (Heston:
+    // square root of the initial variance) and riskFreeRate is used as a constant rate.
+    // Model of the characteristic function.
+    FourierModel fourierModel;
+    // Variance-Gamma parameters: drift of the subordinated Brownian motion and variance rate
+    // of the Gamma time change.
+    double vgTheta;
+    double vgNu;
+    // Number of terms of the cosine expansion.
+    int cosTerms;
+    // Width parameter L of the truncation range c1 +/- L sqrt(c2 + sqrt(c4)), where c_n are the
+    // cumulants of the log-return.
+    double cosTruncation;
+    // Carr-Madan parameters: number of FFT points (any size; powers of two are fastest),
+    // spacing of the integration grid and damping exponent of the call price.
+    int carrMadanPoints;
+    double carrMadanSpacing;
+    double carrMadanDamping;
 
     // Monte Carlo model parameters:
     // Number of simulation paths.
@@ -56,6 +147,10 @@ struct PricingConfiguration {
     // Number of time steps per simulation path.
     int mcTimeStepsPerPath;
 
+    // Batch pricing (priceBatch and computeGreeksBatch of the Binomial, Crank-Nicolson and Monte Carlo engines):
+    // Number of threads sharing the options of a batch (0 = hardware concurrency, 1 = calling thread only).
+    int batchThreads;
+
     /**
      * @brief Default constructor with default parameter values.
      *
@@ -71,9 +166,75 @@ struct PricingConfiguration {
         crankTimeSteps(100),
         crankSpotSteps(100),
         S_max(0.0), // 0.0 indicates S_max should be computed if needed
+        crankHighOrder(false),
+        adiModel(TwoFactorModel::Heston),
+        adiTimeSteps(100),
+        adiSpotSteps(100),
+        adiFactorSteps(50),
+        adiUniformGrid(false),
+        adiThreads(0),
+        hestonKappa(1.5),
+        hestonTheta(0.04),
+        hestonXi(0.3),
+        hestonRho(-0.7),
+        rateKappa(0.1),
+        rateVolatility(0.01),
+        rateCorrelation(0.0),
+        jumpModel(JumpModel::Merton),
+        jumpIntensity(0.1),
+        mertonJumpMean(-0.1),
+        mertonJumpVolatility(0.15),
+        kouUpProbability(0.3),
+        kouUpRate(25.0),
+        kouDownRate(10.0),
+        fourierModel(FourierModel::BlackScholes),
+        vgTheta(-0.14),
+        vgNu(0.2),
+        cosTerms(256),
+        cosTruncation(10.0),
+        carrMadanPoints(4096),
+        carrMadanSpacing(0.25),
+        carrMadanDamping(1.5),
         mcNumPaths(10000),
-        mcTimeStepsPerPath(100)
+        mcTimeStepsPerPath(100),
+        batchThreads(0)
     {}
+
+    /**
+     * @brief Returns the maturity at which an option is priced, in years from the calculation date.
+     *
+     * This is the option's own maturity if it has one, the time from the calculation date (today if
+     * empty) to its expiry date if it has one, and the maturity of this configuration otherwise. The
+     * engines then subtract the time elapsed since the calculation date, as they do for the
+     * configuration's maturity, so an expiry date always resolves to the time from today to expiry.
+     */
+    double maturityOf(const Option& opt) const {
+        if (opt.hasMaturity()) {
+            return opt.getMaturity();
+        }
+        if (opt.hasExpiryDate()) {
+            auto start = calculationDate.empty() ? std::chrono::system_clock::now()
+                : DateConverter::parseDate(calculationDate);
+            return DateConverter::yearsBetween(start, opt.getExpiryDate());
+        }
+        return maturity;
+    }
+};
+
+/**
+ * @brief Overlay applied by a pricer on top of its configuration, for bumped pricings.
+ *
+ * A pricer holds its configuration through a std::shared_ptr<const PricingConfiguration>, so that the
+ * pricers of the finite-difference bumps share the configuration of the base pricer (calculation date,
+ * yield curve and numerical settings) and only differ by this overlay: building them copies no string
+ * and no curve, and allocates no memory. Time bumps need no overlay, as they shift the maturity of the
+ * option (see Option::setMaturity()).
+ */
+struct PricingBump {
+    double rateShift; ///< Parallel shift added to riskFreeRate and to every rate read on the yield curve.
+
+    PricingBump() : rateShift(0.0) {}
+    explicit PricingBump(double rateShift) : rateShift(rateShift) {}
 };
 
 #endif // PRICINGCONFIGURATION_HPP
@@ -0,0 +1,374 @@
+/**
+ * @file PricingServer.cpp
+ * @brief Implementation of the PricingServer and PricingClient classes.
+ */
+
+#include "pch.h"
+#include "PricingServer.hpp"
+#include "AsyncPricingService.hpp"
+#include "YieldCurveCache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <stdexcept>
+
+#pragma comment(lib, "Ws2_32.lib")
+
+static_assert(sizeof(PricingWireRequest) == 128, "Unexpected pricing request size.");
+static_assert(sizeof(PricingWireResponse) == 64, "Unexpected pricing response size.");
+
+namespace {
+
+    bool sendAll(SOCKET socket, const void* data, size_t length) {
+        const char* bytes = static_cast<const char*>(data);
+        while (length > 0) {
+            int sent = ::send(socket, bytes, static_cast<int>(length), 0);
+            if (sent <= 0) {
+                return false;
+            }
+            bytes += sent;
+            length -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool receiveAll(SOCKET socket, void* data, size_t length) {
+        char* bytes = static_cast<char*>(data);
+        while (length > 0) {
+            int received = ::recv(socket, bytes, static_cast<int>(length), 0);
+            if (received <= 0) {
+                return false;
+            }
+            bytes += received;
+            length -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    /// Disables Nagle's algorithm: the records are small and latency matters more than throughput.
+    void setNoDelay(SOCKET socket) {
+        BOOL enable = TRUE;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enable), sizeof(enable));
+    }
+
+    /// Tells whether two requests can be priced by one batch call: same engine, settings and Greeks flag.
+    bool sameGroup(const PricingWireRequest& a, const PricingWireRequest& b) {
+        return a.pricerType == b.pricerType && a.computeGreeks == b.computeGreeks && a.r == b.r
+            && a.binomialSteps == b.binomialSteps && a.crankTimeSteps == b.crankTimeSteps
+            && a.crankSpotSteps == b.crankSpotSteps && a.S_max == b.S_max
+            && a.mcNumPaths == b.mcNumPaths && a.mcTimeStepsPerPath == b.mcTimeStepsPerPath
+            && std::strncmp(a.calculationDate, b.calculationDate, sizeof(a.calculationDate)) == 0;
+    }
+
+    PricingWireResponse errorResponse(std::uint32_t requestId) {
+        PricingWireResponse response;
+        std::memset(&response, 0, sizeof(response));
+        response.magic = kPricingWireMagic;
+        response.requestId = requestId;
+        response.status = -1;
+        response.price = -1.0;
+        response.delta = response.gamma = response.vega = response.theta = response.rho = NAN;
+        return response;
+    }
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// PricingServer
+// ---------------------------------------------------------------------------
+
+PricingServer::PricingServer(std::chrono::microseconds batchWindow, size_t maxBatch)
+    : batchWindow_(batchWindow),
+    maxBatch_(std::max<size_t>(1, maxBatch)),
+    listener_(INVALID_SOCKET),
+    running_(false),
+    batches_(0)
+{
+}
+
+PricingServer::~PricingServer() {
+    stop();
+}
+
+unsigned short PricingServer::start(unsigned short port) {
+    if (running_) {
+        throw std::runtime_error("The pricing server is already running.");
+    }
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        throw std::runtime_error("Cannot initialize Winsock.");
+    }
+
+    listener_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    int length = sizeof(address);
+    if (listener_ == INVALID_SOCKET
+        || bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listener_, SOMAXCONN) != 0
+        || getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        if (listener_ != INVALID_SOCKET) {
+            closesocket(listener_);
+            listener_ = INVALID_SOCKET;
+        }
+        WSACleanup();
+        throw std::runtime_error("Cannot listen on port " + std::to_string(port));
+    }
+
+    running_ = true;
+    acceptor_ = std::thread(&PricingServer::acceptLoop, this);
+    batcher_ = std::thread(&PricingServer::batchLoop, this);
+    return ntohs(address.sin_port);
+}
+
+void PricingServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    closesocket(listener_);
+    listener_ = INVALID_SOCKET;
+    acceptor_.join();
+
+    std::vector<std::thread> readers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& connection : connections_) {
+            std::lock_guard<std::mutex> writeLock(connection->writeMutex);
+            if (!connection->closed) {
+                shutdown(connection->socket, SD_BOTH);
+            }
+        }
+        readers.swap(readers_);
+        finishedReaders_.clear();
+        pending_.clear();
+    }
+    arrived_.notify_all();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    batcher_.join();
+    WSACleanup();
+}
+
+bool PricingServer::running() const {
+    return running_;
+}
+
+unsigned long long PricingServer::batchCount() const {
+    return batches_;
+}
+
+void PricingServer::acceptLoop() {
+    while (running_) {
+        SOCKET socket = accept(listener_, nullptr, nullptr);
+        if (socket == INVALID_SOCKET) {
+            continue; // The listener is closed by stop().
+        }
+        setNoDelay(socket);
+        auto connection = std::make_shared<Connection>();
+        connection->socket = socket;
+        connection->closed = false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Join the readers of the connections closed since the last accept.
+        for (std::thread::id id : finishedReaders_) {
+            auto reader = std::find_if(readers_.begin(), readers_.end(), [&](const std::thread& t) { return t.get_id() == id; });
+            if (reader != readers_.end()) {
+                reader->join();
+                readers_.erase(reader);
+            }
+        }
+        finishedReaders_.clear();
+        connections_.push_back(connection);
+        readers_.emplace_back(&PricingServer::readLoop, this, connection);
+    }
+}
+
+void PricingServer::readLoop(std::shared_ptr<Connection> connection) {
+    PricingWireRequest request;
+    while (running_ && receiveAll(connection->socket, &request, sizeof(request))) {
+        if (request.magic != kPricingWireMagic) {
+            break; // Not our protocol: drop the connection.
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(Pending{ connection, request });
+        }
+        arrived_.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> writeLock(connection->writeMutex);
+        connection->closed = true;
+        closesocket(connection->socket);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), connection), connections_.end());
+    finishedReaders_.push_back(std::this_thread::get_id());
+}
+
+void PricingServer::batchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        arrived_.wait(lock, [&] { return !running_ || !pending_.empty(); });
+        if (!running_) {
+            return;
+        }
+        // Gather the requests arriving within the window after the first one.
+        auto deadline = std::chrono::steady_clock::now() + batchWindow_;
+        arrived_.wait_until(lock, deadline, [&] { return !running_ || pending_.size() >= maxBatch_; });
+        if (!running_) {
+            return;
+        }
+        std::vector<Pending> batch;
+        batch.swap(pending_);
+        lock.unlock();
+        dispatch(batch);
+        lock.lock();
+    }
+}
+
+void PricingServer::dispatch(std::vector<Pending>& batch) {
+    // Shared by the whole batch: today's date and the curve snapshot.
+    const std::string today = DateConverter::getTodayDate();
+    std::shared_ptr<const YieldCurve> curve;
+
+    // The requests with the same engine, settings and Greeks flag are priced by one batch call.
+    // Each group is submitted on its own, so that its responses do not wait for slower groups.
+    struct Group {
+        PricingWireRequest key;                       ///< First request of the group.
+        PricingBatchRequest request;
+        std::shared_ptr<std::vector<Pending>> members; ///< In the order of request.options.
+    };
+    std::vector<Group> groups;
+    for (Pending& pending : batch) {
+        const PricingWireRequest& wire = pending.request;
+        try {
+            if (wire.pricerType < static_cast<int>(PricerType::BlackScholes) || wire.pricerType > static_cast<int>(PricerType::CarrMadan)) {
+                throw std::invalid_argument("Unknown pricer type.");
+            }
+            // The maturity is set on the option, so that the requests with the same settings share an engine.
+            Option option(wire.S, wire.K, wire.sigma, wire.q,
+                (wire.optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
+                (wire.optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+            option.setMaturity(wire.T);
+
+            auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) { return sameGroup(g.key, wire); });
+            if (group == groups.end()) {
+                PricerType type = static_cast<PricerType>(wire.pricerType);
+                PricingBatchRequest request;
+                request.type = type;
+                request.computeGreeks = (wire.computeGreeks != 0);
+                PricingConfiguration& config = request.config;
+                const char* dateEnd = std::find(wire.calculationDate, wire.calculationDate + sizeof(wire.calculationDate), '\0');
+                config.calculationDate = (dateEnd == wire.calculationDate) ? today : std::string(wire.calculationDate, dateEnd);
+                config.riskFreeRate = wire.r;
+                // The Black-Scholes functions use the constant rate r, not the curve.
+                if (type != PricerType::BlackScholes) {
+                    if (!curve) {
+                        curve = YieldCurveCache::defaultCurve();
+                    }
+                    config.yieldCurve = *curve;
+                }
+                config.binomialSteps = wire.binomialSteps;
+                config.crankTimeSteps = wire.crankTimeSteps;
+                config.crankSpotSteps = wire.crankSpotSteps;
+                config.S_max = wire.S_max;
+                config.mcNumPaths = wire.mcNumPaths;
+                config.mcTimeStepsPerPath = wire.mcTimeStepsPerPath;
+                groups.push_back(Group{ wire, std::move(request), std::make_shared<std::vector<Pending>>() });
+                group = groups.end() - 1;
+            }
+            group->request.options.add(option);
+            group->members->push_back(std::move(pending));
+        }
+        catch (const std::exception&) {
+            send(*pending.connection, errorResponse(wire.requestId));
+        }
+    }
+    if (groups.empty()) {
+        return;
+    }
+
+    ++batches_;
+    for (Group& group : groups) {
+        std::shared_ptr<std::vector<Pending>> members = group.members;
+        AsyncPricingService::instance().submit(std::move(group.request),
+            [members](AsyncPricingService::Ticket ticket, const std::vector<PricingResult>& results) {
+                for (size_t i = 0; i < results.size(); ++i) {
+                    const Pending& pending = (*members)[i];
+                    PricingWireResponse response = errorResponse(pending.request.requestId);
+                    if (results[i].ok) {
+                        response.status = 0;
+                        response.price = results[i].price;
+                        response.delta = results[i].greeks.delta;
+                        response.gamma = results[i].greeks.gamma;
+                        response.vega = results[i].greeks.vega;
+                        response.theta = results[i].greeks.theta;
+                        response.rho = results[i].greeks.rho;
+                    }
+                    send(*pending.connection, response);
+                }
+                AsyncPricingService::instance().release(ticket);
+            });
+    }
+}
+
+void PricingServer::send(Connection& connection, const PricingWireResponse& response) {
+    std::lock_guard<std::mutex> lock(connection.writeMutex);
+    if (!connection.closed) {
+        sendAll(connection.socket, &response, sizeof(response));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// PricingClient
+// ---------------------------------------------------------------------------
+
+PricingClient::PricingClient(unsigned short port)
+    : socket_(INVALID_SOCKET),
+    nextId_(1)
+{
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        throw std::runtime_error("Cannot initialize Winsock.");
+    }
+    socket_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (socket_ == INVALID_SOCKET || connect(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (socket_ != INVALID_SOCKET) {
+            closesocket(socket_);
+        }
+        WSACleanup();
+        throw std::runtime_error("Cannot connect to the pricing server on port " + std::to_string(port));
+    }
+    setNoDelay(socket_);
+}
+
+PricingClient::~PricingClient() {
+    closesocket(socket_);
+    WSACleanup();
+}
+
+PricingWireResponse PricingClient::call(PricingWireRequest request) {
+    request.magic = kPricingWireMagic;
+    request.requestId = nextId_++;
+    if (!sendAll(socket_, &request, sizeof(request))) {
+        throw std::runtime_error("Cannot send the pricing request.");
+    }
+    PricingWireResponse response;
+    do {
+        if (!receiveAll(socket_, &response, sizeof(response)) || response.magic != kPricingWireMagic) {
+            throw std::runtime_error("Cannot receive the pricing response.");
+        }
+    } while (response.requestId != request.requestId);
+    return response;
+}
@@ -0,0 +1,178 @@
+#ifndef PRICINGSERVER_HPP
+#define PRICINGSERVER_HPP
+
+/**
+ * @file PricingServer.hpp
+ * @brief Declaration of the PricingServer and PricingClient classes and of their binary protocol.
+ *
+ * The server listens on a localhost TCP port, so that several client processes share one warm
+ * process: its curve snapshot, its engines and its thread pool. Requests and responses are
+ * fixed-size little-endian records. The requests received within a short window (a few tens of
+ * microseconds) from all the connections are grouped by engine, settings and Greeks flag, and
+ * each group is priced by the AsyncPricingService with one batch call (IOptionPricer::priceBatch()).
+ * The responses of a group are sent back on the connections of their requests as soon as the group
+ * is done, without waiting for the other groups of the window.
+ *
+ * A connection may pipeline several requests; responses of different groups can arrive out of
+ * order and are matched with their requests by requestId.
+ */
+
+#include "pch.h"
+#include <winsock2.h>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Magic number of the protocol records ("MOPR").
+const std::uint32_t kPricingWireMagic = 0x52504F4D;
+
+/**
+ * @brief Pricing request record (128 bytes).
+ */
+struct PricingWireRequest {
+    std::uint32_t magic;          ///< kPricingWireMagic.
+    std::uint32_t requestId;      ///< Chosen by the client, copied into the response.
+    std::int32_t pricerType;      ///< PricerType (0 = Black-Scholes, 1 = Binomial, 2 = Crank-Nicolson, 3 = Monte Carlo, ...).
+    std::int32_t optionType;      ///< 0 = Call, 1 = Put.
+    std::int32_t optionStyle;     ///< 0 = European, 1 = American.
+    std::int32_t computeGreeks;   ///< 0 = price only, 1 = price and Greeks.
+    double S, K, T, r, sigma, q;  ///< Option and market parameters, as in the DLL functions.
+    std::int32_t binomialSteps;
+    std::int32_t crankTimeSteps;
+    std::int32_t crankSpotSteps;
+    std::int32_t mcNumPaths;
+    std::int32_t mcTimeStepsPerPath;
+    std::int32_t reserved;        ///< Zero.
+    double S_max;
+    char calculationDate[24];     ///< "YYYY-MM-DD", null-terminated; empty for today.
+};
+
+/**
+ * @brief Pricing response record (64 bytes).
+ */
+struct PricingWireResponse {
+    std::uint32_t magic;          ///< kPricingWireMagic.
+    std::uint32_t requestId;      ///< Identifier of the request.
+    std::int32_t status;          ///< 0 on success, -1 on error.
+    std::int32_t reserved;        ///< Zero.
+    double price;                 ///< Price (-1 on error).
+    double delta, gamma, vega, theta, rho; ///< Greeks (NAN on error or if not requested).
+};
+
+/**
+ * @brief Localhost TCP pricing server with request coalescing.
+ */
+class PricingServer {
+public:
+    /**
+     * @brief Creates a stopped server.
+     * @param batchWindow Time during which requests are gathered after the first one of a batch.
+     * @param maxBatch Number of requests that closes a batch before the end of the window.
+     */
+    explicit PricingServer(std::chrono::microseconds batchWindow = std::chrono::microseconds(50), size_t maxBatch = 1024);
+
+    PricingServer(const PricingServer&) = delete;
+    PricingServer& operator=(const PricingServer&) = delete;
+
+    /**
+     * @brief Stops the server.
+     */
+    ~PricingServer();
+
+    /**
+     * @brief Starts listening on 127.0.0.1.
+     * @param port The port (0 = any free port).
+     * @return The port listened on.
+     * @throw std::runtime_error if the server is running or the socket cannot be opened.
+     */
+    unsigned short start(unsigned short port);
+
+    /**
+     * @brief Closes the listening socket and the connections and waits for the threads.
+     *        Batches being priced complete, but their responses are no longer sent.
+     */
+    void stop();
+
+    /**
+     * @brief Returns true between start() and stop().
+     */
+    bool running() const;
+
+    /**
+     * @brief Returns the number of request windows dispatched so far (for monitoring the coalescing).
+     */
+    unsigned long long batchCount() const;
+
+private:
+    /**
+     * @brief A client connection. Responses may be sent by several workers.
+     */
+    struct Connection {
+        SOCKET socket;
+        bool closed;              ///< Set (under writeMutex) when the socket is closed.
+        std::mutex writeMutex;
+    };
+
+    /**
+     * @brief A request waiting for its batch.
+     */
+    struct Pending {
+        std::shared_ptr<Connection> connection;
+        PricingWireRequest request;
+    };
+
+    void acceptLoop();
+    void readLoop(std::shared_ptr<Connection> connection);
+    void batchLoop();
+    void dispatch(std::vector<Pending>& batch);
+    static void send(Connection& connection, const PricingWireResponse& response);
+
+    std::chrono::microseconds batchWindow_;
+    size_t maxBatch_;
+    SOCKET listener_;
+    std::atomic<bool> running_;
+    std::atomic<unsigned long long> batches_;
+
+    std::mutex mutex_;                     ///< Protects pending_, connections_, readers_ and finishedReaders_.
+    std::condition_variable arrived_;      ///< Signals new requests or stopping.
+    std::vector<Pending> pending_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+    std::vector<std::thread> readers_;
+    std::vector<std::thread::id> finishedReaders_; ///< Readers whose connection is closed, joined by the acceptor.
+    std::thread acceptor_;
+    std::thread batcher_;
+};
+
+/**
+ * @brief Blocking client of a PricingServer, for one thread at a time.
+ */
+class PricingClient {
+public:
+    /**
+     * @brief Connects to a server on 127.0.0.1.
+     * @throw std::runtime_error if the connection fails.
+     */
+    explicit PricingClient(unsigned short port);
+
+    PricingClient(const PricingClient&) = delete;
+    PricingClient& operator=(const PricingClient&) = delete;
+
+    ~PricingClient();
+
+    /**
+     * @brief Sends a request and waits for its response.
+     * @throw std::runtime_error if the connection fails.
+     */
+    PricingWireResponse call(PricingWireRequest request);
+
+private:
+    SOCKET socket_;
+    std::uint32_t nextId_;
+};
+
+#endif // PRICINGSERVER_HPP
@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "PricingServerDLL.hpp"
+#include "PricingServer.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+struct PricingServerConnection {
+    std::unique_ptr<PricingClient> client;
+};
+
+namespace {
+
+    std::mutex serverMutex;                  // Protects server.
+    std::condition_variable serverStopped;   // Signals PricingServerMain that the server is stopped.
+    // Deleted only by StopPricingServer: stopping joins threads, which cannot be done while the DLL is unloaded.
+    PricingServer* server = nullptr;
+
+    PricingWireRequest makeRequest(int pricerType,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath, bool computeGreeks)
+    {
+        PricingWireRequest request;
+        std::memset(&request, 0, sizeof(request));
+        request.pricerType = pricerType;
+        request.optionType = optionType;
+        request.optionStyle = optionStyle;
+        request.computeGreeks = computeGreeks ? 1 : 0;
+        request.S = S;
+        request.K = K;
+        request.T = T;
+        request.r = r;
+        request.sigma = sigma;
+        request.q = q;
+        request.binomialSteps = binomialSteps;
+        request.crankTimeSteps = crankTimeSteps;
+        request.crankSpotSteps = crankSpotSteps;
+        request.mcNumPaths = mcNumPaths;
+        request.mcTimeStepsPerPath = mcTimeStepsPerPath;
+        request.S_max = S_max;
+        if (calculationDate != nullptr) {
+            if (strlen(calculationDate) >= sizeof(request.calculationDate))
+                throw std::invalid_argument("Invalid calculation date.");
+            std::memcpy(request.calculationDate, calculationDate, strlen(calculationDate));
+        }
+        return request;
+    }
+
+} // namespace
+
+extern "C" {
+
+    int __stdcall StartPricingServer(int port, int batchWindowMicroseconds)
+    {
+        try {
+            if (port < 0 || port > 65535 || batchWindowMicroseconds < 0)
+                throw std::invalid_argument("Invalid server parameters.");
+            std::lock_guard<std::mutex> lock(serverMutex);
+            if (server)
+                throw std::runtime_error("The pricing server is already running.");
+            std::unique_ptr<PricingServer> created(new PricingServer(std::chrono::microseconds(batchWindowMicroseconds)));
+            int listening = created->start(static_cast<unsigned short>(port));
+            server = created.release();
+            return listening;
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+    void __stdcall StopPricingServer()
+    {
+        std::unique_ptr<PricingServer> stopped;
+        {
+            std::lock_guard<std::mutex> lock(serverMutex);
+            stopped.reset(server);
+            server = nullptr;
+        }
+        if (stopped)
+            stopped->stop();
+        serverStopped.notify_all();
+    }
+
+    void CALLBACK PricingServerMain(HWND window, HINSTANCE instance, LPSTR commandLine, int show)
+    {
+        char* end = nullptr;
+        long port = std::strtol(commandLine ? commandLine : "", &end, 10);
+        long batchWindow = std::strtol(end, nullptr, 10);
+        if (StartPricingServer(static_cast<int>(port), batchWindow > 0 ? static_cast<int>(batchWindow) : 50) < 0)
+            return;
+        std::unique_lock<std::mutex> lock(serverMutex);
+        serverStopped.wait(lock, [] { return server == nullptr; });
+    }
+
+    PricingServerConnectionHandle __stdcall ConnectPricingServer(int port)
+    {
+        try {
+            if (port <= 0 || port > 65535)
+                throw std::invalid_argument("Invalid port.");
+            std::unique_ptr<PricingServerConnection> connection(new PricingServerConnection());
+            connection->client.reset(new PricingClient(static_cast<unsigned short>(port)));
+            return connection.release();
+        }
+        catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    void __stdcall DisconnectPricingServer(PricingServerConnectionHandle connection)
+    {
+        delete connection;
+    }
+
+    double __stdcall PriceOptionRemote(
+        PricingServerConnectionHandle connection, int pricerType,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath)
+    {
+        try {
+            if (connection == nullptr)
+                throw std::invalid_argument("Null connection.");
+            PricingWireResponse response = connection->client->call(makeRequest(pricerType, S, K, T, r, sigma, q,
+                optionType, optionStyle, calculationDate, binomialSteps, crankTimeSteps, crankSpotSteps, S_max,
+                mcNumPaths, mcTimeStepsPerPath, false));
+            return (response.status == 0) ? response.price : -1.0;
+        }
+        catch (const std::exception&) {
+            return -1.0;
+        }
+    }
+
+    void __stdcall ComputeOptionGreeksRemote(
+        PricingServerConnectionHandle connection, int pricerType,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        try {
+            if (connection == nullptr)
+                throw std::invalid_argument("Null connection.");
+            PricingWireResponse response = connection->client->call(makeRequest(pricerType, S, K, T, r, sigma, q,
+                optionType, optionStyle, calculationDate, binomialSteps, crankTimeSteps, crankSpotSteps, S_max,
+                mcNumPaths, mcTimeStepsPerPath, true));
+            if (response.status != 0)
+                throw std::runtime_error("Remote pricing failed.");
+            if (delta) *delta = response.delta;
+            if (gamma) *gamma = response.gamma;
+            if (vega)  *vega = response.vega;
+            if (theta) *theta = response.theta;
+            if (rho)   *rho = response.rho;
+        }
+        catch (const std::exception&) {
+            if (delta) *delta = NAN;
+            if (gamma) *gamma = NAN;
+            if (vega)  *vega = NAN;
+            if (theta) *theta = NAN;
+            if (rho)   *rho = NAN;
+        }
+    }
+
+} // extern "C"
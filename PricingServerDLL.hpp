@@ -0,0 +1,65 @@
+#ifndef PRICING_SERVER_DLL_HPP
+#define PRICING_SERVER_DLL_HPP
+
+#ifdef PRICING_SERVER_DLL_EXPORTS
+#define PRICING_SERVER_API __declspec(dllexport)
+#else
+#define PRICING_SERVER_API __declspec(dllimport)
+#endif
+
+#include "pch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Function to start the process-wide pricing server on 127.0.0.1.
+    // Parameters:
+    //  port: TCP port (0 = any free port)
+    //  batchWindowMicroseconds: Time during which requests are gathered into one batch
+    // Returns the port listened on, or -1 on error (for instance if the server is already running).
+    PRICING_SERVER_API int __stdcall StartPricingServer(int port, int batchWindowMicroseconds);
+
+    // Function to stop the process-wide pricing server.
+    PRICING_SERVER_API void __stdcall StopPricingServer();
+
+    // Entry point to run the server as a daemon with rundll32:
+    //   rundll32 Multi_Model_Option_Pricer_DLL.dll,PricingServerMain <port> [<batchWindowMicroseconds>]
+    // It starts the server and blocks until StopPricingServer is called.
+    PRICING_SERVER_API void CALLBACK PricingServerMain(HWND window, HINSTANCE instance, LPSTR commandLine, int show);
+
+    // Opaque handle to a connection to a pricing server, for one thread at a time.
+    typedef struct PricingServerConnection* PricingServerConnectionHandle;
+
+    // Function to connect to a pricing server on 127.0.0.1. Returns a null handle on error.
+    PRICING_SERVER_API PricingServerConnectionHandle __stdcall ConnectPricingServer(int port);
+
+    // Function to close a connection. A null handle is ignored.
+    PRICING_SERVER_API void __stdcall DisconnectPricingServer(PricingServerConnectionHandle connection);
+
+    // Function to compute an option price on the server.
+    // Parameters are those of the stateless functions, with pricerType as in CreatePricingSession
+    // (0 = Black-Scholes, 1 = Binomial, 2 = Crank-Nicolson, 3 = Monte Carlo, ...). Returns -1 on error.
+    PRICING_SERVER_API double __stdcall PriceOptionRemote(
+        PricingServerConnectionHandle connection, int pricerType,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath);
+
+    // Function to compute the Greeks on the server.
+    // The computed Greeks (delta, gamma, vega, theta, rho) are written to the pointers provided;
+    // if an error occurs, they are set to NAN.
+    PRICING_SERVER_API void __stdcall ComputeOptionGreeksRemote(
+        PricingServerConnectionHandle connection, int pricerType,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath,
+        double* delta, double* gamma, double* vega, double* theta, double* rho);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRICING_SERVER_DLL_HPP
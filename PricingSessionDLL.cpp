@@ -0,0 +1,209 @@
+#include "pch.h"
+#include "PricingSessionDLL.hpp"
+#include "PricerFactory.hpp"
+#include "Option.hpp"
+#include "PricingConfiguration.hpp"
+#include "DateConverter.hpp"
+#include "YieldCurveCache.hpp"
+#include "YieldCurveRegistry.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <chrono>
+
+// State of a session. The engine prices every maturity (the maturity is set on the option), and is
+// taken again from the pool of PricerFactory only when the rate differs from the previous call, as it
+// is part of the engine configuration: returning to a rate already used reuses a prepared engine.
+struct PricingSession {
+    PricerType type;
+    std::string calculationDate;          // As given ("" = today).
+    PricingConfiguration config;          // Configuration of the engine, without the calculation date.
+    double dateOffset;                    // Years from the calculation date to now.
+    CurveKey curveKey;                    // Name of the curve in YieldCurveRegistry.
+    std::shared_ptr<const CurveSnapshot> curve; // Version of the curve in use (null for Black-Scholes).
+    PooledPricer pricer;                  // Last engine lent by the pool.
+    double pricerRate;                    // Rate of the last engine.
+};
+
+namespace {
+
+    // Engines whose effective maturity is T minus the time elapsed since the calculation date.
+    // The binomial engine uses T as given.
+    bool appliesCalculationDate(PricerType type) {
+        return type != PricerType::Binomial;
+    }
+
+    // Takes the current version of the curve of the session; the engine is dropped only if it changed.
+    void refreshCurve(PricingSession& session) {
+        // The Black-Scholes functions use the constant rate r, not the curve.
+        if (session.type == PricerType::BlackScholes) {
+            return;
+        }
+        // The default curve file is published in the registry when it is first loaded.
+        if (session.curveKey == YieldCurveCache::defaultKey()) {
+            YieldCurveCache::defaultCurve();
+        }
+        std::shared_ptr<const CurveSnapshot> curve = YieldCurveRegistry::instance().find(session.curveKey);
+        if (!curve) {
+            throw std::runtime_error("No yield curve published under this name.");
+        }
+        if (curve != session.curve) {
+            session.curve = curve;
+            session.config.yieldCurve = curve->curve;
+            session.pricer.reset();
+        }
+    }
+
+    // Resolves the calculation date and takes the current curve.
+    void refresh(PricingSession& session) {
+        session.dateOffset = 0.0;
+        if (appliesCalculationDate(session.type)) {
+            std::string date = session.calculationDate.empty() ? DateConverter::getTodayDate() : session.calculationDate;
+            session.dateOffset = DateConverter::yearsBetween(DateConverter::parseDate(date), std::chrono::system_clock::now());
+        }
+        refreshCurve(session);
+    }
+
+    // Returns the engine for the rate r, building it if needed.
+    const IOptionPricer& pricerFor(PricingSession& session, double r) {
+        if (!session.pricer || r != session.pricerRate) {
+            session.pricer.reset();
+            session.config.riskFreeRate = r;
+            session.pricer = PricerFactory::acquirePricer(session.type, session.config);
+            session.pricerRate = r;
+        }
+        return *session.pricer;
+    }
+
+    Option makeOption(const PricingSession& session, double S, double K, double T, double sigma, double q,
+        int optionType, int optionStyle) {
+        // The calculation date is applied here once, instead of by the engine on every call.
+        if (session.dateOffset >= T && appliesCalculationDate(session.type)) {
+            throw std::runtime_error("Effective maturity is negative. Check the calculation date.");
+        }
+        Option opt(S, K, sigma, q,
+            (optionType == 0 ? Option::OptionType::Call : Option::OptionType::Put),
+            (optionStyle == 0 ? Option::OptionStyle::European : Option::OptionStyle::American));
+        opt.setMaturity(T - session.dateOffset);
+        return opt;
+    }
+
+} // namespace
+
+extern "C" {
+
+    PricingSessionHandle __stdcall CreatePricingSession(
+        int pricerType, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath)
+    {
+        try {
+            if (pricerType < static_cast<int>(PricerType::BlackScholes) || pricerType > static_cast<int>(PricerType::CarrMadan))
+                throw std::invalid_argument("Unknown pricer type.");
+
+            std::unique_ptr<PricingSession> session(new PricingSession());
+            session->type = static_cast<PricerType>(pricerType);
+            if (calculationDate != nullptr)
+                session->calculationDate = calculationDate;
+
+            session->config.binomialSteps = binomialSteps;
+            session->config.crankTimeSteps = crankTimeSteps;
+            session->config.crankSpotSteps = crankSpotSteps;
+            session->config.S_max = S_max;
+            session->config.mcNumPaths = mcNumPaths;
+            session->config.mcTimeStepsPerPath = mcTimeStepsPerPath;
+            session->pricerRate = 0.0;
+            session->curveKey = YieldCurveCache::defaultKey();
+
+            refresh(*session);
+            return session.release();
+        }
+        catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    int __stdcall RefreshPricingSession(PricingSessionHandle session)
+    {
+        try {
+            if (session == nullptr)
+                throw std::invalid_argument("Null pricing session.");
+            refresh(*session);
+            return 0;
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+    int __stdcall SetPricingSessionCurve(PricingSessionHandle session, const char* currency, const char* index)
+    {
+        try {
+            if (session == nullptr || currency == nullptr || index == nullptr)
+                throw std::invalid_argument("Null pricing session or curve name.");
+            CurveKey previous = session->curveKey;
+            session->curveKey = CurveKey{ currency, index, CurveRole::Discount };
+            try {
+                refreshCurve(*session);
+            }
+            catch (...) {
+                session->curveKey = previous;
+                throw;
+            }
+            return 0;
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    }
+
+    void __stdcall DestroyPricingSession(PricingSessionHandle session)
+    {
+        delete session;
+    }
+
+    double __stdcall PriceOptionSession(
+        PricingSessionHandle session,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle)
+    {
+        try {
+            if (session == nullptr)
+                throw std::invalid_argument("Null pricing session.");
+            Option opt = makeOption(*session, S, K, T, sigma, q, optionType, optionStyle);
+            return pricerFor(*session, r).price(opt);
+        }
+        catch (const std::exception&) {
+            return -1.0;
+        }
+    }
+
+    void __stdcall ComputeOptionGreeksSession(
+        PricingSessionHandle session,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle,
+        double* delta, double* gamma, double* vega, double* theta, double* rho)
+    {
+        try {
+            if (session == nullptr)
+                throw std::invalid_argument("Null pricing session.");
+            Option opt = makeOption(*session, S, K, T, sigma, q, optionType, optionStyle);
+            Greeks g = pricerFor(*session, r).computeGreeks(opt);
+            if (delta) *delta = g.delta;
+            if (gamma) *gamma = g.gamma;
+            if (vega)  *vega = g.vega;
+            if (theta) *theta = g.theta;
+            if (rho)   *rho = g.rho;
+        }
+        catch (const std::exception&) {
+            if (delta) *delta = NAN;
+            if (gamma) *gamma = NAN;
+            if (vega)  *vega = NAN;
+            if (theta) *theta = NAN;
+            if (rho)   *rho = NAN;
+        }
+    }
+
+} // extern "C"
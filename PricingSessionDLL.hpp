@@ -0,0 +1,77 @@
+#ifndef PRICING_SESSION_DLL_HPP
+#define PRICING_SESSION_DLL_HPP
+
+#ifdef PRICING_SESSION_DLL_EXPORTS
+#define PRICING_SESSION_API __declspec(dllexport)
+#else
+#define PRICING_SESSION_API __declspec(dllimport)
+#endif
+
+#include "pch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Opaque handle to a pricing session.
+    // A session holds the parsed configuration of one engine, the calculation date resolved to a
+    // time offset, a snapshot of a curve of YieldCurveRegistry (by default the curve of the default
+    // curve file) and the last engine built, so that the setup of the stateless functions is done
+    // once instead of on every call. A session must not be used by several threads at the same time;
+    // create one session per thread.
+    typedef struct PricingSession* PricingSessionHandle;
+
+    // Function to create a pricing session.
+    // Parameters:
+    //  pricerType: 0 = Black-Scholes, 1 = Binomial, 2 = Crank-Nicolson, 3 = Monte Carlo,
+    //              4 = ADI, 5 = Jump-diffusion, 6 = COS, 7 = Carr-Madan (default model parameters
+    //              for the engines without parameters below)
+    //  calculationDate: A null-terminated string in "YYYY-MM-DD"; if empty, today's date is used.
+    //  binomialSteps: Number of steps of the binomial tree
+    //  crankTimeSteps, crankSpotSteps: Number of time and spot steps of the PDE grids
+    //  S_max: Maximum underlying asset price (if 0, default is computed inside the model)
+    //  mcNumPaths, mcTimeStepsPerPath: Number of Monte Carlo paths and time steps per path
+    // Returns the session, or a null handle on error.
+    PRICING_SESSION_API PricingSessionHandle __stdcall CreatePricingSession(
+        int pricerType, const char* calculationDate,
+        int binomialSteps, int crankTimeSteps, int crankSpotSteps, double S_max,
+        int mcNumPaths, int mcTimeStepsPerPath);
+
+    // Function to take the latest version of the yield curve of the session and to resolve the calculation
+    // date again (the offset from the calculation date to now is computed when the session is created).
+    // The engine is kept if the curve has not been published again since the last refresh.
+    // Returns 0, or -1 on error.
+    PRICING_SESSION_API int __stdcall RefreshPricingSession(PricingSessionHandle session);
+
+    // Function to select the yield curve of a session: the discount curve published in YieldCurveRegistry
+    // under a currency and an index (for instance by YieldCurveCache::publishAs). The session takes its
+    // latest version, and later versions on RefreshPricingSession. Has no effect on a Black-Scholes session.
+    // Returns 0, or -1 on error (no curve published under this name); the session then keeps its curve.
+    PRICING_SESSION_API int __stdcall SetPricingSessionCurve(PricingSessionHandle session,
+        const char* currency, const char* index);
+
+    // Function to destroy a pricing session. A null handle is ignored.
+    PRICING_SESSION_API void __stdcall DestroyPricingSession(PricingSessionHandle session);
+
+    // Function to compute the option price with the engine of a session.
+    // Parameters are those of the stateless functions (T in years, optionType: 0 = Call, 1 = Put,
+    // optionStyle: 0 = European, 1 = American). Returns -1 on error.
+    PRICING_SESSION_API double __stdcall PriceOptionSession(
+        PricingSessionHandle session,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle);
+
+    // Function to compute the Greeks with the engine of a session.
+    // The computed Greeks (delta, gamma, vega, theta, rho) are written to the pointers provided;
+    // if an error occurs, they are set to NAN.
+    PRICING_SESSION_API void __stdcall ComputeOptionGreeksSession(
+        PricingSessionHandle session,
+        double S, double K, double T, double r, double sigma, double q,
+        int optionType, int optionStyle,
+        double* delta, double* gamma, double* vega, double* theta, double* rho);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRICING_SESSION_DLL_HPP
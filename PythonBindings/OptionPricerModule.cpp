@@ -0,0 +1,320 @@
+/**
+ * @file OptionPricerModule.cpp
+ * @brief Python extension module pricing options directly from and into NumPy arrays.
+ *
+ * The module reads its inputs and writes its outputs through the buffer protocol, so that NumPy
+ * arrays (or any other contiguous buffer, such as array.array) are used in place: nothing is copied
+ * or converted, and a call on a million options costs no more Python work than a call on one.
+ * The pricing runs on PortfolioPricer threads with the GIL released, so other Python threads keep
+ * running meanwhile.
+ *
+ *    import numpy as np
+ *    import option_pricer as op
+ *
+ *    n = len(spot)
+ *    price = np.empty(n)
+ *    status = np.empty(n, dtype=np.int32)
+ *    priced = op.price_batch(spot, strike, vol, div, maturity,
+ *                            option_type, option_style, engine,   # int32 arrays
+ *                            price, status=status, risk_free_rate=0.03)
+ *
+ * Inputs are C-contiguous float64 arrays (spot, strike, volatility, dividend, maturity and the
+ * optional rate) and int32 arrays (option_type: 0 = call, 1 = put; option_style: 0 = European,
+ * 1 = American; engine: BLACK_SCHOLES, BINOMIAL, ...), all of the same length. Outputs are writable
+ * arrays of that length: price, and optionally status (int32) and the five Greeks (float64, all or
+ * none). A row that cannot be priced gets price -1, NaN Greeks and status -1. The function returns
+ * the number of rows priced.
+ *
+ * rate, when given, replaces risk_free_rate row by row for every engine. BLACK_SCHOLES, COS and
+ * CARR_MADAN price at the row rate. The curve-aware engines (BINOMIAL, CRANK_NICOLSON, MONTE_CARLO,
+ * ADI and JUMP_DIFFUSION) price on curve shifted in parallel by rate - risk_free_rate. Without
+ * curve, the curve is flat at risk_free_rate, so the shifted curve is flat at the row rate.
+ *
+ * Build on Linux, from this directory:
+ *
+ *    g++ -std=c++14 -O2 -shared -fPIC -pthread -I.. $(python3-config --includes) OptionPricerModule.cpp \
+ *        ../PortfolioPricer.cpp ../PortfolioFile.cpp ../MappedFile.cpp ../PricerFactory.cpp \
+ *        ../BlackScholesPricer.cpp ../BinomialPricer.cpp ../CrankNicolsonPricer.cpp ../MonteCarloPricer.cpp \
+ *        ../AdiPricer.cpp ../JumpDiffusionPricer.cpp ../CosPricer.cpp ../CarrMadanPricer.cpp \
+ *        ../CharacteristicFunction.cpp ../FourierTransform.cpp ../TridiagonalSolver.cpp ../Option.cpp \
+ *        ../OptionBatch.cpp ../InterfaceOptionPricer.cpp ../YieldCurve.cpp ../DateConverter.cpp \
+ *        -o option_pricer$(python3-config --extension-suffix)
+ *
+ * On Windows, the same sources are built as option_pricer.pyd, against the Python include and libs
+ * directories.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "pch.h"
+#include "PortfolioPricer.hpp"
+#include "PortfolioFile.hpp"
+#include "PricerFactory.hpp"
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+namespace {
+
+    /**
+     * @brief A buffer obtained from a Python object, released with it.
+     */
+    class BufferView {
+    public:
+        BufferView() : acquired_(false) {}
+
+        BufferView(const BufferView&) = delete;
+        BufferView& operator=(const BufferView&) = delete;
+
+        ~BufferView() {
+            if (acquired_) {
+                PyBuffer_Release(&view_);
+            }
+        }
+
+        /**
+         * @brief Gets a C-contiguous buffer of float64 or int32 values.
+         * @return False, with a Python exception set, if the object is not such a buffer.
+         */
+        bool acquire(PyObject* object, const char* name, ColumnType type, bool writable) {
+            int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+            if (PyObject_GetBuffer(object, &view_, flags) != 0) {
+                PyErr_Format(PyExc_TypeError, "%s must be a %scontiguous array", name, writable ? "writable " : "");
+                return false;
+            }
+            acquired_ = true;
+            if (!hasType(type)) {
+                PyErr_Format(PyExc_TypeError, "%s must be an array of %s", name,
+                    type == ColumnType::Float64 ? "float64" : "int32");
+                return false;
+            }
+            return true;
+        }
+
+        size_t length() const { return static_cast<size_t>(view_.len / view_.itemsize); }
+        void* data() const { return view_.buf; }
+
+    private:
+        bool hasType(ColumnType type) const {
+            // Skip the byte-order prefix; only native order is accepted.
+            const char* format = view_.format ? view_.format : "B";
+            if (*format == '@' || *format == '=' || *format == '<') {
+                ++format;
+            }
+            if (std::strlen(format) != 1) {
+                return false;
+            }
+            if (type == ColumnType::Float64) {
+                return *format == 'd' && view_.itemsize == sizeof(double);
+            }
+            // int32 is 'i' with NumPy, or 'l' where long has 32 bits (Windows).
+            return (*format == 'i' || *format == 'l') && view_.itemsize == sizeof(std::int32_t);
+        }
+
+        Py_buffer view_;
+        bool acquired_;
+    };
+
+    /// Reads a sequence of (maturity, rate) pairs into a curve.
+    bool readCurve(PyObject* object, YieldCurve& curve) {
+        PyObject* points = PySequence_Fast(object, "curve must be a sequence of (maturity, rate) pairs");
+        if (!points) {
+            return false;
+        }
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(points);
+        for (Py_ssize_t i = 0; i < count; ++i) {
+            double maturity, rate;
+            if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(points, i), "dd", &maturity, &rate)) {
+                Py_DECREF(points);
+                return false;
+            }
+            curve.addRatePoint(maturity, rate);
+        }
+        Py_DECREF(points);
+        if (count == 0) {
+            PyErr_SetString(PyExc_ValueError, "curve must not be empty");
+            return false;
+        }
+        return true;
+    }
+
+    PyObject* priceBatch(PyObject*, PyObject* args, PyObject* kwargs) {
+        static const char* keywords[] = {
+            "spot", "strike", "volatility", "dividend", "maturity", "option_type", "option_style", "engine", "price",
+            "rate", "delta", "gamma", "vega", "theta", "rho", "status",
+            "risk_free_rate", "curve", "calculation_date", "binomial_steps", "crank_time_steps", "crank_spot_steps",
+            "s_max", "mc_paths", "mc_steps", "threads", nullptr
+        };
+        PyObject* inputs[8];
+        PyObject* priceObject;
+        PyObject* rateObject = Py_None;
+        PyObject* greekObjects[5] = { Py_None, Py_None, Py_None, Py_None, Py_None };
+        PyObject* statusObject = Py_None;
+        PyObject* curveObject = Py_None;
+        const char* calculationDate = "";
+        int threads = 0;
+        PricingConfiguration config;
+        config.riskFreeRate = 0.0;
+
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOOOOOOO|$OOOOOOOdOsiiidiii", const_cast<char**>(keywords),
+            &inputs[0], &inputs[1], &inputs[2], &inputs[3], &inputs[4], &inputs[5], &inputs[6], &inputs[7], &priceObject,
+            &rateObject, &greekObjects[0], &greekObjects[1], &greekObjects[2], &greekObjects[3], &greekObjects[4], &statusObject,
+            &config.riskFreeRate, &curveObject, &calculationDate, &config.binomialSteps, &config.crankTimeSteps,
+            &config.crankSpotSteps, &config.S_max, &config.mcNumPaths, &config.mcTimeStepsPerPath, &threads)) {
+            return nullptr;
+        }
+
+        // Inputs.
+        BufferView inputViews[8];
+        const ColumnType inputTypes[8] = { ColumnType::Float64, ColumnType::Float64, ColumnType::Float64, ColumnType::Float64,
+            ColumnType::Float64, ColumnType::Int32, ColumnType::Int32, ColumnType::Int32 };
+        for (int c = 0; c < 8; ++c) {
+            if (!inputViews[c].acquire(inputs[c], keywords[c], inputTypes[c], false)) {
+                return nullptr;
+            }
+        }
+        const size_t rows = inputViews[0].length();
+        BufferView rateView;
+        if (rateObject != Py_None && !rateView.acquire(rateObject, "rate", ColumnType::Float64, false)) {
+            return nullptr;
+        }
+
+        // Outputs.
+        BufferView priceView;
+        if (!priceView.acquire(priceObject, "price", ColumnType::Float64, true)) {
+            return nullptr;
+        }
+        BufferView statusView;
+        if (statusObject != Py_None && !statusView.acquire(statusObject, "status", ColumnType::Int32, true)) {
+            return nullptr;
+        }
+        BufferView greekViews[5];
+        int greekCount = 0;
+        for (int g = 0; g < 5; ++g) {
+            if (greekObjects[g] != Py_None) {
+                if (!greekViews[g].acquire(greekObjects[g], keywords[10 + g], ColumnType::Float64, true)) {
+                    return nullptr;
+                }
+                ++greekCount;
+            }
+        }
+        if (greekCount != 0 && greekCount != 5) {
+            PyErr_SetString(PyExc_ValueError, "delta, gamma, vega, theta and rho must be given together");
+            return nullptr;
+        }
+
+        // Lengths.
+        bool sameLength = true;
+        for (const BufferView& view : inputViews) {
+            sameLength = sameLength && view.length() == rows;
+        }
+        sameLength = sameLength && priceView.length() == rows
+            && (rateObject == Py_None || rateView.length() == rows)
+            && (statusObject == Py_None || statusView.length() == rows);
+        for (int g = 0; g < greekCount; ++g) {
+            sameLength = sameLength && greekViews[g].length() == rows;
+        }
+        if (!sameLength) {
+            PyErr_SetString(PyExc_ValueError, "all the arrays must have the same length");
+            return nullptr;
+        }
+
+        config.calculationDate = calculationDate;
+        if (curveObject != Py_None) {
+            if (!readCurve(curveObject, config.yieldCurve)) {
+                return nullptr;
+            }
+        }
+        else {
+            // The curve-aware engines need a curve: a single point makes it flat at risk_free_rate,
+            // and the rate of a row shifts it to the row rate (see PortfolioColumns::rate).
+            config.yieldCurve.addRatePoint(1.0, config.riskFreeRate);
+        }
+
+        PortfolioColumns positions = { rows,
+            static_cast<const double*>(inputViews[0].data()), static_cast<const double*>(inputViews[1].data()),
+            static_cast<const double*>(inputViews[2].data()), static_cast<const double*>(inputViews[3].data()),
+            static_cast<const double*>(inputViews[4].data()),
+            rateObject == Py_None ? nullptr : static_cast<const double*>(rateView.data()),
+            static_cast<const std::int32_t*>(inputViews[5].data()), static_cast<const std::int32_t*>(inputViews[6].data()),
+            static_cast<const std::int32_t*>(inputViews[7].data()) };
+        PortfolioResultColumns results = {};
+        results.price = static_cast<double*>(priceView.data());
+        results.status = (statusObject == Py_None) ? nullptr : static_cast<std::int32_t*>(statusView.data());
+        if (greekCount == 5) {
+            results.delta = static_cast<double*>(greekViews[0].data());
+            results.gamma = static_cast<double*>(greekViews[1].data());
+            results.vega = static_cast<double*>(greekViews[2].data());
+            results.theta = static_cast<double*>(greekViews[3].data());
+            results.rho = static_cast<double*>(greekViews[4].data());
+        }
+
+        // The buffers stay acquired (so their memory stays valid) while the GIL is released.
+        size_t priced = 0;
+        std::string error;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            PortfolioPricer pricer(config, threads);
+            priced = pricer.price(positions, results);
+        }
+        catch (const std::exception& ex) {
+            error = ex.what();
+        }
+        Py_END_ALLOW_THREADS
+        if (!error.empty()) {
+            PyErr_SetString(PyExc_ValueError, error.c_str());
+            return nullptr;
+        }
+        return PyLong_FromSize_t(priced);
+    }
+
+    PyMethodDef methods[] = {
+        { "price_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(priceBatch)), METH_VARARGS | METH_KEYWORDS,
+          "price_batch(spot, strike, volatility, dividend, maturity, option_type, option_style, engine, price, *,\n"
+          "            rate=None, delta=None, gamma=None, vega=None, theta=None, rho=None, status=None,\n"
+          "            risk_free_rate=0.0, curve=None, calculation_date='', binomial_steps=100,\n"
+          "            crank_time_steps=100, crank_spot_steps=100, s_max=0.0, mc_paths=10000, mc_steps=100,\n"
+          "            threads=0)\n"
+          "--\n\n"
+          "Prices the options described by the input arrays into the preallocated output arrays,\n"
+          "without copying them and with the GIL released. curve is a sequence of (maturity, rate)\n"
+          "pairs (default: flat at risk_free_rate). rate overrides risk_free_rate row by row:\n"
+          "BLACK_SCHOLES, COS and CARR_MADAN price at the row rate, and the curve-aware engines\n"
+          "(BINOMIAL, CRANK_NICOLSON, MONTE_CARLO, ADI, JUMP_DIFFUSION) on curve shifted in parallel\n"
+          "by rate - risk_free_rate. Returns the number of options priced." },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+    PyModuleDef moduleDefinition = {
+        PyModuleDef_HEAD_INIT, "option_pricer",
+        "Multi-model option pricing engines over NumPy arrays.", -1, methods,
+        nullptr, nullptr, nullptr, nullptr
+    };
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_option_pricer() {
+    PyObject* module = PyModule_Create(&moduleDefinition);
+    if (!module) {
+        return nullptr;
+    }
+    const struct { const char* name; int value; } constants[] = {
+        { "BLACK_SCHOLES", static_cast<int>(PricerType::BlackScholes) },
+        { "BINOMIAL", static_cast<int>(PricerType::Binomial) },
+        { "CRANK_NICOLSON", static_cast<int>(PricerType::CrankNicolson) },
+        { "MONTE_CARLO", static_cast<int>(PricerType::MonteCarlo) },
+        { "ADI", static_cast<int>(PricerType::Adi) },
+        { "JUMP_DIFFUSION", static_cast<int>(PricerType::JumpDiffusion) },
+        { "COS", static_cast<int>(PricerType::Cos) },
+        { "CARR_MADAN", static_cast<int>(PricerType::CarrMadan) },
+        { "CALL", 0 }, { "PUT", 1 }, { "EUROPEAN", 0 }, { "AMERICAN", 1 }
+    };
+    for (const auto& constant : constants) {
+        if (PyModule_AddIntConstant(module, constant.name, constant.value) != 0) {
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }
+    return module;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file TridiagonalSolver.cpp
+ * @brief Implementation of the Thomas algorithm for tridiagonal systems.
+ */
+
+#include "pch.h"
+#include "TridiagonalSolver.hpp"
+
+void solveTridiagonal(const std::vector<double>& a, const std::vector<double>& b,
+    const std::vector<double>& c, const std::vector<double>& d, std::vector<double>& x,
+    std::vector<double>& c_prime, std::vector<double>& d_prime) {
+    const int n = static_cast<int>(d.size());
+
+    c_prime[0] = c[0] / b[0];
+    d_prime[0] = d[0] / b[0];
+
+    for (int j = 1; j < n; ++j) {
+        double m = b[j] - a[j] * c_prime[j - 1];
+        c_prime[j] = c[j] / m;
+        d_prime[j] = (d[j] - a[j] * d_prime[j - 1]) / m;
+    }
+
+    x[n - 1] = d_prime[n - 1];
+    for (int j = n - 2; j >= 0; --j) {
+        x[j] = d_prime[j] - c_prime[j] * x[j + 1];
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef TRIDIAGONALSOLVER_HPP
+#define TRIDIAGONALSOLVER_HPP
+
+/**
+ * @file TridiagonalSolver.hpp
+ * @brief Declaration of the tridiagonal (Thomas) solver shared by the finite difference engines.
+ *
+ * The one-dimensional Crank-Nicolson scheme and the line solves of the ADI engine all reduce
+ * each implicit step to one or more tridiagonal systems, which are solved with this routine.
+ */
+
+#include "pch.h"
+#include <vector>
+
+/**
+ * @brief Solves a tridiagonal system with the Thomas algorithm.
+ *
+ * The system has sub-diagonal a, diagonal b, super-diagonal c and right-hand side d, all of
+ * size n = d.size() (a[0] and c[n-1] are ignored). The scratch vectors c_prime and d_prime are
+ * passed in so that callers can reuse them across time steps and lines without reallocating.
+ *
+ * @param a Sub-diagonal coefficients.
+ * @param b Diagonal coefficients.
+ * @param c Super-diagonal coefficients.
+ * @param d Right-hand side.
+ * @param x Output vector receiving the solution (size n).
+ * @param c_prime Scratch vector (size n).
+ * @param d_prime Scratch vector (size n).
+ */
+void solveTridiagonal(const std::vector<double>& a, const std::vector<double>& b,
+    const std::vector<double>& c, const std::vector<double>& d, std::vector<double>& x,
+    std::vector<double>& c_prime, std::vector<double>& d_prime);
+
+#endif // TRIDIAGONALSOLVER_HPP
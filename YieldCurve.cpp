@@ -3,51 +3,381 @@
  * @brief Implementation of the YieldCurve class for managing the interest rate curve.
  *
  * This file implements the YieldCurve class, which allows adding rate points,
- * performing linear interpolation to obtain an interest rate for a given maturity,
- * and loading the rate data from a text file.
+ * interpolating them (linearly, with a monotone cubic spline or linearly in the log
+ * of the discount factors) to obtain an interest rate for a given maturity, and
+ * loading the rate data from a text file. The interpolation coefficients and the
+ * uniform-spacing check are updated as each point is added, so that a lookup costs
+ * O(1) on a uniform curve and O(log n) otherwise.
+ *
+ * The monotone cubic is a Hermite spline whose node derivatives are the three-point
+ * (Bessel) estimates, filtered as proposed by Hyman (1983): a derivative is set to zero
+ * at a local extremum of the data and limited to three times the smaller adjacent
+ * secant elsewhere, which keeps the spline monotone wherever the points are. The
+ * derivative at a node depends on its two neighbours only, so appending a point
+ * changes the last two intervals (three while the curve has three points).
  */
 
 #include "pch.h"
 #include "YieldCurve.hpp"
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 
+namespace {
+
+    /// Relative tolerance on the spacing of the maturities of a uniform curve.
+    const double kUniformTolerance = 1e-9;
+
+    /**
+     * @brief Derivative of the monotone cubic at node i, with its gradient with respect to
+     *        the rates of points first, first + 1 and first + 2.
+     */
+    double hymanSlope(const RatePoint* points, size_t n, size_t i, size_t& first, double gradient[3]) {
+        // Secants around the node and their gradients.
+        auto secant = [&](size_t j, double& h, double& g) {
+            h = points[j + 1].maturity - points[j].maturity;
+            g = (h > 0.0) ? 1.0 / h : 0.0;
+            return (points[j + 1].rate - points[j].rate) * g;
+        };
+
+        if (n == 2) {
+            double h, g;
+            double d = secant(0, h, g);
+            first = 0;
+            gradient[0] = -g;
+            gradient[1] = g;
+            gradient[2] = 0.0;
+            return d;
+        }
+
+        // Three points around the node; at the ends, the parabola through the first or last three.
+        first = (i == 0) ? 0 : (i == n - 1) ? n - 3 : i - 1;
+        double h0, g0, h1, g1;
+        double s0 = secant(first, h0, g0);
+        double s1 = secant(first + 1, h1, g1);
+        double gs0[3] = { -g0, g0, 0.0 };
+        double gs1[3] = { 0.0, -g1, g1 };
+        double w0, w1, sNear; // d = w0 s0 + w1 s1; sNear is the secant adjacent to an end node
+        const double* gNear;
+        if (i == 0) {
+            w0 = (2.0 * h0 + h1) / (h0 + h1);
+            w1 = -h0 / (h0 + h1);
+            sNear = s0;
+            gNear = gs0;
+        }
+        else if (i == n - 1) {
+            w0 = -h1 / (h0 + h1);
+            w1 = (2.0 * h1 + h0) / (h0 + h1);
+            sNear = s1;
+            gNear = gs1;
+        }
+        else {
+            w0 = h1 / (h0 + h1);
+            w1 = h0 / (h0 + h1);
+            sNear = 0.0;
+            gNear = nullptr;
+        }
+        double d = w0 * s0 + w1 * s1;
+        for (int k = 0; k < 3; ++k) {
+            gradient[k] = w0 * gs0[k] + w1 * gs1[k];
+        }
+
+        // Hyman filter.
+        double limit;
+        const double* gLimit;
+        if (gNear) {
+            if (d * sNear <= 0.0) {
+                d = 0.0;
+            }
+            limit = 3.0 * std::abs(sNear);
+            gLimit = gNear;
+        }
+        else {
+            if (s0 * s1 <= 0.0 || d * s1 <= 0.0) {
+                d = 0.0;
+            }
+            limit = 3.0 * std::min(std::abs(s0), std::abs(s1));
+            gLimit = (std::abs(s0) <= std::abs(s1)) ? gs0 : gs1;
+        }
+        if (d == 0.0) {
+            gradient[0] = gradient[1] = gradient[2] = 0.0;
+        }
+        else if (std::abs(d) > limit) {
+            // d has the sign of the limiting secant, so the limit is 3 x that secant.
+            d = (d > 0.0) ? limit : -limit;
+            for (int k = 0; k < 3; ++k) {
+                gradient[k] = 3.0 * gLimit[k];
+            }
+        }
+        return d;
+    }
+
+} // namespace
+
+YieldCurve::CurveData& YieldCurve::mutableData() {
+    if (!data_) {
+        data_ = std::make_shared<CurveData>();
+    }
+    else if (data_.use_count() > 1) {
+        data_ = std::make_shared<CurveData>(*data_);
+    }
+    return *data_;
+}
+
+void YieldCurve::setInterpolation(InterpolationMethod method) {
+    CurveData& data = mutableData();
+    data.method = method;
+    updateSegments(data, 0);
+}
+
+InterpolationMethod YieldCurve::getInterpolation() const {
+    return data_ ? data_->method : InterpolationMethod::Linear;
+}
+
 void YieldCurve::addRatePoint(double maturity, double rate) {
-    data_.push_back({ maturity, rate });
+    CurveData& data = mutableData();
+    if (!data.points.empty() && maturity < data.points.back().maturity) {
+        // Out of order: insert at its place and rebuild the interpolation data.
+        auto it = std::upper_bound(data.points.begin(), data.points.end(), maturity,
+            [](double m, const RatePoint& p) { return m < p.maturity; });
+        data.points.insert(it, { maturity, rate });
+        rebuildIndex(data);
+        return;
+    }
+    appendPoint(data, maturity, rate);
+}
+
+void YieldCurve::appendPoint(CurveData& data, double maturity, double rate) {
+    data.points.push_back({ maturity, rate });
+    const size_t n = data.points.size();
+    if (n < 2) {
+        return;
+    }
+    const RatePoint& p0 = data.points[n - 2];
+    const RatePoint& p1 = data.points[n - 1];
+    double width = p1.maturity - p0.maturity;
+    // The cubic's derivative at the previous last node changes with the new point.
+    updateSegments(data, (data.method == InterpolationMethod::MonotoneCubic && n >= 3) ? n - 3 : n - 2);
+
+    if (n == 2) {
+        data.step = width;
+        data.uniform = (data.step > 0.0);
+        data.invStep = data.uniform ? 1.0 / data.step : 0.0;
+    }
+    else if (data.uniform) {
+        double expected = data.points.front().maturity + static_cast<double>(n - 1) * data.step;
+        data.uniform = std::abs(p1.maturity - expected) <= kUniformTolerance * std::max(1.0, std::abs(expected));
+    }
+}
+
+void YieldCurve::rebuildIndex(CurveData& data) {
+    std::vector<RatePoint> points;
+    points.swap(data.points);
+    data.segments.clear();
+    data.uniform = true;
+    data.step = 0.0;
+    data.invStep = 0.0;
+    for (const auto& pt : points) {
+        appendPoint(data, pt.maturity, pt.rate);
+    }
+}
+
+void YieldCurve::updateSegments(CurveData& data, size_t first) {
+    const size_t n = data.points.size();
+    data.segments.resize(n < 2 ? 0 : n - 1);
+    for (size_t i = first; i + 1 < n; ++i) {
+        data.segments[i] = segmentOf(data.points.data(), n, data.method, i);
+    }
+}
+
+YieldCurve::Segment YieldCurve::segmentOf(const RatePoint* points, size_t count, InterpolationMethod method, size_t i) {
+    const RatePoint& p0 = points[i];
+    const RatePoint& p1 = points[i + 1];
+    double width = p1.maturity - p0.maturity;
+    double slope = width > 0.0 ? (p1.rate - p0.rate) / width : 0.0;
+    Segment segment;
+    segment.c2 = 0.0;
+    segment.c3 = 0.0;
+    switch (method) {
+    case InterpolationMethod::Linear:
+        segment.c1 = slope;
+        break;
+    case InterpolationMethod::MonotoneCubic: {
+        if (!(width > 0.0)) {
+            segment.c1 = 0.0;
+            break;
+        }
+        size_t unusedFirst;
+        double unusedGradient[3];
+        double d0 = hymanSlope(points, count, i, unusedFirst, unusedGradient);
+        double d1 = hymanSlope(points, count, i + 1, unusedFirst, unusedGradient);
+        segment.c1 = d0;
+        segment.c2 = (3.0 * slope - 2.0 * d0 - d1) / width;
+        segment.c3 = (d0 + d1 - 2.0 * slope) / (width * width);
+        break;
+    }
+    case InterpolationMethod::LogDiscount:
+        // Forward rate of the interval: -d log(discount) / dt.
+        segment.c1 = width > 0.0 ? (p1.rate * p1.maturity - p0.rate * p0.maturity) / width : 0.0;
+        break;
+    }
+    return segment;
+}
+
+double YieldCurve::interpolate(const RatePoint* points, size_t count, InterpolationMethod method, size_t i, double t) {
+    return evaluate(method, points[i], segmentOf(points, count, method, i), t);
+}
+
+double YieldCurve::evaluate(InterpolationMethod method, const RatePoint& p, const Segment& segment, double t) {
+    double x = t - p.maturity;
+    switch (method) {
+    case InterpolationMethod::MonotoneCubic:
+        return p.rate + x * (segment.c1 + x * (segment.c2 + x * segment.c3));
+    case InterpolationMethod::LogDiscount:
+        return (p.rate * p.maturity + segment.c1 * x) / t;
+    default:
+        return p.rate + segment.c1 * x;
+    }
+}
+
+size_t YieldCurve::findInterval(const RatePoint* points, size_t count, bool uniform, double invStep, double t) {
+    const size_t last = count - 2;
+    if (uniform) {
+        // Index arithmetic, corrected by one interval if rounding puts t on the wrong side of a node.
+        size_t i = std::min(static_cast<size_t>((t - points[0].maturity) * invStep), last);
+        if (t < points[i].maturity && i > 0) {
+            --i;
+        }
+        else if (t >= points[i + 1].maturity && i < last) {
+            ++i;
+        }
+        return i;
+    }
+    const RatePoint* it = std::upper_bound(points, points + count, t,
+        [](double m, const RatePoint& p) { return m < p.maturity; });
+    return static_cast<size_t>(it - points) - 1;
 }
 
 double YieldCurve::getRate(double t) const {
-    if (data_.empty()) {
+    if (empty()) {
         throw std::runtime_error("YieldCurve is empty");
     }
+    const std::vector<RatePoint>& points = data_->points;
 
     // If t is less than or equal to the first point, return its rate.
-    if (t <= data_.front().maturity) {
-        return data_.front().rate;
+    if (t <= points.front().maturity) {
+        return points.front().rate;
     }
     // If t is greater than or equal to the last point, return its rate.
-    if (t >= data_.back().maturity) {
-        return data_.back().rate;
+    if (t >= points.back().maturity) {
+        return points.back().rate;
+    }
+
+    // Interpolation in the interval containing t.
+    size_t i = findInterval(points.data(), points.size(), data_->uniform, data_->invStep, t);
+    return evaluate(data_->method, points[i], data_->segments[i], t);
+}
+
+void YieldCurve::getRates(const double* t, double* out, size_t n) const {
+    if (empty()) {
+        throw std::runtime_error("YieldCurve is empty");
+    }
+    const std::vector<RatePoint>& points = data_->points;
+
+    const double first = points.front().maturity;
+    const double last = points.back().maturity;
+    size_t i = 0; // Interval of the previous query
+    for (size_t k = 0; k < n; ++k) {
+        double tk = t[k];
+        if (tk <= first) {
+            out[k] = points.front().rate;
+            continue;
+        }
+        if (tk >= last) {
+            out[k] = points.back().rate;
+            continue;
+        }
+        if (tk < points[i].maturity || tk >= points[i + 1].maturity) {
+            i = findInterval(points.data(), points.size(), data_->uniform, data_->invStep, tk);
+        }
+        out[k] = evaluate(data_->method, points[i], data_->segments[i], tk);
     }
+}
 
-    // Traverse the vector to find the interval containing t.
-    for (size_t i = 1; i < data_.size(); ++i) {
-        if (t < data_[i].maturity) {
-            const RatePoint& p0 = data_[i - 1];
-            const RatePoint& p1 = data_[i];
-            // Linear interpolation factor.
-            double factor = (t - p0.maturity) / (p1.maturity - p0.maturity);
-            return p0.rate + factor * (p1.rate - p0.rate);
+void YieldCurve::addPointSensitivities(const double* t, const double* sensitivities, size_t n,
+    double* pointSensitivities) const {
+    if (empty()) {
+        throw std::runtime_error("YieldCurve is empty");
+    }
+    const std::vector<RatePoint>& points = data_->points;
+
+    const double first = points.front().maturity;
+    const double last = points.back().maturity;
+    size_t i = 0; // Interval of the previous query
+    for (size_t k = 0; k < n; ++k) {
+        double tk = t[k];
+        if (tk <= first) {
+            pointSensitivities[0] += sensitivities[k];
+            continue;
+        }
+        if (tk >= last) {
+            pointSensitivities[points.size() - 1] += sensitivities[k];
+            continue;
+        }
+        if (tk < points[i].maturity || tk >= points[i + 1].maturity) {
+            i = findInterval(points.data(), points.size(), data_->uniform, data_->invStep, tk);
+        }
+        const RatePoint& p0 = points[i];
+        const RatePoint& p1 = points[i + 1];
+        double width = p1.maturity - p0.maturity;
+        double weight = (tk - p0.maturity) / width;
+        switch (data_->method) {
+        case InterpolationMethod::Linear:
+            pointSensitivities[i] += (1.0 - weight) * sensitivities[k];
+            pointSensitivities[i + 1] += weight * sensitivities[k];
+            break;
+        case InterpolationMethod::LogDiscount:
+            // rate = ((1 - w) r_i t_i + w r_i+1 t_i+1) / t
+            pointSensitivities[i] += (1.0 - weight) * p0.maturity / tk * sensitivities[k];
+            pointSensitivities[i + 1] += weight * p1.maturity / tk * sensitivities[k];
+            break;
+        case InterpolationMethod::MonotoneCubic: {
+            // Hermite form: rate = h00 r_i + h01 r_i+1 + width (h10 d_i + h11 d_i+1), where the node
+            // derivatives d depend on the neighbouring rates (the filter's choices held fixed).
+            double s = weight;
+            double s2 = s * s;
+            double s3 = s2 * s;
+            double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+            double h01 = 3.0 * s2 - 2.0 * s3;
+            double h10 = s3 - 2.0 * s2 + s;
+            double h11 = s3 - s2;
+            pointSensitivities[i] += h00 * sensitivities[k];
+            pointSensitivities[i + 1] += h01 * sensitivities[k];
+            size_t first0, first1;
+            double gradient0[3], gradient1[3];
+            hymanSlope(points.data(), points.size(), i, first0, gradient0);
+            hymanSlope(points.data(), points.size(), i + 1, first1, gradient1);
+            for (size_t j = 0; j < 3 && first0 + j < points.size(); ++j) {
+                pointSensitivities[first0 + j] += width * h10 * gradient0[j] * sensitivities[k];
+            }
+            for (size_t j = 0; j < 3 && first1 + j < points.size(); ++j) {
+                pointSensitivities[first1 + j] += width * h11 * gradient1[j] * sensitivities[k];
+            }
+            break;
+        }
         }
     }
+}
 
-    // Default return (should not be reached).
-    return data_.back().rate;
+bool YieldCurve::empty() const {
+    return !data_ || data_->points.empty();
 }
 
 const std::vector<RatePoint>& YieldCurve::getData() const {
-    return data_;
+    static const std::vector<RatePoint> noPoints;
+    return data_ ? data_->points : noPoints;
 }
 
 void YieldCurve::loadFromFile(const std::string& filename) {
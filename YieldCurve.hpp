@@ -9,6 +9,19 @@
 #include "pch.h"
 #include <vector>
 #include <string>
+#include <memory>
+
+/**
+ * @brief Interpolation of the rates between the points of a yield curve.
+ *
+ * Outside the points the curve is flat with every method. The values are stored in market-data
+ * snapshot files and must not change.
+ */
+enum class InterpolationMethod {
+    Linear = 0,        ///< Linear in the rates (default).
+    MonotoneCubic = 1, ///< Cubic Hermite spline on the rates, with Hyman's filter keeping it monotone between the points.
+    LogDiscount = 2    ///< Linear in log(exp(-rate * maturity)): the rates are read as zero rates with piecewise-constant forwards.
+};
 
  /**
   * @brief Structure representing a point on the yield curve.
@@ -25,16 +38,41 @@ struct RatePoint {
  * for interpolating the interest rate for a given time. It also allows loading
  * the data from a text file. Each line in the file should contain two numbers:
  * the maturity (between 0 and 1) and the corresponding interest rate.
+ *
+ * The interpolation coefficients of each interval are computed when the points are added
+ * (only the intervals affected by a new point are updated), so evaluating a rate costs O(1)
+ * once its interval is known. The interval containing a maturity is found by index arithmetic
+ * when the maturities are uniformly spaced (as in YieldCurveData.txt) and by binary search
+ * otherwise.
+ *
+ * A YieldCurve is a handle to immutable, reference-counted curve data: copies share the
+ * points, so copying a curve (for instance with a PricingConfiguration) is cheap. Adding a
+ * point to a curve whose data is shared first gives it its own copy (copy-on-write).
  */
 class YieldCurve {
 public:
     /**
      * @brief Adds a rate point to the curve.
+     *
+     * Points are normally added in increasing order of maturity; a point added out of
+     * order is inserted at its place.
+     *
      * @param maturity The maturity fraction (between 0 and 1).
      * @param rate The interest rate associated with this maturity.
      */
     void addRatePoint(double maturity, double rate);
 
+    /**
+     * @brief Selects the interpolation method and recomputes the interpolation coefficients.
+     * @param method The interpolation method (linear by default).
+     */
+    void setInterpolation(InterpolationMethod method);
+
+    /**
+     * @brief Returns the interpolation method.
+     */
+    InterpolationMethod getInterpolation() const;
+
     /**
      * @brief Returns the interpolated interest rate for a given maturity.
      * @param t The desired maturity (between 0 and 1).
@@ -43,6 +81,42 @@ public:
      */
     double getRate(double t) const;
 
+    /**
+     * @brief Returns the interpolated interest rates for a batch of maturities.
+     *
+     * Equivalent to calling getRate for each maturity; consecutive queries that fall in the
+     * same interval (such as increasing time steps) skip the interval search.
+     *
+     * @param t The desired maturities.
+     * @param out Receives the n interpolated rates.
+     * @param n The number of maturities.
+     * @throw std::runtime_error if the curve is empty.
+     */
+    void getRates(const double* t, double* out, size_t n) const;
+
+    /**
+     * @brief Maps sensitivities to interpolated rates onto sensitivities to the curve points.
+     *
+     * The sensitivity to the rate read at t[k] is shared between the points it depends on with
+     * the derivatives of the interpolation: two points for linear and log-discount interpolation,
+     * up to five for the monotone cubic (whose slopes depend on the neighbouring points), one
+     * outside the curve. This turns the per-step rate sensitivities of a pricer into key-rate
+     * (bucketed) sensitivities.
+     *
+     * @param t The maturities at which the rates were read.
+     * @param sensitivities The sensitivities to the n rates.
+     * @param n The number of maturities.
+     * @param pointSensitivities Incremented by the sensitivity to each point (getData().size() entries).
+     * @throw std::runtime_error if the curve is empty.
+     */
+    void addPointSensitivities(const double* t, const double* sensitivities, size_t n, double* pointSensitivities) const;
+
+    /**
+     * @brief Tells whether the curve has no point.
+     * @return True if the curve is empty.
+     */
+    bool empty() const;
+
     /**
      * @brief Provides access to the underlying data.
      * @return A constant reference to the vector of rate points.
@@ -60,8 +134,93 @@ public:
      */
     void loadFromFile(const std::string& filename);
 
+    /**
+     * @brief Returns the index i of the interval [t_i, t_i+1) containing t in a sorted array of
+     *        points, for t strictly between the first and last maturities.
+     *
+     * This is the lookup used by getRate; it is shared with the views over mapped snapshots.
+     *
+     * @param points The points, sorted by increasing maturity (at least two).
+     * @param count The number of points.
+     * @param uniform True if the maturities are uniformly spaced.
+     * @param invStep The inverse of the maturity step when uniform is true.
+     * @param t The maturity.
+     * @return The index of the interval.
+     */
+    static size_t findInterval(const RatePoint* points, size_t count, bool uniform, double invStep, double t);
+
+    /**
+     * @brief Interpolates the rate at t in the interval [t_i, t_i+1) of a sorted array of points.
+     *
+     * This computes the interpolation coefficients of the interval from the points, then evaluates
+     * them exactly as getRate does, so that the views over mapped snapshots return the same rates
+     * as a YieldCurve holding the same points.
+     *
+     * @param points The points, sorted by increasing maturity (at least two).
+     * @param count The number of points.
+     * @param method The interpolation method.
+     * @param i The index of the interval (see findInterval()).
+     * @param t The maturity, strictly between the first and last maturities.
+     * @return The interpolated interest rate.
+     */
+    static double interpolate(const RatePoint* points, size_t count, InterpolationMethod method, size_t i, double t);
+
 private:
-    std::vector<RatePoint> data_; /**< Storage for the rate points. */
+    /**
+     * @brief Interpolation coefficients of the interval [t_i, t_i+1]. With x = t - t_i,
+     *        rate = r_i + x (c1 + x (c2 + x c3)) for the linear and cubic methods, and
+     *        rate = (r_i t_i + c1 x) / t for the log-discount method (c1 is the forward rate).
+     */
+    struct Segment {
+        double c1;
+        double c2;
+        double c3;
+    };
+
+    /**
+     * @brief Points and interpolation data, shared between the copies of a curve.
+     */
+    struct CurveData {
+        std::vector<RatePoint> points; /**< Storage for the rate points. */
+        std::vector<Segment> segments; /**< Interpolation coefficients of each interval. */
+        InterpolationMethod method = InterpolationMethod::Linear; /**< Interpolation method. */
+        bool uniform = true;           /**< True if the maturities are uniformly spaced. */
+        double step = 0.0;             /**< Maturity step of a uniform curve. */
+        double invStep = 0.0;          /**< Inverse of the maturity step. */
+    };
+
+    /**
+     * @brief Returns the curve data, copied first if it is shared with another curve.
+     */
+    CurveData& mutableData();
+
+    /**
+     * @brief Appends a point after the last one and updates the interpolation data.
+     */
+    static void appendPoint(CurveData& data, double maturity, double rate);
+
+    /**
+     * @brief Recomputes the interpolation coefficients of the intervals from index first on.
+     */
+    static void updateSegments(CurveData& data, size_t first);
+
+    /**
+     * @brief Computes the interpolation coefficients of interval i.
+     */
+    static Segment segmentOf(const RatePoint* points, size_t count, InterpolationMethod method, size_t i);
+
+    /**
+     * @brief Evaluates the interpolation of an interval starting at point p (t strictly inside the curve).
+     */
+    static double evaluate(InterpolationMethod method, const RatePoint& p, const Segment& segment, double t);
+
+
+    /**
+     * @brief Recomputes the coefficients and the uniform-grid parameters from all the points.
+     */
+    static void rebuildIndex(CurveData& data);
+
+    std::shared_ptr<CurveData> data_; /**< Shared curve data (null for an empty curve). */
 };
 
 #endif // YIELDCURVE_HPP
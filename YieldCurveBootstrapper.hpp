@@ -0,0 +1,144 @@
+#ifndef YIELDCURVEBOOTSTRAPPER_HPP
+#define YIELDCURVEBOOTSTRAPPER_HPP
+
+/**
+ * @file YieldCurveBootstrapper.hpp
+ * @brief Declaration of the YieldCurveBootstrapper class.
+ *
+ * The bootstrapper builds a zero-rate YieldCurve from market quotes of deposits, FRAs, futures
+ * and par swaps. Each instrument defines one pillar (its maturity) whose continuously compounded
+ * zero rate is solved with Newton's method, the curve being linear in zero rates between pillars
+ * and flat outside them, as YieldCurve interpolates. When quotes change, only the pillars from
+ * the first changed instrument onwards are solved again.
+ *
+ * The bootstrapped curve is in years and holds zero rates, whereas the pricers read their
+ * PricingConfiguration curve at the fraction t/T of the option's life and use the rate read as
+ * the local rate of the step. curveForMaturity() converts the one into the other.
+ */
+
+#include "pch.h"
+#include "YieldCurve.hpp"
+#include <vector>
+
+/**
+ * @brief Type of a curve instrument.
+ */
+enum class CurveInstrumentType {
+    Deposit, ///< Simple rate from today to the maturity.
+    Fra,     ///< Simple forward rate between the start and the maturity.
+    Future,  ///< Rate future quoted as a price (100 - rate in percent), without convexity adjustment.
+    Swap     ///< Par swap rate, fixed leg against a floating leg valued at par.
+};
+
+/**
+ * @brief Market instrument used to build the curve. Times are in years from today.
+ */
+struct CurveInstrument {
+    CurveInstrumentType type; ///< Type of the instrument.
+    double start;             ///< Start of the accrual period (FRA and future; ignored otherwise).
+    double maturity;          ///< Maturity, which is the pillar of the instrument.
+    double quote;             ///< Rate (decimal) or, for futures, price.
+    int fixedFrequency;       ///< Fixed-leg payments per year (swaps only).
+};
+
+/**
+ * @brief Incremental yield curve bootstrapper.
+ */
+class YieldCurveBootstrapper {
+public:
+    /**
+     * @brief Constructs the bootstrapper and builds the curve.
+     * @param instruments The instruments, in any order; their maturities must be distinct.
+     * @throw std::invalid_argument if an instrument is inconsistent or two maturities coincide.
+     * @throw std::runtime_error if a pillar cannot be solved.
+     */
+    explicit YieldCurveBootstrapper(const std::vector<CurveInstrument>& instruments);
+
+    /**
+     * @brief Changes the quote of an instrument. The curve is rebuilt by the next call to curve().
+     * @param index The index of the instrument in the vector given to the constructor.
+     * @param quote The new quote.
+     * @throw std::out_of_range if the index is invalid.
+     */
+    void setQuote(size_t index, double quote);
+
+    /**
+     * @brief Returns the bootstrapped curve (maturities in years, continuously compounded zero rates),
+     *        solving again the pillars affected by the quote changes.
+     *
+     * This curve is not in the convention of the pricers; see curveForMaturity().
+     *
+     * @return The curve.
+     * @throw std::runtime_error if a pillar cannot be solved.
+     */
+    const YieldCurve& curve();
+
+    /**
+     * @brief Returns the curve to set in a PricingConfiguration to price an option of a given maturity.
+     *
+     * The points are uniformly spaced in the fraction of the option's life, from 0 to 1, and hold the
+     * instantaneous forward rates of the bootstrapped curve averaged over the interval around each point,
+     * so that the discount factors the pricers build from them match those of the bootstrapped curve.
+     *
+     * @param maturity The maturity of the option in years (after the calculation date).
+     * @param intervals The number of intervals of the grid.
+     * @return The curve.
+     * @throw std::invalid_argument if the maturity is not positive or intervals is zero.
+     * @throw std::runtime_error if a pillar cannot be solved.
+     */
+    YieldCurve curveForMaturity(double maturity, size_t intervals = 200);
+
+    /**
+     * @brief Returns the number of pillars.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the discount factor at a pillar (after the last rebuild).
+     * @param pillar The pillar index, in increasing order of maturity.
+     */
+    double discountFactor(size_t pillar) const;
+
+    /**
+     * @brief Returns the number of pillars solved by the last rebuild.
+     */
+    size_t lastSolvedPillars() const;
+
+private:
+    /**
+     * @brief Instrument with its pillar and precomputed fixed-leg schedule.
+     */
+    struct Pillar {
+        CurveInstrument instrument;
+        std::vector<double> paymentTimes;   ///< Fixed-leg payment times (swaps).
+        std::vector<double> accruals;       ///< Fixed-leg accrual fractions (swaps).
+        size_t firstFixedPayment;           ///< First fixed-leg payment after the previous pillar.
+        double fixedAnnuity;                ///< Sum of accrual x discount of the payments before it.
+    };
+
+    /**
+     * @brief Zero rate at t using pillars 0..last, and the weight of pillar `last` in it.
+     */
+    double zeroRate(double t, size_t last, double& weight) const;
+
+    /**
+     * @brief Solves the zero rate of one pillar, the earlier ones being known.
+     */
+    void solvePillar(size_t i);
+
+    /**
+     * @brief Solves the pillars from the first changed one onwards and refreshes the curve.
+     */
+    void rebuild();
+
+    std::vector<Pillar> pillars_;       ///< Instruments sorted by maturity.
+    std::vector<size_t> pillarOf_;      ///< Pillar of each instrument, by constructor index.
+    std::vector<double> times_;         ///< Pillar maturities.
+    std::vector<double> zeros_;         ///< Pillar zero rates.
+    std::vector<double> discounts_;     ///< Pillar discount factors, updated in place.
+    size_t dirtyFrom_;                  ///< First pillar to solve again (size() if none).
+    size_t lastSolved_;                 ///< Number of pillars solved by the last rebuild.
+    YieldCurve curve_;                  ///< Curve of the last rebuild.
+};
+
+#endif // YIELDCURVEBOOTSTRAPPER_HPP
@@ -0,0 +1,155 @@
+/**
+ * @file YieldCurveCache.cpp
+ * @brief Implementation of the YieldCurveCache class.
+ *
+ * The watcher is a detached thread that polls the modification time and size of the watched files
+ * (GetFileAttributesEx, which does not open the file). Since the thread lives until the process
+ * exits, the DLL is pinned in memory when the thread starts so that it can never be unloaded
+ * under it, and the instance is intentionally never destroyed.
+ *
+ * A reload publishes the new snapshot in YieldCurveRegistry under the names of the file while holding
+ * the reload lock, so that the registry receives the versions of a file in the order they were loaded.
+ */
+
+#include "pch.h"
+#include "YieldCurveCache.hpp"
+#include "MarketDataSnapshot.hpp"
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+YieldCurveCache& YieldCurveCache::instance() {
+    static YieldCurveCache* cache = new YieldCurveCache();
+    return *cache;
+}
+
+YieldCurveCache::YieldCurveCache()
+    : table_(std::make_shared<const Table>()),
+    watching_(false),
+    pollMilliseconds_(1000)
+{
+}
+
+std::shared_ptr<const YieldCurve> YieldCurveCache::get(const std::string& path, const std::string& section) {
+    std::shared_ptr<Entry> entry = acquire(path, section);
+    return std::atomic_load(&entry->snapshot);
+}
+
+std::shared_ptr<const YieldCurve> YieldCurveCache::defaultCurve() {
+    // If the first load throws, the initialization is attempted again on the next call.
+    static const std::shared_ptr<Entry> entry = [] {
+        YieldCurveCache& cache = instance();
+        cache.publishAs(YIELD_CURVE_DEFAULT_PATH, defaultKey());
+        return cache.acquire(YIELD_CURVE_DEFAULT_PATH, std::string());
+    }();
+    return std::atomic_load(&entry->snapshot);
+}
+
+CurveKey YieldCurveCache::defaultKey() {
+    return CurveKey{ YIELD_CURVE_DEFAULT_CURRENCY, YIELD_CURVE_DEFAULT_INDEX, CurveRole::Discount };
+}
+
+unsigned long long YieldCurveCache::publishAs(const std::string& path, const CurveKey& key, const std::string& section) {
+    std::shared_ptr<Entry> entry = acquire(path, section);
+    std::lock_guard<std::mutex> lock(refreshMutex_);
+    if (std::find(entry->keys.begin(), entry->keys.end(), key) == entry->keys.end()) {
+        entry->keys.push_back(key);
+    }
+    return YieldCurveRegistry::instance().publish(key, *std::atomic_load(&entry->snapshot));
+}
+
+void YieldCurveCache::setPollInterval(std::chrono::milliseconds interval) {
+    pollMilliseconds_.store(std::max<long long>(1, interval.count()));
+}
+
+std::shared_ptr<YieldCurveCache::Entry> YieldCurveCache::acquire(const std::string& path, const std::string& section) {
+    {
+        std::shared_ptr<const Table> table = std::atomic_load(&table_);
+        auto it = table->find(std::tie(path, section));
+        if (it != table->end()) {
+            return it->second;
+        }
+    }
+
+    // The file is loaded before taking the lock, so that a slow first load does not block the other callers.
+    auto entry = std::make_shared<Entry>();
+    entry->path = path;
+    entry->section = section;
+    readStamp(path, entry->stamp);
+    entry->snapshot = load(path, section);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<const Table> current = std::atomic_load(&table_);
+    auto it = current->find(std::tie(path, section));
+    if (it != current->end()) {
+        return it->second;
+    }
+    auto table = std::make_shared<Table>(*current);
+    (*table)[std::make_pair(path, section)] = entry;
+    std::atomic_store(&table_, std::shared_ptr<const Table>(table));
+
+    if (!watching_) {
+        HMODULE module = nullptr;
+        GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+            reinterpret_cast<LPCSTR>(&YieldCurveCache::instance), &module);
+        std::thread(&YieldCurveCache::watch, this).detach();
+        watching_ = true;
+    }
+    return entry;
+}
+
+bool YieldCurveCache::refresh() {
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+
+    std::lock_guard<std::mutex> lock(refreshMutex_);
+    bool published = false;
+    for (const auto& item : *table) {
+        const std::shared_ptr<Entry>& entry = item.second;
+        FileStamp stamp;
+        if (!readStamp(entry->path, stamp) || stamp == entry->stamp) {
+            continue;
+        }
+        try {
+            std::shared_ptr<const YieldCurve> snapshot = load(entry->path, entry->section);
+            std::atomic_store(&entry->snapshot, snapshot);
+            entry->stamp = stamp;
+            published = true;
+            for (const CurveKey& key : entry->keys) {
+                YieldCurveRegistry::instance().publish(key, *snapshot);
+            }
+        }
+        catch (const std::exception&) {
+            // Keep the previous snapshot; the file is read again at the next check.
+        }
+    }
+    return published;
+}
+
+void YieldCurveCache::watch() {
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollMilliseconds_.load()));
+        refresh();
+    }
+}
+
+bool YieldCurveCache::readStamp(const std::string& path, FileStamp& stamp) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    stamp.lastWrite = (static_cast<unsigned long long>(data.ftLastWriteTime.dwHighDateTime) << 32)
+        | data.ftLastWriteTime.dwLowDateTime;
+    stamp.size = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    return true;
+}
+
+std::shared_ptr<const YieldCurve> YieldCurveCache::load(const std::string& path, const std::string& section) {
+    if (!section.empty()) {
+        // The mapping is released as soon as the curve is copied, so the file can be replaced.
+        return std::make_shared<YieldCurve>(MarketDataSnapshot::open(path)->curve(section).toYieldCurve());
+    }
+    auto curve = std::make_shared<YieldCurve>();
+    curve->loadFromFile(path);
+    return curve;
+}
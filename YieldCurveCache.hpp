@@ -0,0 +1,195 @@
+#ifndef YIELDCURVECACHE_HPP
+#define YIELDCURVECACHE_HPP
+
+/**
+ * @file YieldCurveCache.hpp
+ * @brief Declaration of the YieldCurveCache class, the process-wide cache of yield curve files.
+ *
+ * Each curve file is loaded once and published as an immutable snapshot. A background thread
+ * checks the modification time of the files and publishes a new snapshot when a file changes,
+ * so that the pricing calls never access the filesystem: they only take a reference to the
+ * current snapshot. A file can also be published in YieldCurveRegistry under a curve name, in
+ * which case every reload publishes a new version of that curve.
+ *
+ * The files are either text curve files (see YieldCurve::loadFromFile) or curve sections of
+ * market-data snapshot files (see MarketDataSnapshot), which keep their interpolation method.
+ */
+
+#include "pch.h"
+#include "YieldCurve.hpp"
+#include "YieldCurveRegistry.hpp"
+#include <string>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <tuple>
+
+/**
+ * @brief Path of the yield curve file used by the DLL entry points.
+ *
+ * It can be overridden at build time by defining YIELD_CURVE_DEFAULT_PATH.
+ */
+#ifndef YIELD_CURVE_DEFAULT_PATH
+#define YIELD_CURVE_DEFAULT_PATH "C:\\Users\\shaki\\OneDrive\\Bureau\\YieldCurveData.txt"
+#endif
+
+/**
+ * @brief Currency and index under which the default curve file is published in YieldCurveRegistry.
+ *
+ * They can be overridden at build time by defining YIELD_CURVE_DEFAULT_CURRENCY and YIELD_CURVE_DEFAULT_INDEX.
+ */
+#ifndef YIELD_CURVE_DEFAULT_CURRENCY
+#define YIELD_CURVE_DEFAULT_CURRENCY "EUR"
+#endif
+#ifndef YIELD_CURVE_DEFAULT_INDEX
+#define YIELD_CURVE_DEFAULT_INDEX "DEFAULT"
+#endif
+
+/**
+ * @brief Process-wide cache of yield curves loaded from files, reloaded when the files change.
+ *
+ * Snapshots are published with atomic shared_ptr stores: a reader keeps the snapshot it
+ * obtained for as long as it needs it, even if a newer one is published meanwhile. The table
+ * of the watched files is published the same way, so that the lookups take no lock; a file
+ * requested for the first time is loaded outside of any lock, and only its insertion in the
+ * table is serialized. If a
+ * reload fails (for instance while the file is being written), the previous snapshot stays
+ * in place and the reload is retried at the next check.
+ */
+class YieldCurveCache {
+public:
+    /**
+     * @brief Returns the process-wide instance.
+     */
+    static YieldCurveCache& instance();
+
+    /**
+     * @brief Returns the current snapshot of the curve stored in a file.
+     *
+     * The first request for a file loads it and starts watching it; later requests
+     * do not access the filesystem.
+     *
+     * @param path The path of the curve file.
+     * @param section The name of a curve section of a market-data snapshot file, or empty for a text curve file.
+     * @return The current snapshot.
+     * @throw std::runtime_error if the file cannot be loaded on the first request.
+     */
+    std::shared_ptr<const YieldCurve> get(const std::string& path, const std::string& section = std::string());
+
+    /**
+     * @brief Returns the current snapshot of the curve stored at YIELD_CURVE_DEFAULT_PATH.
+     *
+     * Unlike get(), this does not look the file up by name after the first call.
+     *
+     * @return The current snapshot.
+     * @throw std::runtime_error if the file cannot be loaded on the first request.
+     */
+    static std::shared_ptr<const YieldCurve> defaultCurve();
+
+    /**
+     * @brief Returns the name of the default curve in YieldCurveRegistry (a discount curve).
+     */
+    static CurveKey defaultKey();
+
+    /**
+     * @brief Publishes the curve stored in a file in YieldCurveRegistry, now and after every reload.
+     *
+     * The default curve file is published under defaultKey() by the first call to defaultCurve().
+     *
+     * @param path The path of the curve file.
+     * @param key The name of the curve in the registry.
+     * @param section The name of a curve section of a market-data snapshot file, or empty for a text curve file.
+     * @return The version of the curve published by this call.
+     * @throw std::runtime_error if the file cannot be loaded on the first request.
+     */
+    unsigned long long publishAs(const std::string& path, const CurveKey& key, const std::string& section = std::string());
+
+    /**
+     * @brief Checks the watched files immediately and reloads those that changed.
+     * @return True if at least one new snapshot was published.
+     */
+    bool refresh();
+
+    /**
+     * @brief Sets the interval between two checks of the watched files.
+     * @param interval The new interval.
+     */
+    void setPollInterval(std::chrono::milliseconds interval);
+
+private:
+    /**
+     * @brief Modification time and size of a file, used to detect changes.
+     */
+    struct FileStamp {
+        unsigned long long lastWrite = 0;
+        unsigned long long size = 0;
+
+        bool operator==(const FileStamp& other) const {
+            return lastWrite == other.lastWrite && size == other.size;
+        }
+    };
+
+    /**
+     * @brief A watched file and its current snapshot.
+     */
+    struct Entry {
+        std::string path;
+        std::string section;                        ///< Section of a market-data snapshot file, or empty.
+        std::shared_ptr<const YieldCurve> snapshot; ///< Accessed only with std::atomic_load/std::atomic_store.
+        FileStamp stamp;                            ///< Stamp of the file the snapshot was loaded from.
+        std::vector<CurveKey> keys;                 ///< Names of the curve in the registry (protected by refreshMutex_).
+    };
+
+    YieldCurveCache();
+
+    /**
+     * @brief Orders the entries by path, then by section.
+     *
+     * It also compares a key with std::tie(path, section), so that a lookup builds no key.
+     */
+    struct EntryKeyLess {
+        typedef void is_transparent;
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            return std::tie(std::get<0>(a), std::get<1>(a)) < std::tie(std::get<0>(b), std::get<1>(b));
+        }
+    };
+
+    typedef std::map<std::pair<std::string, std::string>, std::shared_ptr<Entry>, EntryKeyLess> Table;
+
+    /**
+     * @brief Returns the entry of a file, loading it and starting the watcher if needed.
+     *
+     * Two threads requesting a new file at the same time may both load it; the entry inserted
+     * first is kept and returned to both.
+     */
+    std::shared_ptr<Entry> acquire(const std::string& path, const std::string& section);
+
+    /**
+     * @brief Body of the watcher thread.
+     */
+    void watch();
+
+    /**
+     * @brief Reads the stamp of a file.
+     * @return False if the file cannot be accessed.
+     */
+    static bool readStamp(const std::string& path, FileStamp& stamp);
+
+    /**
+     * @brief Loads a curve file, or a curve section of a market-data snapshot file, into a new snapshot.
+     */
+    static std::shared_ptr<const YieldCurve> load(const std::string& path, const std::string& section);
+
+    std::mutex mutex_;                                      ///< Serializes the insertions in table_; protects watching_.
+    std::mutex refreshMutex_;                               ///< Serializes the reloads and the publications.
+    std::shared_ptr<const Table> table_;                    ///< Watched files, by path and section (std::atomic_load/std::atomic_store only).
+    bool watching_;                                         ///< True once the watcher thread is started.
+    std::atomic<long long> pollMilliseconds_;               ///< Interval between two checks.
+};
+
+#endif // YIELDCURVECACHE_HPP
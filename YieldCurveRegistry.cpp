@@ -0,0 +1,84 @@
+/**
+ * @file YieldCurveRegistry.cpp
+ * @brief Implementation of the YieldCurveRegistry class.
+ *
+ * Publishing copies the table of snapshots (one shared pointer per curve, never the curve points),
+ * so its cost grows with the number of curves, which is small, and not with the size of the curves.
+ * Version numbers are per curve and survive a removal, so that a curve published again after
+ * being removed never reuses a version number.
+ */
+
+#include "pch.h"
+#include "YieldCurveRegistry.hpp"
+#include <stdexcept>
+
+namespace {
+
+    std::string describe(const CurveKey& key) {
+        return key.currency + "/" + key.index + (key.role == CurveRole::Discount ? "/discount" : "/forecast");
+    }
+
+} // namespace
+
+YieldCurveRegistry& YieldCurveRegistry::instance() {
+    static YieldCurveRegistry registry;
+    return registry;
+}
+
+YieldCurveRegistry::YieldCurveRegistry()
+    : table_(std::make_shared<const Table>())
+{
+}
+
+unsigned long long YieldCurveRegistry::publish(const CurveKey& key, const YieldCurve& curve) {
+    if (curve.empty()) {
+        throw std::invalid_argument("Cannot publish an empty curve: " + describe(key));
+    }
+
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    auto snapshot = std::make_shared<CurveSnapshot>();
+    snapshot->key = key;
+    snapshot->version = ++versions_[key];
+    snapshot->curve = curve;
+
+    auto table = std::make_shared<Table>(*std::atomic_load(&table_));
+    (*table)[key] = snapshot;
+    std::atomic_store(&table_, std::shared_ptr<const Table>(table));
+    return snapshot->version;
+}
+
+std::shared_ptr<const CurveSnapshot> YieldCurveRegistry::find(const CurveKey& key) const {
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+    auto it = table->find(key);
+    return (it != table->end()) ? it->second : std::shared_ptr<const CurveSnapshot>();
+}
+
+YieldCurve YieldCurveRegistry::get(const CurveKey& key) const {
+    std::shared_ptr<const CurveSnapshot> snapshot = find(key);
+    if (!snapshot) {
+        throw std::runtime_error("No curve published under " + describe(key));
+    }
+    return snapshot->curve;
+}
+
+bool YieldCurveRegistry::remove(const CurveKey& key) {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    std::shared_ptr<const Table> current = std::atomic_load(&table_);
+    if (current->find(key) == current->end()) {
+        return false;
+    }
+    auto table = std::make_shared<Table>(*current);
+    table->erase(key);
+    std::atomic_store(&table_, std::shared_ptr<const Table>(table));
+    return true;
+}
+
+std::vector<CurveKey> YieldCurveRegistry::keys() const {
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+    std::vector<CurveKey> result;
+    result.reserve(table->size());
+    for (const auto& item : *table) {
+        result.push_back(item.first);
+    }
+    return result;
+}
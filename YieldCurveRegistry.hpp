@@ -0,0 +1,123 @@
+#ifndef YIELDCURVEREGISTRY_HPP
+#define YIELDCURVEREGISTRY_HPP
+
+/**
+ * @file YieldCurveRegistry.hpp
+ * @brief Declaration of the YieldCurveRegistry class, the process-wide registry of named curves.
+ *
+ * Curves are identified by currency, index and role (discount or forecast curve). Each
+ * publication of a curve creates a new immutable, reference-counted snapshot with a version
+ * number one higher than the previous one. Readers obtain snapshots without taking any lock
+ * held by the publishers, and keep using the snapshot they obtained while newer ones are
+ * published.
+ */
+
+#include "pch.h"
+#include "YieldCurve.hpp"
+#include <string>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Use of a curve.
+ */
+enum class CurveRole {
+    Discount, ///< Curve used to discount cash flows.
+    Forecast  ///< Curve used to project the fixings of an index.
+};
+
+/**
+ * @brief Name of a curve in the registry.
+ */
+struct CurveKey {
+    std::string currency; ///< Currency code, for example "EUR".
+    std::string index;    ///< Index name, for example "ESTR" or "EURIBOR3M".
+    CurveRole role;       ///< Discount or forecast curve.
+
+    bool operator<(const CurveKey& other) const {
+        if (currency != other.currency) {
+            return currency < other.currency;
+        }
+        if (index != other.index) {
+            return index < other.index;
+        }
+        return role < other.role;
+    }
+
+    bool operator==(const CurveKey& other) const {
+        return currency == other.currency && index == other.index && role == other.role;
+    }
+};
+
+/**
+ * @brief Immutable published version of a curve.
+ */
+struct CurveSnapshot {
+    CurveKey key;                 ///< Name of the curve.
+    unsigned long long version;   ///< Publication number of the curve, starting at 1.
+    YieldCurve curve;             ///< The curve (a cheap, shared handle).
+};
+
+/**
+ * @brief Process-wide registry of named, versioned yield curves.
+ *
+ * The registry holds an immutable table of snapshots. Publishers build a new table and swap it in
+ * with an atomic store; they are serialized among themselves only. Readers take the current table
+ * with an atomic load.
+ */
+class YieldCurveRegistry {
+public:
+    /**
+     * @brief Returns the process-wide instance.
+     */
+    static YieldCurveRegistry& instance();
+
+    /**
+     * @brief Publishes a new version of a curve.
+     * @param key The name of the curve.
+     * @param curve The curve to publish.
+     * @return The version number of the published snapshot.
+     * @throw std::invalid_argument if the curve is empty.
+     */
+    unsigned long long publish(const CurveKey& key, const YieldCurve& curve);
+
+    /**
+     * @brief Returns the current snapshot of a curve.
+     * @param key The name of the curve.
+     * @return The snapshot, or a null pointer if no curve is published under this name.
+     */
+    std::shared_ptr<const CurveSnapshot> find(const CurveKey& key) const;
+
+    /**
+     * @brief Returns the current version of a curve.
+     * @param key The name of the curve.
+     * @return The curve.
+     * @throw std::runtime_error if no curve is published under this name.
+     */
+    YieldCurve get(const CurveKey& key) const;
+
+    /**
+     * @brief Removes a curve from the registry. Snapshots already obtained remain valid.
+     * @param key The name of the curve.
+     * @return True if the curve was present.
+     */
+    bool remove(const CurveKey& key);
+
+    /**
+     * @brief Returns the names of all the published curves.
+     */
+    std::vector<CurveKey> keys() const;
+
+private:
+    typedef std::map<CurveKey, std::shared_ptr<const CurveSnapshot>> Table;
+
+    YieldCurveRegistry();
+
+    std::shared_ptr<const Table> table_; ///< Current table, accessed only with std::atomic_load/std::atomic_store.
+    std::mutex publishMutex_;            ///< Serializes the publishers.
+    std::map<CurveKey, unsigned long long> versions_; ///< Last version published for each curve, including removed ones.
+};
+
+#endif // YIELDCURVEREGISTRY_HPP
@@ -1,6 +1,8 @@
 #pragma once
 
+#ifdef _WIN32
 #define NOMINMAX 
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 // Windows Header Files
 #include <windows.h>
+#endif